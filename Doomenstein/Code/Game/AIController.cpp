@@ -19,9 +19,41 @@ AIController::~AIController()
 {}
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Carries out the steering PlanSteering chose this frame: turn toward the target, then run forward or attack.
+// Finding a new target is left to Think, which the map's AIScheduler calls on a time slice.
 void AIController::Update()
 {
 
+	if(!m_map->m_game->m_aiEnabled || !m_hasSteeringPlan)
+	{
+		return;
+	}
+
+	m_hasSteeringPlan = false;
+
+	Actor* controlledActor = GetActor();
+
+	if(controlledActor && controlledActor->m_state != ActorState::DYING && controlledActor->m_state != ActorState::DEAD)
+	{
+		controlledActor->TurnInDirection(m_planYawDegrees, controlledActor->m_definition->m_turnSpeed * m_map->m_game->m_gameClock->GetDeltaSeconds());
+
+		if(m_planToAttack)
+		{
+			AttackActor(controlledActor);
+		}
+		else
+		{
+			controlledActor->MoveInDirection(controlledActor->GetForwardVector().GetXY().GetNormalized() * controlledActor->m_definition->m_runSpeed);
+		}
+	}	
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Runs in parallel with the other controllers' plans, so it only reads the map and writes this controller
+void AIController::PlanSteering()
+{
+	m_hasSteeringPlan = false;
+
 	if(!m_map->m_game->m_aiEnabled)
 	{
 		return;
@@ -32,45 +64,66 @@ void AIController::Update()
 
 	if(controlledActor && controlledActor->m_state != ActorState::DYING && controlledActor->m_state != ActorState::DEAD)
 	{
-		if(!targetActor)
+		if(targetActor)
 		{
-			targetActor = m_map->GetClosestVisibleActor(controlledActor);
-
-			if(targetActor)
-			{
-				m_targetActorHandle = targetActor->m_handle;
-			}
+			PlanSteeringTowardsActor(targetActor, controlledActor);
 		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void AIController::Think()
+{
+	if(!m_map->m_game->m_aiEnabled)
+	{
+		return;
+	}
+
+	Actor* controlledActor = GetActor();
+
+	if(!controlledActor || controlledActor->m_state == ActorState::DYING || controlledActor->m_state == ActorState::DEAD)
+	{
+		return;
+	}
+
+	if(!m_map->GetActorByHandle(m_targetActorHandle))
+	{
+		Actor* targetActor = m_map->GetClosestVisibleActor(controlledActor);
 
 		if(targetActor)
 		{
-			LookAndMoveTowardsActor(targetActor, controlledActor);
+			m_targetActorHandle = targetActor->m_handle;
 		}
-	}	
+	}
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void AIController::LookAndMoveTowardsActor(Actor* targetActor, Actor* controlledActor)
+void AIController::PlanSteeringTowardsActor(Actor* targetActor, Actor* controlledActor)
 {
-	Vec3 posToTargetPos = (targetActor->m_position - controlledActor->m_position);
+	// head for the next tile on the shared path to the target instead of straight at it, so demons route around walls
+	Vec3 moveTargetPos = targetActor->m_position;
+	FlowField const* flowField = m_map->GetFlowFieldToActor(targetActor);
 
-	float angle = posToTargetPos.GetAngleAboutZDegrees();
+	if(flowField && flowField->HasPathFromPosition(controlledActor->m_position.GetXY2D()))
+	{
+		Vec2 waypoint = flowField->GetWaypointForPosition(controlledActor->m_position.GetXY2D());
+
+		if(!(waypoint == controlledActor->m_position.GetXY2D()))
+		{
+			moveTargetPos = Vec3(waypoint.x, waypoint.y, controlledActor->m_position.z);
+		}
+	}
 
-	controlledActor->TurnInDirection(angle, controlledActor->m_definition->m_turnSpeed * m_map->m_game->m_gameClock->GetDeltaSeconds());
+	Vec3 posToTargetPos = (moveTargetPos - controlledActor->m_position);
 
 	float distanceBetweenActors = GetVectorDistance3D(targetActor->m_position, controlledActor->m_position);
 	float actorRadius = controlledActor->m_definition->m_physicsRadius;
 	float targetActorRadius = targetActor->m_definition->m_physicsRadius;
 	float tolerance = 0.4f;
 
-	if(distanceBetweenActors > targetActorRadius + actorRadius + tolerance)
-	{
-		controlledActor->MoveInDirection(controlledActor->GetForwardVector().GetXY().GetNormalized() * controlledActor->m_definition->m_runSpeed);
-	}
-	else
-	{
-		AttackActor(controlledActor);
-	}
+	m_planYawDegrees  = posToTargetPos.GetAngleAboutZDegrees();
+	m_planToAttack	  = distanceBetweenActors <= targetActorRadius + actorRadius + tolerance;
+	m_hasSteeringPlan = true;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -84,7 +137,7 @@ void AIController::DamagedBy(Actor* attackingActor)
 {	
 	if(attackingActor)
 	{
-		if(attackingActor->m_definition->m_name == "PlasmaProjectile" && attackingActor->m_owner)
+		if(attackingActor->m_definition->IsProjectile() && attackingActor->m_owner)
 		{
 			m_targetActorHandle = attackingActor->m_owner->m_handle;
 			return;
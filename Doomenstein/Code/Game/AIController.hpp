@@ -17,7 +17,9 @@ public:
 	~AIController();
 
 	virtual void Update() override;
-	void LookAndMoveTowardsActor(Actor* targetActor, Actor* controlledActor);
+	void Think();
+	void PlanSteering();
+	void PlanSteeringTowardsActor(Actor* targetActor, Actor* controlledActor);
 	void AttackActor(Actor* controlledActor);
 	void DamagedBy(Actor* attackActor);
 
@@ -25,4 +27,12 @@ public:
 
 	ActorHandle m_targetActorHandle;
 
+	// frame index of this controller's next think in the map's AIScheduler, -1 until the scheduler first sees it
+	int m_nextThinkFrame = -1;
+
+	// steering decided by PlanSteering during the map's parallel read phase, carried out by the next Update
+	bool  m_hasSteeringPlan		= false;
+	bool  m_planToAttack		= false;
+	float m_planYawDegrees		= 0.f;
+
 };
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "Game/AIScheduler.hpp"
+#include "Game/AIController.hpp"
+#include "Game/Actor.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/JobSystem.hpp"
+
+#include "Engine/Core/Time.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void AIScheduler::Initialize()
+{
+	m_thinkIntervalFrames	  = g_gameConfigBlackboard.GetValue("aiThinkIntervalFrames", m_thinkIntervalFrames);
+	m_thinkBudgetMicroseconds = static_cast<double>(g_gameConfigBlackboard.GetValue("aiThinkBudgetMicroseconds", static_cast<float>(m_thinkBudgetMicroseconds)));
+
+	if(m_thinkIntervalFrames < 1)
+	{
+		m_thinkIntervalFrames = 1;
+	}
+
+	m_frameIndex	= 0;
+	m_nextActorSlot = 0;
+
+	ResetStats();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Walks the actor list round robin from where the previous frame stopped, so controllers cut off by the budget are
+// first in line next frame
+void AIScheduler::Update(ActorList const& actors)
+{
+	m_lastFrameStats = AISchedulerStats();
+
+	double frameStartSeconds = GetCurrentTimeSeconds();
+	double budgetSeconds = m_thinkBudgetMicroseconds * 0.000001;
+	bool hasBudget = m_thinkBudgetMicroseconds > 0.0;
+
+	size_t numActors = actors.size();
+
+	if(m_nextActorSlot >= numActors)
+	{
+		m_nextActorSlot = 0;
+	}
+
+	m_dueControllers.clear();
+	m_dueSlots.clear();
+
+	for(size_t slotsVisited = 0; slotsVisited < numActors; ++slotsVisited)
+	{
+		size_t actorSlot = (m_nextActorSlot + slotsVisited) % numActors;
+		Actor* actor = actors[actorSlot];
+
+		if(!actor || !actor->m_aiController || actor->m_possessedController != actor->m_aiController || !actor->IsAlive())
+		{
+			continue;
+		}
+
+		AIController* aiController = actor->m_aiController;
+
+		if(aiController->m_nextThinkFrame < 0)
+		{
+			aiController->m_nextThinkFrame = m_frameIndex + static_cast<int>(actorSlot % static_cast<size_t>(m_thinkIntervalFrames));
+		}
+
+		if(aiController->m_nextThinkFrame > m_frameIndex)
+		{
+			continue;
+		}
+
+		m_dueControllers.push_back(aiController);
+		m_dueSlots.push_back(actorSlot);
+	}
+
+	int numDueThinks = static_cast<int>(m_dueControllers.size());
+	int batchSize = hasBudget ? g_jobSystem->GetNumThreads() : numDueThinks;
+	int numThinks = 0;
+
+	while(numThinks < numDueThinks)
+	{
+		if(hasBudget && numThinks > 0 && (GetCurrentTimeSeconds() - frameStartSeconds) >= budgetSeconds)
+		{
+			break;
+		}
+
+		int batchStart = numThinks;
+		int batchEnd = (batchStart + batchSize < numDueThinks) ? batchStart + batchSize : numDueThinks;
+
+		g_jobSystem->ParallelFor(batchEnd - batchStart, 1, [this, batchStart](int beginIndex, int endIndex)
+		{
+			for(int dueIndex = batchStart + beginIndex; dueIndex < batchStart + endIndex; ++dueIndex)
+			{
+				m_dueControllers[dueIndex]->Think();
+			}
+		});
+
+		for(int dueIndex = batchStart; dueIndex < batchEnd; ++dueIndex)
+		{
+			m_dueControllers[dueIndex]->m_nextThinkFrame = m_frameIndex + m_thinkIntervalFrames;
+		}
+
+		numThinks = batchEnd;
+	}
+
+	m_lastFrameStats.m_numThinks = numThinks;
+
+	// anything still due past the cut off waits for the next frame
+	m_lastFrameStats.m_numDeferredThinks = numDueThinks - numThinks;
+
+	if(numThinks < numDueThinks)
+	{
+		m_nextActorSlot = m_dueSlots[numThinks];
+	}
+
+	m_lastFrameStats.m_thinkMicroseconds = (GetCurrentTimeSeconds() - frameStartSeconds) * 1000000.0;
+
+	m_peakStats.m_numThinks			= (m_lastFrameStats.m_numThinks > m_peakStats.m_numThinks) ? m_lastFrameStats.m_numThinks : m_peakStats.m_numThinks;
+	m_peakStats.m_numDeferredThinks = (m_lastFrameStats.m_numDeferredThinks > m_peakStats.m_numDeferredThinks) ? m_lastFrameStats.m_numDeferredThinks : m_peakStats.m_numDeferredThinks;
+	m_peakStats.m_thinkMicroseconds = (m_lastFrameStats.m_thinkMicroseconds > m_peakStats.m_thinkMicroseconds) ? m_lastFrameStats.m_thinkMicroseconds : m_peakStats.m_thinkMicroseconds;
+
+	m_totalThinkMicroseconds += m_lastFrameStats.m_thinkMicroseconds;
+	m_numStatFrames += 1;
+
+	m_frameIndex += 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+AISchedulerStats AIScheduler::GetLastFrameStats() const
+{
+	return m_lastFrameStats;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+AISchedulerStats AIScheduler::GetPeakStats() const
+{
+	return m_peakStats;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+double AIScheduler::GetAverageThinkMicroseconds() const
+{
+	return (m_numStatFrames > 0) ? (m_totalThinkMicroseconds / static_cast<double>(m_numStatFrames)) : 0.0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void AIScheduler::ResetStats()
+{
+	m_lastFrameStats		 = AISchedulerStats();
+	m_peakStats				 = AISchedulerStats();
+	m_totalThinkMicroseconds = 0.0;
+	m_numStatFrames			 = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int AIScheduler::GetFrameIndex() const
+{
+	return m_frameIndex;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+size_t AIScheduler::GetNextActorSlot() const
+{
+	return m_nextActorSlot;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void AIScheduler::SetSchedule(int frameIndex, size_t nextActorSlot)
+{
+	m_frameIndex	= frameIndex;
+	m_nextActorSlot	= nextActorSlot;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class Actor;
+class AIController;
+
+typedef std::vector<Actor*> ActorList;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+struct AISchedulerStats
+{
+	int		m_numThinks			= 0;
+	int		m_numDeferredThinks	= 0;
+	double	m_thinkMicroseconds	= 0.0;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Time slices the expensive part of AI, target acquisition, across frames. Every AI controller thinks at most once
+// every m_thinkIntervalFrames frames, with first thinks staggered by actor slot so a wave of spawns does not land on
+// the same frame. Thinks stop for the frame once the microsecond budget is spent and pick up where they left off next
+// frame; a budget of 0 or less lets every due controller think. Steering toward an already known target still runs
+// every frame in AIController::Update.
+// Due thinks run on the job system in batches of one per thread with the budget checked between batches. A think
+// only writes its own controller, so which controllers think each frame, not which thread ran them, decides the result.
+class AIScheduler
+{
+public:
+
+	AIScheduler() = default;
+	~AIScheduler() = default;
+
+	void				Initialize();
+	void				Update(ActorList const& actors);
+
+	AISchedulerStats	GetLastFrameStats() const;
+	AISchedulerStats	GetPeakStats() const;
+	double				GetAverageThinkMicroseconds() const;
+	void				ResetStats();
+
+	// where the round robin stands, so a map snapshot can put it back exactly
+	int					GetFrameIndex() const;
+	size_t				GetNextActorSlot() const;
+	void				SetSchedule(int frameIndex, size_t nextActorSlot);
+
+public:
+
+	int					m_thinkIntervalFrames		= 6;
+	double				m_thinkBudgetMicroseconds	= 500.0;
+
+private:
+
+	int					m_frameIndex		= 0;
+	size_t				m_nextActorSlot		= 0;
+
+	std::vector<AIController*>	m_dueControllers;
+	std::vector<size_t>			m_dueSlots;
+
+	AISchedulerStats	m_lastFrameStats;
+	AISchedulerStats	m_peakStats;
+	double				m_totalThinkMicroseconds = 0.0;
+	int					m_numStatFrames			 = 0;
+};
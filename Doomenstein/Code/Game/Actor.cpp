@@ -13,52 +13,23 @@
 extern Game* g_game;
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-Actor::Actor(Map* map, std::string const& name, Vec3 const& position, EulerAngles const& orientation, ActorHandle const& actorHandle, Actor* owner)
-	: m_map(map)
+Actor::Actor(Map* map, ActorDefinition* definition, Vec3 const& position, EulerAngles const& orientation, ActorHandle const& actorHandle, Actor* owner)
+	: m_definition(definition)
+	, m_map(map)
 	, m_position(position)
 	, m_orientation(orientation)
 	, m_handle(actorHandle)
 	, m_owner(owner)
 {
-	for(size_t actorDefIndex = 0; actorDefIndex < ActorDefinition::s_actorDefinitions.size(); ++actorDefIndex)
-	{
-		if(ActorDefinition::s_actorDefinitions[actorDefIndex].m_name == name)
-		{
-			m_definition = &ActorDefinition::s_actorDefinitions[actorDefIndex];
-			m_corpseTimer = Timer(m_definition->m_corpseLifetime, m_map->m_game->m_gameClock);
+	m_previousPosition = m_position;
+	m_renderPosition   = m_position;
 
-			break;
-		}
-	}
-	
 	if(m_definition)
 	{
 		m_health = m_definition->m_health;
-		for(size_t weaponIndex = 0; weaponIndex < m_definition->m_weaponInventory.size(); ++weaponIndex)
-		{
-			std::string weaponName = m_definition->m_weaponInventory[weaponIndex];
-
-			for(size_t index = 0; index < WeaponDefinition::s_weaponDefinitions.size(); ++index)
-			{
-				if(WeaponDefinition::s_weaponDefinitions[index].m_name == weaponName)
-				{
-					m_weaponInventory.push_back(new Weapon(&WeaponDefinition::s_weaponDefinitions[index], this));
-				}
-			}
-		}
-
-		if(m_weaponInventory.size() > 0)
-		{
-			m_currentWeapon = m_weaponInventory[0];
-		}
-
-		if(m_definition->m_aiEnabled)
-		{
-			m_aiController = new AIController(m_map);
-			m_aiController->Possess(this);
-		}
+		CreateWeaponsAndAIController();
 
-		if(m_definition->m_name != "SpawnPoint")
+		if(!m_definition->IsSpawnPoint())
 		{
 			m_animationTimer = Timer(1.f, g_game->m_gameClock);
 			SetSpawnState();
@@ -79,11 +50,99 @@ Actor::Actor(Map* map, std::string const& name, Vec3 const& position, EulerAngle
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dormant actor for a map's actor pools: it gets its weapons, controller and timers but never enters its spawn state,
+// so no sound starts and no lifetime or corpse timer runs until Actor::Respawn brings it into the map.
+Actor::Actor(Map* map, ActorDefinition* definition)
+	: m_definition(definition)
+	, m_map(map)
+{
+	m_health = m_definition->m_health;
+	CreateWeaponsAndAIController();
+
+	m_animationTimer = Timer(1.f, g_game->m_gameClock);
+	m_corpseTimer	 = Timer(m_definition->m_corpseLifetime, m_map->m_game->m_gameClock);
+
+	if(m_definition->m_lifetime != -1.f)
+	{
+		m_lifetimeTimer = Timer(m_definition->m_lifetime, g_game->m_gameClock);
+	}
+
+	m_light = m_definition->m_light;
+	m_color = m_definition->m_tint;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 Actor::~Actor()
 {
 	delete m_aiController;
 	m_aiController = nullptr;
+
+	for(Weapon* weapon : m_weaponInventory)
+	{
+		delete weapon;
+	}
+
+	m_weaponInventory.clear();
+	m_currentWeapon = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Brings a pooled actor back to the state a freshly constructed one would be in, keeping its weapons, controller and
+// vertex storage so recycling it does not touch the heap.
+void Actor::Respawn(Vec3 const& position, EulerAngles const& orientation, ActorHandle const& actorHandle)
+{
+	m_handle		= actorHandle;
+	m_position		= position;
+	m_previousPosition = position;
+	m_renderPosition = position;
+	m_orientation	= orientation;
+	m_velocity		= Vec3::ZERO;
+	m_acceleration	= Vec3::ZERO;
+	m_isGrounded	= true;
+	m_owner			= nullptr;
+
+	m_health = m_definition->m_health;
+	m_light	 = m_definition->m_light;
+	m_color	 = m_definition->m_tint;
+
+	m_actorAnimation		= nullptr;
+	m_scaleAnimationBySpeed = false;
+	m_currentAudioID		= static_cast<SoundPlaybackID>(-1);
+
+	for(Weapon* weapon : m_weaponInventory)
+	{
+		weapon->m_state = IDLE;
+		weapon->m_refireTimer.Stop();
+	}
+
+	m_currentWeapon = m_weaponInventory.empty() ? nullptr : m_weaponInventory[0];
+
+	if(m_aiController)
+	{
+		m_aiController->m_targetActorHandle = ActorHandle::INVALID;
+		m_aiController->m_nextThinkFrame	= -1;
+		m_aiController->Possess(this);
+	}
+	else
+	{
+		m_possessedController = nullptr;
+	}
+
+	m_corpseTimer.Stop();
+	m_animationTimer.Stop();
+	m_state = ActorState::WALKING;
+
+	if(!m_definition->IsSpawnPoint())
+	{
+		SetSpawnState();
+	}
+
+	if(m_definition->m_lifetime != -1.f)
+	{
+		m_lifetimeTimer.Stop();
+		m_lifetimeTimer.Start();
+	}
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -139,75 +198,21 @@ void Actor::DeathStateUpdate()
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Actor::PhysicsUpdate()
+void Actor::UpdateRenderPosition(float tickFraction)
 {
-
-	if(m_state == ActorState::DYING || m_state == ActorState::DEAD)
-	{
-		return;
-	}
-
-	float gravity = g_gameConfigBlackboard.GetValue("gravity", 0.0f);
-
-	float drag;
-	
-	if(m_isGrounded)
-	{
-		drag = m_definition->m_drag;
-	}
-	else
-	{
-		drag = 0.f;
-	}
-
-	AddForce(-m_velocity * drag);
-
-	if(!m_isGrounded && m_definition->m_effectedByGravity)
-	{
-		AddForce(Vec3::DOWN * gravity);
-	}
-
-	m_position += m_velocity * g_game->m_gameClock->GetDeltaSeconds();
-	m_velocity += m_acceleration * g_game->m_gameClock->GetDeltaSeconds();
-	m_acceleration = Vec3::ZERO;
-
-	if(m_definition->m_isLightSource)
-	{
-		m_light.SetPosition(m_position);
-	}
-
+	m_renderPosition = m_previousPosition + (m_position - m_previousPosition) * tickFraction;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Actor::Render(Camera const& camera)
 {
-
-	bool isPossessedControllerCamera = false;
-
-	if(m_possessedController)
-	{
-		PlayerController* playerController = dynamic_cast<PlayerController*>(m_possessedController);
-
-		if(playerController)
-		{
-			isPossessedControllerCamera = &playerController->m_worldCamera == &camera;
-		}
-
-	}
-
-	if(m_definition && m_definition->m_name != "SpawnPoint" && !isPossessedControllerCamera)
+	if(ShouldRenderForCamera(camera))
 	{
 		SetAnimationIfViewChanged(camera);
 
 		FillActorVerts();
 
-		Mat44 targetTransform = camera.m_orientation.GetAsMatrix_IFwd_JLeft_KUp();
-		targetTransform.SetTranslation3D(camera.m_position);
-
-		Mat44 billboardTransform = GetBillboardTransform(m_definition->m_billboardType, targetTransform, m_position);
-		billboardTransform.SetTranslation3D(m_position);
-
-		g_theRenderer->SetModelConstants(billboardTransform, m_color);
+		g_theRenderer->SetModelConstants(GetBillboardMatrix(camera), m_color);
 		g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 		g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
 		g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
@@ -226,6 +231,26 @@ void Actor::Render(Camera const& camera)
 	}
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Spawn points are never drawn, and a player does not see their own actor through their own camera
+bool Actor::ShouldRenderForCamera(Camera const& camera) const
+{
+	bool isPossessedControllerCamera = false;
+
+	if(m_possessedController)
+	{
+		PlayerController* playerController = dynamic_cast<PlayerController*>(m_possessedController);
+
+		if(playerController)
+		{
+			isPossessedControllerCamera = &playerController->m_worldCamera == &camera;
+		}
+
+	}
+
+	return m_definition && !m_definition->IsSpawnPoint() && !isPossessedControllerCamera;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Actor::RenderDepth()
 {
@@ -250,11 +275,23 @@ Mat44 Actor::GetModelMatrix() const
 	EulerAngles yawOnly = EulerAngles(m_orientation.m_yawDegrees, 0.f, 0.f);
 
 	Mat44 modelMatrix = yawOnly.GetAsMatrix_IFwd_JLeft_KUp();
-	modelMatrix.SetTranslation3D(m_position);
+	modelMatrix.SetTranslation3D(m_renderPosition);
 
 	return modelMatrix;
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+Mat44 Actor::GetBillboardMatrix(Camera const& camera) const
+{
+	Mat44 targetTransform = camera.m_orientation.GetAsMatrix_IFwd_JLeft_KUp();
+	targetTransform.SetTranslation3D(camera.m_position);
+
+	Mat44 billboardTransform = GetBillboardTransform(m_definition->m_billboardType, targetTransform, m_renderPosition);
+	billboardTransform.SetTranslation3D(m_renderPosition);
+
+	return billboardTransform;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 Vec3 Actor::GetForwardVector()
 {	
@@ -520,6 +557,12 @@ void Actor::IncrementPlayerKillsOnAttackingPlayer(Actor* attackingActor)
 
 	Actor* actor = nullptr;
 
+	// damage applied from the command buffer can outlive the actor that dealt it
+	if(!attackingActor)
+	{
+		return;
+	}
+
 	if(attackingActor->m_owner)
 	{
 		actor = attackingActor->m_owner;
@@ -546,15 +589,20 @@ void Actor::IncrementPlayerKillsOnAttackingPlayer(Actor* attackingActor)
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Actor::SetAnimationIfViewChanged(Camera const& camera)
 {
-	AnimationGroup currentAnimation = GetAnimationGroupByState(m_state);
+	AnimationGroup const* currentAnimation = m_definition->GetAnimationGroupForState(m_state);
 
-	m_scaleAnimationBySpeed = currentAnimation.m_scaleBySpeed;
+	if(!currentAnimation)
+	{
+		return;
+	}
+
+	m_scaleAnimationBySpeed = currentAnimation->m_scaleBySpeed;
 
 	Vec3 viewingDirection = GetViewingDirectionFromCamera(camera);
 
-	SpriteAnimDefinition* spriteAnimDefinition = currentAnimation.GetAnimationDefinitionBasedOnViewingDirection(Vec3(viewingDirection.x, viewingDirection.y, 0.f).GetNormalized());
+	SpriteAnimDefinition* spriteAnimDefinition = currentAnimation->GetAnimationDefinitionBasedOnViewingDirection(Vec3(viewingDirection.x, viewingDirection.y, 0.f).GetNormalized());
 
-	if(m_actorAnimation != spriteAnimDefinition)
+	if(spriteAnimDefinition && m_actorAnimation != spriteAnimDefinition)
 	{
 		m_actorAnimation = spriteAnimDefinition;
 
@@ -564,10 +612,38 @@ void Actor::SetAnimationIfViewChanged(Camera const& camera)
 	}
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Actor::CreateWeaponsAndAIController()
+{
+	for(size_t weaponIndex = 0; weaponIndex < m_definition->m_weaponInventory.size(); ++weaponIndex)
+	{
+		std::string weaponName = m_definition->m_weaponInventory[weaponIndex];
+
+		for(size_t index = 0; index < WeaponDefinition::s_weaponDefinitions.size(); ++index)
+		{
+			if(WeaponDefinition::s_weaponDefinitions[index].m_name == weaponName)
+			{
+				m_weaponInventory.push_back(new Weapon(&WeaponDefinition::s_weaponDefinitions[index], this));
+			}
+		}
+	}
+
+	if(m_weaponInventory.size() > 0)
+	{
+		m_currentWeapon = m_weaponInventory[0];
+	}
+
+	if(m_definition->m_aiEnabled)
+	{
+		m_aiController = new AIController(m_map);
+		m_aiController->Possess(this);
+	}
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Actor::SetSpawnState()
 {
-	if(m_definition->m_name == "BloodSplatter" || m_definition->m_name == "BulletHit")
+	if(m_definition->IsEffect())
 	{
 		SetActorState(ActorState::DYING);
 		m_defaultState = ActorState::DYING;
@@ -586,29 +662,6 @@ SpriteDefinition Actor::GetAnimationSpriteDef()
 	return m_actorAnimation->GetSpriteDefAtTime(static_cast<float>(m_animationTimer.GetElapsedTime()));
 }
 
-//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-AnimationGroup Actor::GetAnimationGroupByState(ActorState state)
-{
-	if(state == ActorState::WALKING)
-	{
-		return m_definition->GetAnimationByName("Walk");
-	}
-	else if(state == ActorState::ATTACKING)
-	{
-		return m_definition->GetAnimationByName("Attack");
-	}
-	else if(state == ActorState::HURTING)
-	{
-		return m_definition->GetAnimationByName("Hurt");
-	}
-	else if(state == ActorState::DYING)
-	{
-		return m_definition->GetAnimationByName("Death");
-	}
-
-	return m_definition->GetAnimationByName("Death");
-}
-
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Actor::SetActorState(ActorState newState)
 {
@@ -616,13 +669,14 @@ void Actor::SetActorState(ActorState newState)
 	{
 		m_state = newState;
 
-		AnimationGroup currentAnimation = GetAnimationGroupByState(m_state);
-
-		SpriteAnimDefinition* spriteAnimDefinition = currentAnimation.GetAnimationDefinitionBasedOnViewingDirection(Vec3(1.f, 0.f, 0.f).GetNormalized());
+		AnimationGroup const* currentAnimation = m_definition->GetAnimationGroupForState(m_state);
 
-		m_animationTimer.m_period = spriteAnimDefinition->GetNumberOfFramesForAnimation() / spriteAnimDefinition->GetFPS();
+		if(currentAnimation)
+		{
+			m_animationTimer.m_period = currentAnimation->GetDurationSeconds(Vec3(1.f, 0.f, 0.f));
 
-		m_animationTimer.Restart();
+			m_animationTimer.Restart();
+		}
 
 		SoundID newAudioID = GetSoundIDForCurrentState();
 
@@ -678,18 +732,7 @@ Vec3 Actor::GetViewingDirectionFromCamera(Camera const& camera)
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 SoundID Actor::GetSoundIDForCurrentState()
 {
-	switch(m_state)
-	{
-		case ActorState::WALKING:	return m_definition->GetSoundByName("Walk"); 
-
-		case ActorState::ATTACKING: return m_definition->GetSoundByName("Attack");
-		
-		case ActorState::HURTING:	return m_definition->GetSoundByName("Hurt");
-		
-		case ActorState::DYING:     return m_definition->GetSoundByName("Death");
-		
-		default:					return MISSING_SOUND_ID;
-	}
+	return m_definition->GetSoundForState(m_state);
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -725,7 +768,7 @@ void Actor::UpdateSoundPosition()
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool Actor::IsAlive()
 {
-	return (m_state == ActorState::WALKING && m_definition->m_name != "PlasmaProjectile");
+	return (m_state == ActorState::WALKING && !m_definition->IsProjectile());
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
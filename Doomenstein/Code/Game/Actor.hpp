@@ -7,6 +7,7 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/Timer.hpp"
 #include "Game/ActorHandle.hpp"
+#include "Game/ActorDefinition.hpp"
 
 #include <vector>
 #include <string>
@@ -32,32 +33,28 @@ typedef size_t SoundID;
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-enum class ActorState
-{
-	WALKING,
-	ATTACKING,
-	HURTING,
-	DYING,
-	DEAD
-};
-
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 class Actor
 {
 
 public:
-	Actor(Map* map, std::string const& m_name, Vec3 const& m_position, EulerAngles const& m_orientation, ActorHandle const& actorHandle, Actor* owner = nullptr);
+	Actor(Map* map, ActorDefinition* definition, Vec3 const& m_position, EulerAngles const& m_orientation, ActorHandle const& actorHandle, Actor* owner = nullptr);
+	Actor(Map* map, ActorDefinition* definition);
 	~Actor();
 
+	void Respawn(Vec3 const& position, EulerAngles const& orientation, ActorHandle const& actorHandle);
+
 	void Update();
 
 	void DeathStateUpdate();
 
-	void PhysicsUpdate();
+	void UpdateRenderPosition(float tickFraction);
 
 	void Render(Camera const& camera);
 	void RenderDepth();
+	bool ShouldRenderForCamera(Camera const& camera) const;
 	Mat44 GetModelMatrix() const;
+	Mat44 GetBillboardMatrix(Camera const& camera) const;
 
 	Vec3 GetForwardVector();
 	Vec3 GetUpVector();
@@ -85,10 +82,10 @@ public:
 	void IncrementPlayerKillsOnAttackingPlayer(Actor* attackingActor);
 
 	void SetAnimationIfViewChanged(Camera const& camera);
+	void CreateWeaponsAndAIController();
 	void SetSpawnState();
 
 	SpriteDefinition GetAnimationSpriteDef();
-	AnimationGroup   GetAnimationGroupByState(ActorState state);
 
 	void SetActorState(ActorState newState);
 	bool IsAlive();
@@ -118,6 +115,8 @@ public:
 	std::vector<unsigned int>  m_indexes;
 
 	Vec3		m_position;
+	Vec3		m_previousPosition;	// m_position before the latest physics tick
+	Vec3		m_renderPosition;	// blended between the two by how far the clock is into the next tick
 	EulerAngles m_orientation;
 	Vec3		m_acceleration;
 	Vec3		m_velocity;
@@ -0,0 +1,156 @@
+#include "Game/ActorBatchRenderer.hpp"
+#include "Game/Actor.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Camera.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorBatchRenderer::BeginBatches()
+{
+	for(ActorBatch& batch : m_batches)
+	{
+		batch.m_litVerts.clear();
+		batch.m_litIndexes.clear();
+		batch.m_unlitVerts.clear();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorBatchRenderer::AddActor(Actor& actor, Camera const& camera)
+{
+	if(!actor.ShouldRenderForCamera(camera))
+	{
+		return;
+	}
+
+	actor.SetAnimationIfViewChanged(camera);
+	actor.FillActorVerts();
+
+	ActorDefinition const* actorDef = actor.m_definition;
+	ActorBatch& batch = GetOrCreateBatch(actorDef->m_shader, actorDef->m_texture, actorDef->m_renderLit);
+
+	Mat44 billboardTransform = actor.GetBillboardMatrix(camera);
+
+	if(actorDef->m_renderLit)
+	{
+		unsigned int baseVertex = static_cast<unsigned int>(batch.m_litVerts.size());
+
+		for(Vertex_PCUTBN const& localVert : actor.m_verts)
+		{
+			Vertex_PCUTBN worldVert = localVert;
+
+			worldVert.m_position  = billboardTransform.TransformPosition3D(localVert.m_position);
+			worldVert.m_tangent	  = billboardTransform.TransformVectorQuantity3D(localVert.m_tangent);
+			worldVert.m_biTangent = billboardTransform.TransformVectorQuantity3D(localVert.m_biTangent);
+			worldVert.m_normal	  = billboardTransform.TransformVectorQuantity3D(localVert.m_normal);
+			worldVert.m_color	  = GetTintedColor(localVert.m_color, actor.m_color);
+
+			batch.m_litVerts.push_back(worldVert);
+		}
+
+		for(unsigned int index : actor.m_indexes)
+		{
+			batch.m_litIndexes.push_back(baseVertex + index);
+		}
+	}
+	else
+	{
+		for(Vertex_PCU const& localVert : actor.m_unlitVerts)
+		{
+			Vertex_PCU worldVert = localVert;
+
+			worldVert.m_position = billboardTransform.TransformPosition3D(localVert.m_position);
+			worldVert.m_color	 = GetTintedColor(localVert.m_color, actor.m_color);
+
+			batch.m_unlitVerts.push_back(worldVert);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorBatchRenderer::RenderBatches() const
+{
+	g_theRenderer->SetModelConstants();
+	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
+	g_theRenderer->SetBlendMode(BlendMode::OPAQUE);
+
+	for(ActorBatch const& batch : m_batches)
+	{
+		if(batch.m_litVerts.empty() && batch.m_unlitVerts.empty())
+		{
+			continue;
+		}
+
+		g_theRenderer->BindShader(batch.m_shader);
+		g_theRenderer->BindTexture(batch.m_texture);
+
+		if(batch.m_isLit)
+		{
+			g_theRenderer->DrawIndexedVertexArray(batch.m_litVerts, batch.m_litIndexes);
+		}
+		else
+		{
+			g_theRenderer->DrawVertexArray(batch.m_unlitVerts);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ActorBatchRenderer::GetNumActiveBatches() const
+{
+	int numActiveBatches = 0;
+
+	for(ActorBatch const& batch : m_batches)
+	{
+		if(!batch.m_litVerts.empty() || !batch.m_unlitVerts.empty())
+		{
+			numActiveBatches += 1;
+		}
+	}
+
+	return numActiveBatches;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::vector<ActorBatch> const& ActorBatchRenderer::GetBatches() const
+{
+	return m_batches;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The per-actor path multiplies the vertex color by the model color in the shader; batches bake that product in
+Rgba8 ActorBatchRenderer::GetTintedColor(Rgba8 const& vertexColor, Rgba8 const& tint)
+{
+	unsigned char r = static_cast<unsigned char>((static_cast<int>(vertexColor.r) * static_cast<int>(tint.r) + 127) / 255);
+	unsigned char g = static_cast<unsigned char>((static_cast<int>(vertexColor.g) * static_cast<int>(tint.g) + 127) / 255);
+	unsigned char b = static_cast<unsigned char>((static_cast<int>(vertexColor.b) * static_cast<int>(tint.b) + 127) / 255);
+	unsigned char a = static_cast<unsigned char>((static_cast<int>(vertexColor.a) * static_cast<int>(tint.a) + 127) / 255);
+
+	return Rgba8(r, g, b, a);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+ActorBatch& ActorBatchRenderer::GetOrCreateBatch(Shader* shader, Texture* texture, bool isLit)
+{
+	// only a handful of actor definitions exist, so a linear scan beats hashing here
+	for(ActorBatch& batch : m_batches)
+	{
+		if(batch.m_shader == shader && batch.m_texture == texture && batch.m_isLit == isLit)
+		{
+			return batch;
+		}
+	}
+
+	ActorBatch newBatch;
+	newBatch.m_shader  = shader;
+	newBatch.m_texture = texture;
+	newBatch.m_isLit   = isLit;
+
+	m_batches.push_back(newBatch);
+
+	return m_batches.back();
+}
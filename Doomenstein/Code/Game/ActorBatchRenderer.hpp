@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Rgba8.hpp"
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class Actor;
+class Camera;
+class Shader;
+class Texture;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Every visible actor's billboard for one group of render state, already transformed to world space
+struct ActorBatch
+{
+	Shader*						m_shader  = nullptr;
+	Texture*					m_texture = nullptr;
+	bool						m_isLit	  = false;
+
+	std::vector<Vertex_PCUTBN>	m_litVerts;
+	std::vector<unsigned int>	m_litIndexes;
+	std::vector<Vertex_PCU>		m_unlitVerts;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Collects the billboards of all actors seen by one camera and draws them with one draw call per (shader, texture, lit)
+// group instead of one per actor. The billboard transform and the actor tint are baked into the vertices on the CPU,
+// so the batches are drawn with identity model constants.
+// Batches and their vertex storage are kept between frames, so steady state rendering does not allocate.
+class ActorBatchRenderer
+{
+public:
+
+	ActorBatchRenderer() = default;
+	~ActorBatchRenderer() = default;
+
+	void	BeginBatches();
+	void	AddActor(Actor& actor, Camera const& camera);
+	void	RenderBatches() const;
+
+	int		GetNumActiveBatches() const;
+
+	std::vector<ActorBatch> const& GetBatches() const;
+
+	static Rgba8 GetTintedColor(Rgba8 const& vertexColor, Rgba8 const& tint);
+
+private:
+
+	ActorBatch& GetOrCreateBatch(Shader* shader, Texture* texture, bool isLit);
+
+private:
+
+	std::vector<ActorBatch> m_batches;
+};
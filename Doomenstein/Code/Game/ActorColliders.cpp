@@ -0,0 +1,86 @@
+#include "Game/ActorColliders.hpp"
+#include "Game/Actor.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/CylinderBatch.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorColliders::SetSlot(int actorSlot, Actor const& actor)
+{
+	if(actorSlot >= static_cast<int>(m_isOccupied.size()))
+	{
+		Resize(actorSlot + 1);
+	}
+
+	ActorDefinition const* actorDef = actor.m_definition;
+
+	m_positionX[actorSlot] = actor.m_position.x;
+	m_positionY[actorSlot] = actor.m_position.y;
+	m_positionZ[actorSlot] = actor.m_position.z;
+	m_radius[actorSlot]	   = actorDef->m_physicsRadius;
+	m_height[actorSlot]	   = actorDef->m_physicsHeight;
+	m_isOccupied[actorSlot] = 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorColliders::ClearSlot(int actorSlot)
+{
+	if(actorSlot < static_cast<int>(m_isOccupied.size()))
+	{
+		m_isOccupied[actorSlot] = 0;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorColliders::Refresh(ActorList const& actors)
+{
+	Resize(static_cast<int>(actors.size()));
+
+	for(int actorSlot = 0; actorSlot < static_cast<int>(actors.size()); ++actorSlot)
+	{
+		if(actors[actorSlot])
+		{
+			SetSlot(actorSlot, *actors[actorSlot]);
+		}
+		else
+		{
+			m_isOccupied[actorSlot] = 0;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool ActorColliders::IsOccupied(int actorSlot) const
+{
+	return actorSlot < static_cast<int>(m_isOccupied.size()) && m_isOccupied[actorSlot] != 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+Vec3 ActorColliders::GetPosition(int actorSlot) const
+{
+	return Vec3(m_positionX[actorSlot], m_positionY[actorSlot], m_positionZ[actorSlot]);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorColliders::AddSlotsToBatch(std::vector<int> const& actorSlots, int skippedSlot, CylinderBatch& out_batch) const
+{
+	for(int actorSlot : actorSlots)
+	{
+		if(actorSlot == skippedSlot || !IsOccupied(actorSlot))
+		{
+			continue;
+		}
+
+		out_batch.AddCylinder(GetPosition(actorSlot), m_height[actorSlot], m_radius[actorSlot], actorSlot);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorColliders::Resize(int numSlots)
+{
+	m_positionX.resize(numSlots, 0.f);
+	m_positionY.resize(numSlots, 0.f);
+	m_positionZ.resize(numSlots, 0.f);
+	m_radius.resize(numSlots, 0.f);
+	m_height.resize(numSlots, 0.f);
+	m_isOccupied.resize(numSlots, 0);
+}
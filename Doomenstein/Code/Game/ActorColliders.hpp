@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Engine/Math/Vec3.hpp"
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class Actor;
+class CylinderBatch;
+
+typedef std::vector<Actor*> ActorList;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Structure-of-arrays mirror of every actor's collision cylinder, indexed by actor slot like Map::m_allActors.
+// Actors only move inside Map::PhysicsUpdate and when they are spawned, so the map refreshes the whole mirror after each
+// physics tick and patches single slots on spawn and destroy, so positions and sizes always match the actors.
+// Queries read these arrays instead of chasing Actor pointers into their ActorDefinition.
+class ActorColliders
+{
+public:
+
+	ActorColliders() = default;
+	~ActorColliders() = default;
+
+	void	SetSlot(int actorSlot, Actor const& actor);
+	void	ClearSlot(int actorSlot);
+	void	Refresh(ActorList const& actors);
+
+	bool			IsOccupied(int actorSlot) const;
+	Vec3			GetPosition(int actorSlot) const;
+
+	// Packs the given slots into the batch in order, skipping empty slots and skippedSlot (pass -1 to keep all)
+	void	AddSlotsToBatch(std::vector<int> const& actorSlots, int skippedSlot, CylinderBatch& out_batch) const;
+
+private:
+
+	void	Resize(int numSlots);
+
+private:
+
+	std::vector<float>			m_positionX;
+	std::vector<float>			m_positionY;
+	std::vector<float>			m_positionZ;
+	std::vector<float>			m_radius;
+	std::vector<float>			m_height;
+	std::vector<unsigned char>	m_isOccupied;
+};
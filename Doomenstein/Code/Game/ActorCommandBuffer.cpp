@@ -0,0 +1,165 @@
+#include "Game/ActorCommandBuffer.hpp"
+#include "Game/Actor.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/JobSystem.hpp"
+
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static bool IsCommandIssuedBefore(ActorCommand const& commandA, ActorCommand const& commandB)
+{
+	return commandA.m_issuerSlot < commandB.m_issuerSlot;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Only grows, so commands already queued are never dropped
+void ActorCommandBuffer::SetNumThreads(int numThreads)
+{
+	if(static_cast<int>(m_threadCommands.size()) < numThreads)
+	{
+		m_threadCommands.resize(numThreads);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorCommandBuffer::QueueSpawn(Actor const* issuer, int actorDefID, Vec3 const& position, EulerAngles const& orientation, Vec3 const& velocity, ActorState spawnState, Actor const* owner)
+{
+	ActorCommand command;
+	command.m_type			= ActorCommandType::SPAWN;
+	command.m_sourceHandle	= owner ? owner->m_handle : ActorHandle::INVALID;
+	command.m_actorDefID	= actorDefID;
+	command.m_position		= position;
+	command.m_orientation	= orientation;
+	command.m_velocity		= velocity;
+	command.m_spawnState	= spawnState;
+
+	Queue(issuer, command);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorCommandBuffer::QueueDamage(Actor const* issuer, Actor const* target, float damage, Actor const* attacker)
+{
+	ActorCommand command;
+	command.m_type			= ActorCommandType::DAMAGE;
+	command.m_targetHandle	= target->m_handle;
+	command.m_sourceHandle	= attacker ? attacker->m_handle : ActorHandle::INVALID;
+	command.m_damage		= damage;
+
+	Queue(issuer, command);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorCommandBuffer::QueueImpulse(Actor const* issuer, Actor const* target, Vec3 const& impulse)
+{
+	ActorCommand command;
+	command.m_type			= ActorCommandType::IMPULSE;
+	command.m_targetHandle	= target->m_handle;
+	command.m_impulse		= impulse;
+
+	Queue(issuer, command);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorCommandBuffer::QueueKill(Actor const* issuer, Actor const* target)
+{
+	ActorCommand command;
+	command.m_type			= ActorCommandType::KILL;
+	command.m_targetHandle	= target->m_handle;
+
+	Queue(issuer, command);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The lists are emptied before anything is applied, so commands queued by the commands themselves wait for the next Apply
+void ActorCommandBuffer::Apply(Map& map)
+{
+	m_applyingCommands.clear();
+
+	for(std::vector<ActorCommand>& commands : m_threadCommands)
+	{
+		m_applyingCommands.insert(m_applyingCommands.end(), commands.begin(), commands.end());
+		commands.clear();
+	}
+
+	std::stable_sort(m_applyingCommands.begin(), m_applyingCommands.end(), IsCommandIssuedBefore);
+
+	for(ActorCommand const& command : m_applyingCommands)
+	{
+		ApplyCommand(map, command);
+	}
+
+	m_applyingCommands.clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorCommandBuffer::Clear()
+{
+	for(std::vector<ActorCommand>& commands : m_threadCommands)
+	{
+		commands.clear();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorCommandBuffer::Queue(Actor const* issuer, ActorCommand& command)
+{
+	command.m_issuerSlot = issuer ? issuer->m_handle.GetIndex() : ActorHandle::MAX_ACTOR_INDEX;
+
+	m_threadCommands[JobSystem::GetThreadIndex()].push_back(command);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorCommandBuffer::ApplyCommand(Map& map, ActorCommand const& command) const
+{
+	switch(command.m_type)
+	{
+		case ActorCommandType::SPAWN:
+		{
+			SpawnInfo spawnInfo;
+			spawnInfo.m_actorDefID	= command.m_actorDefID;
+			spawnInfo.m_position	= command.m_position;
+			spawnInfo.m_orientation = command.m_orientation;
+			spawnInfo.m_velocity	= command.m_velocity;
+
+			Actor* actor = map.SpawnActor(spawnInfo);
+			actor->m_owner = map.GetActorByHandle(command.m_sourceHandle);
+			actor->SetActorState(command.m_spawnState);
+			break;
+		}
+
+		case ActorCommandType::DAMAGE:
+		{
+			Actor* target = map.GetActorByHandle(command.m_targetHandle);
+
+			if(target)
+			{
+				target->TakeDamage(command.m_damage, map.GetActorByHandle(command.m_sourceHandle));
+			}
+			break;
+		}
+
+		case ActorCommandType::IMPULSE:
+		{
+			Actor* target = map.GetActorByHandle(command.m_targetHandle);
+
+			if(target)
+			{
+				target->AddImpulse(command.m_impulse);
+			}
+			break;
+		}
+
+		case ActorCommandType::KILL:
+		{
+			Actor* target = map.GetActorByHandle(command.m_targetHandle);
+
+			if(target && target->m_state != ActorState::DYING && target->m_state != ActorState::DEAD)
+			{
+				target->m_health = 0.f;
+				target->SetActorState(ActorState::DYING);
+			}
+			break;
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Game/ActorHandle.hpp"
+#include "Game/ActorDefinition.hpp"
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class Map;
+class Actor;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+enum class ActorCommandType
+{
+	SPAWN,
+	DAMAGE,
+	IMPULSE,
+	KILL
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// One deferred change to the map's actors. Actors are referred to by handle, so a command whose target is gone by
+// the time it is applied does nothing. Fields a command type does not use keep their defaults.
+struct ActorCommand
+{
+	ActorCommandType	m_type			= ActorCommandType::DAMAGE;
+	unsigned int		m_issuerSlot	= ActorHandle::MAX_ACTOR_INDEX;
+
+	ActorHandle			m_targetHandle	= ActorHandle::INVALID;	// damaged, pushed or killed actor
+	ActorHandle			m_sourceHandle	= ActorHandle::INVALID;	// attacker for damage, owner for spawns
+	float				m_damage		= 0.f;
+	Vec3				m_impulse;
+
+	int					m_actorDefID	= INVALID_ACTOR_DEFINITION_ID;
+	Vec3				m_position;
+	EulerAngles			m_orientation;
+	Vec3				m_velocity;
+	ActorState			m_spawnState	= ActorState::WALKING;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Spawns, damage, impulses and kills that game code asks for while the actor list is being walked, held back until
+// Map::Update applies them all at once. Each job system thread appends to its own list, so queueing takes no lock.
+// Apply merges the lists and sorts them by the slot of the actor that issued each command, keeping every actor's own
+// commands in the order it issued them, so the result does not depend on which thread queued what.
+class ActorCommandBuffer
+{
+public:
+
+	ActorCommandBuffer() = default;
+	~ActorCommandBuffer() = default;
+
+	void	SetNumThreads(int numThreads);
+
+	// issuer may be null for commands that come from outside the actor update, such as dev console events
+	void	QueueSpawn(Actor const* issuer, int actorDefID, Vec3 const& position, EulerAngles const& orientation, Vec3 const& velocity, ActorState spawnState, Actor const* owner = nullptr);
+	void	QueueDamage(Actor const* issuer, Actor const* target, float damage, Actor const* attacker);
+	void	QueueImpulse(Actor const* issuer, Actor const* target, Vec3 const& impulse);
+	void	QueueKill(Actor const* issuer, Actor const* target);
+
+	void	Apply(Map& map);
+	void	Clear();
+
+private:
+
+	void	Queue(Actor const* issuer, ActorCommand& command);
+	void	ApplyCommand(Map& map, ActorCommand const& command) const;
+
+private:
+
+	std::vector<std::vector<ActorCommand>>	m_threadCommands;
+	std::vector<ActorCommand>				m_applyingCommands;
+};
@@ -21,6 +21,23 @@ ActorDefinition::ActorDefinition(XmlElement const& actorDefElement)
 	m_lifetime	     = ParseXmlAttribute(actorDefElement, "lifetime", m_lifetime);
 	m_visible		 = ParseXmlAttribute(actorDefElement, "visible", m_visible);
 	m_canBePossessed = ParseXmlAttribute(actorDefElement, "canBePossessed", m_canBePossessed);
+	m_dieOnSpawn	 = ParseXmlAttribute(actorDefElement, "dieOnSpawn", m_dieOnSpawn);
+
+	if(ParseXmlAttribute(actorDefElement, "isProjectile", false))
+	{
+		m_flags |= ACTOR_FLAG_PROJECTILE;
+	}
+
+	// short-lived effects like bullet hits start out dying
+	if(ParseXmlAttribute(actorDefElement, "isEffect", m_dieOnSpawn))
+	{
+		m_flags |= ACTOR_FLAG_EFFECT;
+	}
+
+	if(ParseXmlAttribute(actorDefElement, "isSpawnPoint", false))
+	{
+		m_flags |= ACTOR_FLAG_SPAWN_POINT;
+	}
 	
 	XmlElement const* childDefElements = actorDefElement.FirstChildElement();
 
@@ -77,7 +94,8 @@ ActorDefinition::ActorDefinition(XmlElement const& actorDefElement)
 			continue;
 		}
 	}
-		
+
+	InitializeStateTables();
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -100,6 +118,7 @@ void ActorDefinition::InitializeActorDefinition()
 		GUARANTEE_OR_DIE(elementName == "ActorDefinition", "Child Element should be Actor Definition");
 
 		ActorDefinition newActorDefintition = ActorDefinition(*actorDefElement);
+		newActorDefintition.m_id = static_cast<int>(s_actorDefinitions.size());
 		s_actorDefinitions.push_back(newActorDefintition);
 
 		actorDefElement = actorDefElement->NextSiblingElement();
@@ -126,6 +145,8 @@ void ActorDefinition::InitializeProjectileActorDefinition()
 		GUARANTEE_OR_DIE(elementName == "ActorDefinition", "Child Element should be Actor Definition");
 
  		ActorDefinition newProjectileActorDefintition = ActorDefinition(*projectileActorDefElement);
+		newProjectileActorDefintition.m_id = static_cast<int>(s_actorDefinitions.size());
+		newProjectileActorDefintition.m_flags |= ACTOR_FLAG_PROJECTILE;
 		s_actorDefinitions.push_back(newProjectileActorDefintition);
 
 		projectileActorDefElement = projectileActorDefElement->NextSiblingElement();
@@ -133,6 +154,46 @@ void ActorDefinition::InitializeProjectileActorDefinition()
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+ActorDefinition* ActorDefinition::GetActorDefinitionByName(std::string const& name)
+{
+	for(size_t actorDefIndex = 0; actorDefIndex < s_actorDefinitions.size(); ++actorDefIndex)
+	{
+		if(s_actorDefinitions[actorDefIndex].m_name == name)
+		{
+			return &s_actorDefinitions[actorDefIndex];
+		}
+	}
+
+	return nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ActorDefinition::GetActorDefinitionIDByName(std::string const& name)
+{
+	ActorDefinition const* actorDef = GetActorDefinitionByName(name);
+
+	return actorDef ? actorDef->m_id : INVALID_ACTOR_DEFINITION_ID;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool ActorDefinition::IsProjectile() const
+{
+	return (m_flags & ACTOR_FLAG_PROJECTILE) != 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool ActorDefinition::IsEffect() const
+{
+	return (m_flags & ACTOR_FLAG_EFFECT) != 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool ActorDefinition::IsSpawnPoint() const
+{
+	return (m_flags & ACTOR_FLAG_SPAWN_POINT) != 0;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void ActorDefinition::InitializeCollisionValues(XmlElement const& actorDefElement)
 {
@@ -210,18 +271,22 @@ void ActorDefinition::InitializeVisuals(XmlElement const& visualDefElement)
 	shaderName	    = ParseXmlAttribute(visualDefElement, "shader",		   shaderName);
 	spriteSheetName = ParseXmlAttribute(visualDefElement, "spriteSheet",   spriteSheetName);
 	
-	if(m_renderLit)
-	{
-		m_shader = g_theRenderer->CreateOrGetShader(shaderName.c_str(), InputLayoutType::VERTEX_PCUTBN);
-	}
-	else
+	// headless runs have no renderer; the animation groups are still loaded because their durations drive actor states
+	if(g_theRenderer)
 	{
-		m_shader = g_theRenderer->CreateOrGetShader(shaderName.c_str(), InputLayoutType::VERTEX_PCU);
-	}
+		if(m_renderLit)
+		{
+			m_shader = g_theRenderer->CreateOrGetShader(shaderName.c_str(), InputLayoutType::VERTEX_PCUTBN);
+		}
+		else
+		{
+			m_shader = g_theRenderer->CreateOrGetShader(shaderName.c_str(), InputLayoutType::VERTEX_PCU);
+		}
 
-	m_texture = g_theRenderer->CreateOrGetTextureFromFile(spriteSheetName.c_str());
+		m_texture = g_theRenderer->CreateOrGetTextureFromFile(spriteSheetName.c_str());
 
-	m_spriteSheet = new SpriteSheet(*m_texture, m_cellCount);
+		m_spriteSheet = new SpriteSheet(*m_texture, m_cellCount);
+	}
 
 	SetBillboardType(billboardString);
 
@@ -232,7 +297,7 @@ void ActorDefinition::InitializeVisuals(XmlElement const& visualDefElement)
 		std::string name = animGroupElement->Name();
 		GUARANTEE_OR_DIE(name == "AnimationGroup", "Failed to load Animation Group. Element Does not exist or named something other than \"AnimationGroup\"; ActorDefinition::InitializeVisuals");
 
-		AnimationGroup animGroup = AnimationGroup(*animGroupElement, *m_spriteSheet);
+		AnimationGroup animGroup = AnimationGroup(*animGroupElement, m_spriteSheet);
 		m_animGroups.push_back(animGroup);
 
 		animGroupElement = animGroupElement->NextSiblingElement();
@@ -254,7 +319,7 @@ void ActorDefinition::InitializeAudio(XmlElement const& audioDefElement)
 		soundName = ParseXmlAttribute(*soundElement, "sound", soundName);
 		soundFilePath = ParseXmlAttribute(*soundElement, "name", soundName);
 
-		SoundID soundID = g_theAudioSystem->CreateOrGetSound(soundFilePath, FMOD_3D);
+		SoundID soundID = g_theAudioSystem ? g_theAudioSystem->CreateOrGetSound(soundFilePath, FMOD_3D) : MISSING_SOUND_ID;
 
 		SoundGroup soundGroup;
 		soundGroup.m_name = soundName;
@@ -312,23 +377,47 @@ void ActorDefinition::SetBillboardType(std::string billboardType)
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-AnimationGroup ActorDefinition::GetAnimationByName(std::string animName)
+void ActorDefinition::InitializeStateTables()
+{
+	// Names each state's animation group and sound use in the definition XML. DEAD keeps showing the death animation.
+	static char const* const s_animNameByState[static_cast<int>(ActorState::COUNT)]  = { "Walk", "Attack", "Hurt", "Death", "Death" };
+	static char const* const s_soundNameByState[static_cast<int>(ActorState::COUNT)] = { "Walk", "Attack", "Hurt", "Death", nullptr };
+
+	for(int stateIndex = 0; stateIndex < static_cast<int>(ActorState::COUNT); ++stateIndex)
+	{
+		m_animGroupIndexByState[stateIndex] = -1;
+
+		for(int groupIndex = 0; groupIndex < static_cast<int>(m_animGroups.size()); ++groupIndex)
+		{
+			if(m_animGroups[groupIndex].m_name == s_animNameByState[stateIndex])
+			{
+				m_animGroupIndexByState[stateIndex] = groupIndex;
+				break;
+			}
+		}
+
+		m_soundByState[stateIndex] = s_soundNameByState[stateIndex] ? GetSoundByName(s_soundNameByState[stateIndex]) : MISSING_SOUND_ID;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+AnimationGroup const* ActorDefinition::GetAnimationByName(std::string const& animName) const
 {
-	for(AnimationGroup animGroup : m_animGroups)
+	for(AnimationGroup const& animGroup : m_animGroups)
 	{
 		if(animGroup.m_name == animName)
 		{
-			return animGroup;
+			return &animGroup;
 		}
 	}
 
-	return AnimationGroup();
+	return nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-SoundID ActorDefinition::GetSoundByName(std::string soundName)
+SoundID ActorDefinition::GetSoundByName(std::string const& soundName) const
 {
-	for(SoundGroup currentGroup : m_soundGroups)
+	for(SoundGroup const& currentGroup : m_soundGroups)
 	{
 		if(currentGroup.m_name == soundName)
 		{
@@ -340,7 +429,21 @@ SoundID ActorDefinition::GetSoundByName(std::string soundName)
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-AnimationGroup::AnimationGroup(XmlElement const& actorDefElement, SpriteSheet const& spriteSheet)
+AnimationGroup const* ActorDefinition::GetAnimationGroupForState(ActorState state) const
+{
+	int groupIndex = m_animGroupIndexByState[static_cast<int>(state)];
+
+	return (groupIndex >= 0) ? &m_animGroups[groupIndex] : nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+SoundID ActorDefinition::GetSoundForState(ActorState state) const
+{
+	return m_soundByState[static_cast<int>(state)];
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+AnimationGroup::AnimationGroup(XmlElement const& actorDefElement, SpriteSheet const* spriteSheet)
 {	
 	std::string playbackName;
 	float secondsPerFrame = 0.f;
@@ -376,49 +479,80 @@ AnimationGroup::AnimationGroup(XmlElement const& actorDefElement, SpriteSheet co
 		std::string name = dirGroup->Name();
 		GUARANTEE_OR_DIE(name == "Direction", "Failed to load Direction Element. Element does not exist or named something other than \"Direction\"; AnimationGroup::AnimationGroup");
 
-		std::string direction = ParseXmlAttribute(*dirGroup, "vector", "0.f, 0.f, 0.f");
+		std::string directionText = ParseXmlAttribute(*dirGroup, "vector", "0.f, 0.f, 0.f");
+
+		Vec3 direction;
+		direction.SetFromText(directionText.c_str());
+		direction.Normalize();
 
 		XmlElement const* animElement = dirGroup->FirstChildElement();
 
 		int start = ParseXmlAttribute(*animElement, "startFrame", -1);
 		int end = ParseXmlAttribute(*animElement,	"endFrame", -1);
 
-		SpriteAnimDefinition* currentAnim = new SpriteAnimDefinition(spriteSheet, start, end, 1.f / secondsPerFrame, playbackType);
+		SpriteAnimDefinition* currentAnim = nullptr;
+
+		if(spriteSheet)
+		{
+			currentAnim = new SpriteAnimDefinition(*spriteSheet, start, end, 1.f / secondsPerFrame, playbackType);
+		}
 
-		m_animDefinitionBasedOnDirection[direction] = currentAnim;
+		m_directions.push_back(direction);
+		m_directionAnimDefinitions.push_back(currentAnim);
+		m_directionDurations.push_back(static_cast<float>(end - start + 1) * secondsPerFrame);
 
 		dirGroup = dirGroup->NextSiblingElement();
 	}
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-SpriteAnimDefinition* AnimationGroup::GetAnimationDefinitionBasedOnViewingDirection(Vec3 const& viewingDriection)
+int AnimationGroup::GetDirectionIndex(Vec3 const& viewingDriection) const
 {
+	int numDirections = static_cast<int>(m_directions.size());
 
-	std::string currentDirectionString = m_animDefinitionBasedOnDirection.begin()->first;
-	
-	Vec3 currentDirection;
-	currentDirection.SetFromText(currentDirectionString.c_str());
-	currentDirection.Normalize();
-	
-	SpriteAnimDefinition* currentDef = m_animDefinitionBasedOnDirection.begin()->second;
+	if(numDirections == 0)
+	{
+		return -1;
+	}
 
-	float maxDot = DotProduct3D(currentDirection, viewingDriection);
+	int	  bestIndex = 0;
+	float maxDot	= DotProduct3D(m_directions[0], viewingDriection);
 
-	for(const auto& [key, value] : m_animDefinitionBasedOnDirection)
+	// selects instead of branching so the scan compiles to conditional moves
+	for(int directionIndex = 1; directionIndex < numDirections; ++directionIndex)
 	{
-		currentDirection.SetFromText(key.c_str());
-		currentDirection.Normalize();
+		float currentDot = DotProduct3D(m_directions[directionIndex], viewingDriection);
+		bool  isBetter	 = currentDot > maxDot;
 
-		float currentDot = DotProduct3D(currentDirection, viewingDriection);
+		bestIndex = isBetter ? directionIndex : bestIndex;
+		maxDot	  = isBetter ? currentDot : maxDot;
+	}
 
-		if(currentDot > maxDot)
-		{
-			currentDirectionString = key;
-			maxDot = currentDot;
-			currentDef = value;
-		}
+	return bestIndex;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+SpriteAnimDefinition* AnimationGroup::GetAnimationDefinitionBasedOnViewingDirection(Vec3 const& viewingDriection) const
+{
+	int directionIndex = GetDirectionIndex(viewingDriection);
+
+	if(directionIndex < 0)
+	{
+		return nullptr;
+	}
+
+	return m_directionAnimDefinitions[directionIndex];
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+float AnimationGroup::GetDurationSeconds(Vec3 const& viewingDriection) const
+{
+	int directionIndex = GetDirectionIndex(viewingDriection);
+
+	if(directionIndex < 0)
+	{
+		return 0.f;
 	}
 
-	return currentDef;
+	return m_directionDurations[directionIndex];
 }
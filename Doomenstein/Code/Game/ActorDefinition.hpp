@@ -10,7 +10,6 @@
 #include "ThirdParty/tinyXML2/tinyxml2.h"
 #include <vector>
 #include <string>
-#include <map>
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 typedef tinyxml2::XMLElement	XmlElement;
 
@@ -21,6 +20,18 @@ struct IntRange;
 
 typedef size_t SoundID;
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions are interned at load: an actor definition's id is its index in s_actorDefinitions, so gameplay code can
+// store and compare ids instead of names.
+constexpr int INVALID_ACTOR_DEFINITION_ID = -1;
+
+// Capabilities resolved once from the definition XML so hot paths test bits instead of comparing names
+typedef unsigned int ActorFlags;
+
+constexpr ActorFlags ACTOR_FLAG_PROJECTILE	= 1 << 0;
+constexpr ActorFlags ACTOR_FLAG_EFFECT		= 1 << 1;
+constexpr ActorFlags ACTOR_FLAG_SPAWN_POINT	= 1 << 2;
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 enum class Faction
 {
@@ -33,14 +44,28 @@ enum class Faction
 	COUNT
 };
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+enum class ActorState
+{
+	WALKING,
+	ATTACKING,
+	HURTING,
+	DYING,
+	DEAD,
+
+	COUNT
+};
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 struct AnimationGroup
 {
 public:
 	AnimationGroup() = default;
-	explicit AnimationGroup(XmlElement const& actorDefElement, SpriteSheet const& spriteSheet);
+	explicit AnimationGroup(XmlElement const& actorDefElement, SpriteSheet const* spriteSheet);
 
-	SpriteAnimDefinition* GetAnimationDefinitionBasedOnViewingDirection(Vec3 const& viewingDriection);
+	int					  GetDirectionIndex(Vec3 const& viewingDriection) const;
+	SpriteAnimDefinition* GetAnimationDefinitionBasedOnViewingDirection(Vec3 const& viewingDriection) const;
+	float				  GetDurationSeconds(Vec3 const& viewingDriection) const;
 
 public:
 
@@ -48,7 +73,11 @@ public:
 	
 	bool m_scaleBySpeed = false;
 
-	std::map<std::string, SpriteAnimDefinition*> m_animDefinitionBasedOnDirection;
+	// parallel arrays in XML order; directions are normalized once at load
+	// the animation definitions are null when there is no sprite sheet (headless); durations are always parsed
+	std::vector<Vec3>					m_directions;
+	std::vector<SpriteAnimDefinition*>	m_directionAnimDefinitions;
+	std::vector<float>					m_directionDurations;
 };
 
 struct SoundGroup
@@ -69,6 +98,12 @@ public:
 
 	static void InitializeActorDefinition();
 	static void InitializeProjectileActorDefinition();
+	static ActorDefinition* GetActorDefinitionByName(std::string const& name);
+	static int				GetActorDefinitionIDByName(std::string const& name);
+
+	bool IsProjectile() const;
+	bool IsEffect() const;
+	bool IsSpawnPoint() const;
 
 	void InitializeCollisionValues(XmlElement const& actorDefElement);
 	void InitializePhysicsValues(XmlElement const& actorDefElement);
@@ -80,8 +115,12 @@ public:
 	void SetFaction(std::string factionName);
 	void SetBillboardType(std::string billboardType);
 
-	AnimationGroup GetAnimationByName(std::string animName);
-	SoundID GetSoundByName(std::string soundName);
+	void InitializeStateTables();
+
+	AnimationGroup const*	GetAnimationByName(std::string const& animName) const;
+	SoundID					GetSoundByName(std::string const& soundName) const;
+	AnimationGroup const*	GetAnimationGroupForState(ActorState state) const;
+	SoundID					GetSoundForState(ActorState state) const;
 
 public:
 	
@@ -89,6 +128,8 @@ public:
 
 	// base
 	std::string m_name;
+	int			m_id			 = INVALID_ACTOR_DEFINITION_ID;
+	ActorFlags	m_flags			 = 0;
 	Faction     m_faction		 = Faction::NEUTRAL;
 	float		m_health		 = 1.f;
 	float		m_corpseLifetime = 2.f;
@@ -136,12 +177,16 @@ public:
 	IntVec2		   m_cellCount		= IntVec2::ONE;
 	Shader*		   m_shader			= nullptr;
 	Texture*	   m_texture	    = nullptr;
-	SpriteSheet*   m_spriteSheet;
+	SpriteSheet*   m_spriteSheet	= nullptr;
 	BillboardType  m_billboardType	= BillboardType::NONE;
 	Rgba8		   m_tint			= Rgba8::WHITE;
 	std::vector<AnimationGroup> m_animGroups;
 	std::vector<SoundGroup>		m_soundGroups;
 
+	// resolved from the group names once at load; indices rather than pointers so definitions can be copied
+	int		m_animGroupIndexByState[static_cast<int>(ActorState::COUNT)];
+	SoundID m_soundByState[static_cast<int>(ActorState::COUNT)];
+
 	bool m_isLightSource = false;
 	Light m_light;
 
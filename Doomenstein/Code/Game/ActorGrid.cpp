@@ -0,0 +1,108 @@
+#include "Game/ActorGrid.hpp"
+
+#include <math.h>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorGrid::Initialize(IntVec2 const& dimensions)
+{
+	m_dimensions = dimensions;
+
+	int numCells = m_dimensions.x * m_dimensions.y;
+
+	m_cellStarts.assign(numCells + 1, 0);
+	m_cellCursors.assign(numCells, 0);
+	m_cellSlots.clear();
+	m_pendingSlots.clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorGrid::Rebuild(std::vector<int> const& cellIndexPerSlot)
+{
+	int numCells = m_dimensions.x * m_dimensions.y;
+
+	m_cellStarts.assign(numCells + 1, 0);
+	m_pendingSlots.clear();
+
+	// count actors per cell, shifted by one so the prefix sum below leaves each cell's start offset in place
+	for(size_t slot = 0; slot < cellIndexPerSlot.size(); ++slot)
+	{
+		int cellIndex = cellIndexPerSlot[slot];
+
+		if(cellIndex >= 0)
+		{
+			m_cellStarts[cellIndex + 1] += 1;
+		}
+	}
+
+	for(int cellIndex = 1; cellIndex <= numCells; ++cellIndex)
+	{
+		m_cellStarts[cellIndex] += m_cellStarts[cellIndex - 1];
+	}
+
+	m_cellSlots.resize(m_cellStarts[numCells]);
+	m_cellCursors.assign(m_cellStarts.begin(), m_cellStarts.end() - 1);
+
+	for(size_t slot = 0; slot < cellIndexPerSlot.size(); ++slot)
+	{
+		int cellIndex = cellIndexPerSlot[slot];
+
+		if(cellIndex >= 0)
+		{
+			m_cellSlots[m_cellCursors[cellIndex]] = static_cast<int>(slot);
+			m_cellCursors[cellIndex] += 1;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorGrid::AddPending(int actorSlot)
+{
+	m_pendingSlots.push_back(actorSlot);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ActorGrid::GetCellIndexForPosition(Vec2 const& position) const
+{
+	IntVec2 cellCoords = GetClampedCellCoords(position);
+
+	return (cellCoords.y * m_dimensions.x) + cellCoords.x;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorGrid::GetActorSlotsInBox(Vec2 const& mins, Vec2 const& maxs, std::vector<int>& out_actorSlots) const
+{
+	if(m_dimensions.x <= 0 || m_dimensions.y <= 0)
+	{
+		return;
+	}
+
+	IntVec2 minCell = GetClampedCellCoords(mins);
+	IntVec2 maxCell = GetClampedCellCoords(maxs);
+
+	for(int cellY = minCell.y; cellY <= maxCell.y; ++cellY)
+	{
+		for(int cellX = minCell.x; cellX <= maxCell.x; ++cellX)
+		{
+			int cellIndex = (cellY * m_dimensions.x) + cellX;
+
+			for(int entry = m_cellStarts[cellIndex]; entry < m_cellStarts[cellIndex + 1]; ++entry)
+			{
+				out_actorSlots.push_back(m_cellSlots[entry]);
+			}
+		}
+	}
+
+	out_actorSlots.insert(out_actorSlots.end(), m_pendingSlots.begin(), m_pendingSlots.end());
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+IntVec2 ActorGrid::GetClampedCellCoords(Vec2 const& position) const
+{
+	int cellX = static_cast<int>(floorf(position.x));
+	int cellY = static_cast<int>(floorf(position.y));
+
+	cellX = (cellX < 0) ? 0 : ((cellX >= m_dimensions.x) ? m_dimensions.x - 1 : cellX);
+	cellY = (cellY < 0) ? 0 : ((cellY >= m_dimensions.y) ? m_dimensions.y - 1 : cellY);
+
+	return IntVec2(cellX, cellY);
+}
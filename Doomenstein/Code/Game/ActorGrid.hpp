@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Uniform grid of actor slot indices with one cell per map tile.
+// Rebuilt with a counting sort after every physics tick. Actors spawned between two rebuilds, and actors a collision
+// push moved into another cell, are kept in a small pending list that every query also returns, so a query may contain
+// a slot twice and callers should de-duplicate.
+class ActorGrid
+{
+public:
+
+	ActorGrid() = default;
+	~ActorGrid() = default;
+
+	void	Initialize(IntVec2 const& dimensions);
+	void	Rebuild(std::vector<int> const& cellIndexPerSlot);
+	void	AddPending(int actorSlot);
+
+	int		GetCellIndexForPosition(Vec2 const& position) const;
+	void	GetActorSlotsInBox(Vec2 const& mins, Vec2 const& maxs, std::vector<int>& out_actorSlots) const;
+
+private:
+
+	IntVec2 GetClampedCellCoords(Vec2 const& position) const;
+
+private:
+
+	IntVec2				m_dimensions;
+	std::vector<int>	m_cellStarts;
+	std::vector<int>	m_cellCursors;
+	std::vector<int>	m_cellSlots;
+	std::vector<int>	m_pendingSlots;
+};
@@ -2,8 +2,6 @@
 
 const ActorHandle ActorHandle::INVALID = ActorHandle(0x0000FFFF, 0x0000FFFF);
 
-// 0x4uid4ind
-
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 ActorHandle::ActorHandle(unsigned int uid, unsigned int index)
@@ -1,5 +1,11 @@
 #pragma once
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Weak reference to an actor owned by Map, packed into 32 bits:
+//   high 16 bits - uid handed out by Map on every spawn, cycling through 0..MAX_ACTOR_UID
+//   low 16 bits  - slot index into Map::m_allActors (spawn points use their index in Map::m_allSpawnPoints)
+// Slots are recycled through Map's free list, so a handle only resolves while the actor in its slot still carries the
+// same uid. 0xFFFF is never issued as a uid, which keeps INVALID distinct from every live handle.
 struct ActorHandle
 {
 public:
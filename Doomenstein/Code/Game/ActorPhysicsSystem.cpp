@@ -0,0 +1,168 @@
+#include "Game/ActorPhysicsSystem.hpp"
+#include "Game/Actor.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/JobSystem.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Slots per integration job; each slot is only a few multiply-adds, so jobs have to be large to be worth handing out
+static constexpr int PHYSICS_JOB_GRAIN_SIZE = 1024;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorPhysicsSystem::Initialize()
+{
+	m_gravity = g_gameConfigBlackboard.GetValue("gravity", 0.0f);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dying and dead actors stay in their slot with every factor zeroed, so the integration runs over them harmlessly and
+// the scatter skips them
+void ActorPhysicsSystem::Gather(ActorList const& actors)
+{
+	int numSlots = static_cast<int>(actors.size());
+
+	Resize(numSlots);
+	m_numActiveSlots = 0;
+
+	for(int slot = 0; slot < numSlots; ++slot)
+	{
+		Actor const* actor = actors[slot];
+
+		if(!actor || actor->m_state == ActorState::DYING || actor->m_state == ActorState::DEAD)
+		{
+			m_positionX[slot]	  = 0.f;
+			m_positionY[slot]	  = 0.f;
+			m_positionZ[slot]	  = 0.f;
+			m_velocityX[slot]	  = 0.f;
+			m_velocityY[slot]	  = 0.f;
+			m_velocityZ[slot]	  = 0.f;
+			m_accelerationX[slot] = 0.f;
+			m_accelerationY[slot] = 0.f;
+			m_accelerationZ[slot] = 0.f;
+			m_drag[slot]		  = 0.f;
+			m_gravityScale[slot]  = 0.f;
+			m_isActive[slot]	  = 0;
+			continue;
+		}
+
+		m_positionX[slot]	  = actor->m_position.x;
+		m_positionY[slot]	  = actor->m_position.y;
+		m_positionZ[slot]	  = actor->m_position.z;
+		m_velocityX[slot]	  = actor->m_velocity.x;
+		m_velocityY[slot]	  = actor->m_velocity.y;
+		m_velocityZ[slot]	  = actor->m_velocity.z;
+		m_accelerationX[slot] = actor->m_acceleration.x;
+		m_accelerationY[slot] = actor->m_acceleration.y;
+		m_accelerationZ[slot] = actor->m_acceleration.z;
+		m_drag[slot]		  = actor->m_isGrounded ? actor->m_definition->m_drag : 0.f;
+		m_gravityScale[slot]  = (!actor->m_isGrounded && actor->m_definition->m_effectedByGravity) ? 1.f : 0.f;
+		m_isActive[slot]	  = 1;
+
+		m_numActiveSlots += 1;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Same operations in the same order as the old per-actor update: drag and gravity are added to the acceleration, the
+// position moves by the old velocity, then the velocity takes the acceleration. The gathered acceleration is the
+// controllers' movement force for this frame; it is left on the actor, see Map::StepPhysics.
+// Slots do not depend on each other, so ranges of them are integrated on the job system's threads.
+void ActorPhysicsSystem::Integrate(float deltaSeconds)
+{
+	g_jobSystem->ParallelFor(static_cast<int>(m_isActive.size()), PHYSICS_JOB_GRAIN_SIZE, [this, deltaSeconds](int beginSlot, int endSlot)
+	{
+		IntegrateSlots(deltaSeconds, beginSlot, endSlot);
+	});
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorPhysicsSystem::IntegrateSlots(float deltaSeconds, int beginSlot, int endSlot)
+{
+	float* positionX	 = m_positionX.data();
+	float* positionY	 = m_positionY.data();
+	float* positionZ	 = m_positionZ.data();
+	float* velocityX	 = m_velocityX.data();
+	float* velocityY	 = m_velocityY.data();
+	float* velocityZ	 = m_velocityZ.data();
+	float const* accelerationX = m_accelerationX.data();
+	float const* accelerationY = m_accelerationY.data();
+	float const* accelerationZ = m_accelerationZ.data();
+	float const* drag	 = m_drag.data();
+	float const* gravityScale = m_gravityScale.data();
+
+	float downForce = -m_gravity;
+
+	for(int slot = beginSlot; slot < endSlot; ++slot)
+	{
+		float totalAccelerationX = accelerationX[slot] + (-velocityX[slot]) * drag[slot];
+		float totalAccelerationY = accelerationY[slot] + (-velocityY[slot]) * drag[slot];
+		float totalAccelerationZ = accelerationZ[slot] + (-velocityZ[slot]) * drag[slot] + downForce * gravityScale[slot];
+
+		positionX[slot] += velocityX[slot] * deltaSeconds;
+		positionY[slot] += velocityY[slot] * deltaSeconds;
+		positionZ[slot] += velocityZ[slot] * deltaSeconds;
+
+		velocityX[slot] += totalAccelerationX * deltaSeconds;
+		velocityY[slot] += totalAccelerationY * deltaSeconds;
+		velocityZ[slot] += totalAccelerationZ * deltaSeconds;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorPhysicsSystem::Scatter(ActorList const& actors) const
+{
+	int numSlots = static_cast<int>(m_isActive.size());
+
+	for(int slot = 0; slot < numSlots; ++slot)
+	{
+		if(!m_isActive[slot])
+		{
+			continue;
+		}
+
+		Actor* actor = actors[slot];
+
+		actor->m_position = Vec3(m_positionX[slot], m_positionY[slot], m_positionZ[slot]);
+		actor->m_velocity = Vec3(m_velocityX[slot], m_velocityY[slot], m_velocityZ[slot]);
+
+		if(actor->m_definition->m_isLightSource)
+		{
+			actor->m_light.SetPosition(actor->m_position);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+float ActorPhysicsSystem::GetGravity() const
+{
+	return m_gravity;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ActorPhysicsSystem::GetNumSlots() const
+{
+	return static_cast<int>(m_isActive.size());
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ActorPhysicsSystem::GetNumActiveSlots() const
+{
+	return m_numActiveSlots;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ActorPhysicsSystem::Resize(int numSlots)
+{
+	m_positionX.resize(numSlots);
+	m_positionY.resize(numSlots);
+	m_positionZ.resize(numSlots);
+	m_velocityX.resize(numSlots);
+	m_velocityY.resize(numSlots);
+	m_velocityZ.resize(numSlots);
+	m_accelerationX.resize(numSlots);
+	m_accelerationY.resize(numSlots);
+	m_accelerationZ.resize(numSlots);
+	m_drag.resize(numSlots);
+	m_gravityScale.resize(numSlots);
+	m_isActive.resize(numSlots);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class Actor;
+
+typedef std::vector<Actor*> ActorList;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Kinematic state of every actor slot in contiguous arrays, indexed like Map::m_allActors, integrated in one loop.
+// Gameplay code still reads and writes Actor::m_position, m_velocity and m_acceleration directly, so each physics tick
+// gathers them in, integrates, and scatters the results back. Per-actor branches (grounded drag, gravity, dying actors)
+// are resolved into plain factors during the gather, which leaves the integration loop branch-free and lets the
+// compiler vectorize it. Gravity is read from the game config once per map instead of once per actor per tick.
+class ActorPhysicsSystem
+{
+public:
+
+	ActorPhysicsSystem() = default;
+	~ActorPhysicsSystem() = default;
+
+	void	Initialize();
+
+	void	Gather(ActorList const& actors);
+	void	Integrate(float deltaSeconds);
+	void	Scatter(ActorList const& actors) const;
+
+	float	GetGravity() const;
+	int		GetNumSlots() const;
+	int		GetNumActiveSlots() const;
+
+private:
+
+	void	IntegrateSlots(float deltaSeconds, int beginSlot, int endSlot);
+	void	Resize(int numSlots);
+
+private:
+
+	float						m_gravity = 0.f;
+	int							m_numActiveSlots = 0;
+
+	std::vector<float>			m_positionX;
+	std::vector<float>			m_positionY;
+	std::vector<float>			m_positionZ;
+	std::vector<float>			m_velocityX;
+	std::vector<float>			m_velocityY;
+	std::vector<float>			m_velocityZ;
+	std::vector<float>			m_accelerationX;
+	std::vector<float>			m_accelerationY;
+	std::vector<float>			m_accelerationZ;
+
+	// drag when grounded, else 0; 1 when airborne and affected by gravity, else 0
+	std::vector<float>			m_drag;
+	std::vector<float>			m_gravityScale;
+	std::vector<unsigned char>	m_isActive;
+};
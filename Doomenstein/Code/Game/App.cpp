@@ -14,7 +14,16 @@
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Window/Window.hpp"
+#include "Engine/Core/StringUtils.hpp"
 #include "Game/Game.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/Actor.hpp"
+#include "Game/SimulationClock.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/Replay.hpp"
+
+#include <cstdlib>
 
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -39,11 +48,20 @@ App::~App()
 
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void App::Startup()
+void App::Startup(char const* commandLine)
 {
 
 	LoadConfigFile("Data/GameConfig.xml");
+	ApplyCommandLine(commandLine);
 
+	g_jobSystem = new JobSystem();
+	g_jobSystem->Startup(g_gameConfigBlackboard.GetValue("jobThreads", 0));
+
+	if(m_isHeadless)
+	{
+		StartupHeadless();
+		return;
+	}
 
 	InputConfig inputConfig;
 	g_inputSystem = new InputSystem(inputConfig);
@@ -100,6 +118,11 @@ void App::Startup()
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void App::Shutdown()
 {
+	if(m_isHeadless)
+	{
+		ShutdownHeadless();
+		return;
+	}
 
 	UnsubscribeEventCallbackFunction("Quit", RequestQuitEvent);
 
@@ -126,6 +149,10 @@ void App::Shutdown()
 	delete g_game;
 	g_game = nullptr;
 
+	g_jobSystem->Shutdown();
+	delete g_jobSystem;
+	g_jobSystem = nullptr;
+
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -159,6 +186,12 @@ void App::EndFrame()
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void App::RunMainFrame()
 {
+	if(m_isHeadless)
+	{
+		RunHeadless();
+		return;
+	}
+
 	while(!g_theApp->isQuitting())
 	{
 		g_theApp->RunFrame();
@@ -258,6 +291,260 @@ void App::LoadConfigFile(char const* configFilePath)
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// "-headless" switches to the headless mode; every "key=value" overrides that key from GameConfig.xml, e.g.
+// "-headless headlessBots=256 defaultMap=Senate"
+void App::ApplyCommandLine(char const* commandLine)
+{
+	std::vector<std::string> arguments = SplitStringOnDelimiter(commandLine, ' ');
+
+	for(std::string const& argument : arguments)
+	{
+		if(argument == "-headless")
+		{
+			m_isHeadless = true;
+			continue;
+		}
+
+		size_t equalsIndex = argument.find('=');
+
+		if(equalsIndex != std::string::npos && equalsIndex > 0)
+		{
+			g_gameConfigBlackboard.SetValue(argument.substr(0, equalsIndex), argument.substr(equalsIndex + 1));
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Only the systems the simulation needs: no window, renderer, input, audio or debug rendering. Game and map code treat
+// a null g_theRenderer, g_theAudioSystem and g_gameFont as "nothing to load or draw".
+void App::StartupHeadless()
+{
+	EventSystemConfig eventSystemConfig;
+	g_eventSystem = new EventSystem(eventSystemConfig);
+
+	DevConsoleConfig devConsoleConfig;
+	g_devConsole = new DevConsole(devConsoleConfig);
+
+	g_game = new Game();
+
+	g_eventSystem->Startup();
+	g_devConsole->Startup();
+
+	g_game->StartupHeadless();
+
+	SubscribeEventCallbackFunction("Quit", RequestQuitEvent);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void App::ShutdownHeadless()
+{
+	UnsubscribeEventCallbackFunction("Quit", RequestQuitEvent);
+
+	g_game->Shutdown();
+
+	g_devConsole->Shutdown();
+	g_devConsole = nullptr;
+
+	g_eventSystem->Shutdown();
+	g_eventSystem = nullptr;
+
+	delete g_game;
+	g_game = nullptr;
+
+	g_jobSystem->Shutdown();
+	delete g_jobSystem;
+	g_jobSystem = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Plays one headless match, or with headlessThreadCounts set (e.g. "1,2,4,8,16") replays the same seeded match once
+// per job system thread count and reports the speedup over the first count. The AI think budget is wall clock time
+// and would let faster runs think more, so it is turned off for those runs; with it off every count has to end on
+// the same state hash. With replayFile set the recorded match is played instead of a bot match, in both cases.
+void App::RunHeadless()
+{
+	std::string threadCountsText = g_gameConfigBlackboard.GetValue("headlessThreadCounts", "");
+	std::string replayFilePath	 = g_gameConfigBlackboard.GetValue("replayFile", "");
+
+	if(threadCountsText.empty())
+	{
+		if(replayFilePath.empty())
+		{
+			RunHeadlessMatch();
+		}
+		else
+		{
+			RunReplay(replayFilePath);
+		}
+
+		RequestQuit();
+		return;
+	}
+
+	g_gameConfigBlackboard.SetValue("aiThinkBudgetMicroseconds", "0");
+
+	unsigned int seed = static_cast<unsigned int>(g_gameConfigBlackboard.GetValue("headlessSeed", 1));
+	std::vector<std::string> threadCounts = SplitStringOnDelimiter(threadCountsText, ',');
+	double baseTicksPerSecond = 0.0;
+
+	DebuggerPrintf("Headless scaling: %d hardware threads, seed %u\n", static_cast<int>(std::thread::hardware_concurrency()), seed);
+
+	for(std::string const& threadCountText : threadCounts)
+	{
+		g_jobSystem->Shutdown();
+		g_jobSystem->Startup(atoi(threadCountText.c_str()));
+
+		HeadlessRunStats runStats;
+
+		if(replayFilePath.empty())
+		{
+			srand(seed);
+			g_game->RestartHeadless();
+
+			runStats = RunHeadlessMatch();
+		}
+		else
+		{
+			runStats = RunReplay(replayFilePath);
+		}
+
+		if(runStats.m_numTicks == 0)
+		{
+			break;
+		}
+
+		double ticksPerSecond = static_cast<double>(runStats.m_numTicks) / runStats.m_seconds;
+
+		if(baseTicksPerSecond <= 0.0)
+		{
+			baseTicksPerSecond = ticksPerSecond;
+		}
+
+		DebuggerPrintf("Headless scaling: %2d threads, %.1f ticks per second, %.2fx, state hash %08x\n", g_jobSystem->GetNumThreads(), ticksPerSecond, ticksPerSecond / baseTicksPerSecond, runStats.m_stateHash);
+
+		if(m_isQuitting)
+		{
+			break;
+		}
+	}
+
+	RequestQuit();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Steps the match at a fixed rate as fast as the machine allows and reports how many ticks per second it sustains.
+// Bots and demons that die are replaced, so the load stays at headlessBots and headlessDemons for the whole run.
+HeadlessRunStats App::RunHeadlessMatch()
+{
+	int	   numBots			= g_gameConfigBlackboard.GetValue("headlessBots", 32);
+	int	   numDemons		= g_gameConfigBlackboard.GetValue("headlessDemons", 0);
+	int	   numTicks			= g_gameConfigBlackboard.GetValue("headlessTicks", 3600);
+	int	   reportInterval	= g_gameConfigBlackboard.GetValue("headlessReportTicks", 600);
+	float  ticksPerSecond	= g_gameConfigBlackboard.GetValue("headlessTicksPerSecond", 60.f);
+	double tickSeconds		= 1.0 / static_cast<double>(ticksPerSecond);
+
+	reportInterval = (reportInterval > 0) ? reportInterval : numTicks;
+
+	Map* map = g_game->m_currentMap;
+	std::vector<ActorHandle> botHandles(static_cast<size_t>(numBots), ActorHandle::INVALID);
+	std::vector<ActorHandle> demonHandles(static_cast<size_t>(numDemons), ActorHandle::INVALID);
+
+	DebuggerPrintf("Headless: %s, %d bots, %d demons, %d ticks at %.0f Hz on %d threads\n", map->m_mapDef->m_name.c_str(), numBots, numDemons, numTicks, ticksPerSecond, g_jobSystem->GetNumThreads());
+
+	double runStartTime	   = GetCurrentTimeSeconds();
+	double reportStartTime = runStartTime;
+	int	   tick			   = 0;
+
+	while(tick < numTicks && !m_isQuitting && g_game->GetGameState() == GameState::PLAYING)
+	{
+		for(ActorHandle& botHandle : botHandles)
+		{
+			if(!map->GetActorByHandle(botHandle))
+			{
+				botHandle = map->SpawnBot()->m_handle;
+			}
+		}
+
+		for(ActorHandle& demonHandle : demonHandles)
+		{
+			if(!map->GetActorByHandle(demonHandle))
+			{
+				demonHandle = map->SpawnDemon()->m_handle;
+			}
+		}
+
+		g_game->m_simulationClock->Step(tickSeconds);
+		g_game->UpdateHeadless();
+
+		tick += 1;
+
+		if(tick % reportInterval == 0)
+		{
+			double reportEndTime = GetCurrentTimeSeconds();
+
+			DebuggerPrintf("Headless: tick %d, %.0f ticks per second\n", tick, static_cast<double>(reportInterval) / (reportEndTime - reportStartTime));
+
+			reportStartTime = reportEndTime;
+		}
+	}
+
+	HeadlessRunStats runStats;
+	runStats.m_numTicks	 = tick;
+	runStats.m_seconds	 = GetCurrentTimeSeconds() - runStartTime;
+	runStats.m_stateHash = (g_game->m_currentMap) ? g_game->m_currentMap->GetStateHash() : 0;
+
+	double simulatedSeconds = static_cast<double>(tick) * tickSeconds;
+
+	DebuggerPrintf("Headless: %d ticks in %.2f s, %.0f ticks per second, %.1fx real time\n", tick, runStats.m_seconds, static_cast<double>(tick) / runStats.m_seconds, simulatedSeconds / runStats.m_seconds);
+
+	return runStats;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Plays a recorded match back as fast as the machine allows, checking the map's state hash against the recording at
+// every checkpoint. Nothing is spawned on top of what was recorded, so a replay loads the machine the same way each run.
+HeadlessRunStats App::RunReplay(std::string const& replayFilePath)
+{
+	HeadlessRunStats runStats;
+	ReplayPlayer	 replayPlayer;
+
+	if(!replayPlayer.Load(replayFilePath))
+	{
+		DebuggerPrintf("Replay: could not load \"%s\"\n", replayFilePath.c_str());
+		return runStats;
+	}
+
+	Replay const& replay = replayPlayer.GetReplay();
+
+	DebuggerPrintf("Replay: %s, %s, %d players, %d ticks, seed %u, on %d threads\n", replayFilePath.c_str(), replay.m_mapName.c_str(), replay.GetNumPlayers(), replay.GetNumTicks(), replay.m_seed, g_jobSystem->GetNumThreads());
+
+	replayPlayer.Start(*g_game);
+
+	double runStartTime = GetCurrentTimeSeconds();
+
+	while(!m_isQuitting && replayPlayer.StepTick(*g_game))
+	{
+	}
+
+	runStats.m_numTicks	 = replayPlayer.GetNumTicksPlayed();
+	runStats.m_seconds	 = GetCurrentTimeSeconds() - runStartTime;
+	runStats.m_stateHash = (g_game->m_currentMap) ? g_game->m_currentMap->GetStateHash() : 0;
+
+	DebuggerPrintf("Replay: %d of %d ticks in %.2f s, %.0f ticks per second\n", runStats.m_numTicks, replay.GetNumTicks(), runStats.m_seconds, static_cast<double>(runStats.m_numTicks) / runStats.m_seconds);
+
+	if(replayPlayer.GetNumCheckpointMismatches() == 0)
+	{
+		DebuggerPrintf("Replay: all %d checkpoints match the recording\n", replayPlayer.GetNumCheckpointsChecked());
+	}
+	else
+	{
+		DebuggerPrintf("Replay: %d of %d checkpoints differ from the recording, first at tick %d\n", replayPlayer.GetNumCheckpointMismatches(), replayPlayer.GetNumCheckpointsChecked(), replayPlayer.GetFirstMismatchTick());
+	}
+
+	return runStats;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool App::isQuitting() const
 {
@@ -266,6 +553,12 @@ bool App::isQuitting() const
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool App::IsHeadless() const
+{
+	return m_isHeadless;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void App::RequestQuit()
 {
@@ -3,10 +3,20 @@
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Renderer/Camera.hpp"
 
+#include <string>
+
 //------------------------------------------------------------------------------------------------------------------
 class NamedStrings;
 typedef NamedStrings EventArgs;
 
+//------------------------------------------------------------------------------------------------------------------
+struct HeadlessRunStats
+{
+	int				m_numTicks	= 0;
+	double			m_seconds	= 0.0;
+	unsigned int	m_stateHash	= 0;
+};
+
 //------------------------------------------------------------------------------------------------------------------
 class App
 {
@@ -16,7 +26,7 @@ public:
 	App();
 	~App();
 	
-	void Startup();
+	void Startup(char const* commandLine = "");
 	void Shutdown();
 	void RunFrame();
 
@@ -28,6 +38,7 @@ public:
 	
 	void LoadConfigFile(char const* configFilePath);
 	bool isQuitting() const;
+	bool IsHeadless() const;
 
 private:
 
@@ -36,8 +47,16 @@ private:
 	void Render() const;
 	void EndFrame();
 
+	void ApplyCommandLine(char const* commandLine);
+	void StartupHeadless();
+	void ShutdownHeadless();
+	void RunHeadless();
+	HeadlessRunStats RunHeadlessMatch();
+	HeadlessRunStats RunReplay(std::string const& replayFilePath);
+
 private:
 
 	bool m_isQuitting = false;
+	bool m_isHeadless = false;
 
 };
\ No newline at end of file
@@ -0,0 +1,444 @@
+#include "Game/CylinderBatch.hpp"
+
+#include "Engine/Math/RaycastUtils.hpp"
+
+#include <math.h>
+
+#if defined(__AVX2__)
+	#define CYLINDER_BATCH_AVX2
+	#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+	#define CYLINDER_BATCH_SSE
+	#include <emmintrin.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static float const s_noHitDistance = 3.0e38f;
+static float const s_parallelEpsilon = 0.000001f;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Everything about the ray that does not depend on the cylinder, computed once per query and broadcast to every lane.
+// The side test solves |start.xy + fwd.xy * t - center|^2 = radius^2 for the entry point; the cap test only looks at the
+// cap the ray is heading toward, the top one when it points down and the bottom one when it points up.
+struct CylinderRay
+{
+	float m_startX			  = 0.f;
+	float m_startY			  = 0.f;
+	float m_startZ			  = 0.f;
+	float m_fwdX			  = 0.f;
+	float m_fwdY			  = 0.f;
+	float m_fwdZ			  = 0.f;
+	float m_distance		  = 0.f;
+	float m_lengthSquaredXY	  = 0.f;
+	float m_invLengthSquaredXY = 0.f;
+	float m_invFwdZ			  = 0.f;
+	bool  m_canHitSide		  = false;
+	bool  m_canHitCap		  = false;
+	bool  m_capIsTop		  = false;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static CylinderRay MakeCylinderRay(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance)
+{
+	CylinderRay ray;
+	ray.m_startX	= startPosition.x;
+	ray.m_startY	= startPosition.y;
+	ray.m_startZ	= startPosition.z;
+	ray.m_fwdX		= fwdNormal.x;
+	ray.m_fwdY		= fwdNormal.y;
+	ray.m_fwdZ		= fwdNormal.z;
+	ray.m_distance	= distance;
+
+	ray.m_lengthSquaredXY = fwdNormal.x * fwdNormal.x + fwdNormal.y * fwdNormal.y;
+	ray.m_canHitSide	  = ray.m_lengthSquaredXY > s_parallelEpsilon;
+	ray.m_invLengthSquaredXY = ray.m_canHitSide ? 1.f / ray.m_lengthSquaredXY : 0.f;
+
+	ray.m_canHitCap = fabsf(fwdNormal.z) > s_parallelEpsilon;
+	ray.m_invFwdZ	= ray.m_canHitCap ? 1.f / fwdNormal.z : 0.f;
+	ray.m_capIsTop	= fwdNormal.z < 0.f;
+
+	return ray;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void CylinderBatch::Clear()
+{
+	m_count = 0;
+	m_centerX.clear();
+	m_centerY.clear();
+	m_minZ.clear();
+	m_maxZ.clear();
+	m_radius.clear();
+	m_userIndexes.clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void CylinderBatch::AddCylinder(Vec3 const& bottomCenter, float height, float radius, int userIndex)
+{
+	if(m_count == static_cast<int>(m_centerX.size()))
+	{
+		m_centerX.resize(m_count + CYLINDER_BATCH_PADDING, 0.f);
+		m_centerY.resize(m_count + CYLINDER_BATCH_PADDING, 0.f);
+		m_minZ.resize(m_count + CYLINDER_BATCH_PADDING, 0.f);
+		m_maxZ.resize(m_count + CYLINDER_BATCH_PADDING, 0.f);
+		m_radius.resize(m_count + CYLINDER_BATCH_PADDING, 0.f);
+	}
+
+	m_centerX[m_count] = bottomCenter.x;
+	m_centerY[m_count] = bottomCenter.y;
+	m_minZ[m_count]	   = bottomCenter.z;
+	m_maxZ[m_count]	   = bottomCenter.z + height;
+	m_radius[m_count]  = radius;
+	m_userIndexes.push_back(userIndex);
+
+	m_count += 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int CylinderBatch::GetCount() const
+{
+	return m_count;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int CylinderBatch::GetUserIndex(int cylinderIndex) const
+{
+	return m_userIndexes[cylinderIndex];
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+char const* CylinderBatch::GetKernelName()
+{
+#if defined(CYLINDER_BATCH_AVX2)
+	return "AVX2";
+#elif defined(CYLINDER_BATCH_SSE)
+	return "SSE";
+#else
+	return "scalar";
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int CylinderBatch::RaycastNearestScalar(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, RaycastResult3D& out_result) const
+{
+	CylinderRay ray = MakeCylinderRay(startPosition, fwdNormal, distance);
+
+	int nearestIndex = -1;
+	float nearestDistance = s_noHitDistance;
+
+	for(int cylinderIndex = 0; cylinderIndex < m_count; ++cylinderIndex)
+	{
+		float impactDistance = GetImpactDistanceScalar(cylinderIndex, ray);
+
+		if(impactDistance < nearestDistance)
+		{
+			nearestDistance = impactDistance;
+			nearestIndex = cylinderIndex;
+		}
+	}
+
+	if(nearestIndex >= 0)
+	{
+		FillResult(nearestIndex, startPosition, fwdNormal, distance, nearestDistance, out_result);
+	}
+
+	return nearestIndex;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+float CylinderBatch::GetImpactDistanceScalar(int cylinderIndex, CylinderRay const& ray) const
+{
+	float toStartX = ray.m_startX - m_centerX[cylinderIndex];
+	float toStartY = ray.m_startY - m_centerY[cylinderIndex];
+	float minZ = m_minZ[cylinderIndex];
+	float maxZ = m_maxZ[cylinderIndex];
+	float radiusSquared = m_radius[cylinderIndex] * m_radius[cylinderIndex];
+
+	float startOffsetSquared = toStartX * toStartX + toStartY * toStartY - radiusSquared;
+
+	if(startOffsetSquared <= 0.f && ray.m_startZ >= minZ && ray.m_startZ <= maxZ)
+	{
+		return 0.f;
+	}
+
+	float impactDistance = s_noHitDistance;
+
+	if(ray.m_canHitSide)
+	{
+		float halfB = toStartX * ray.m_fwdX + toStartY * ray.m_fwdY;
+		float discriminant = halfB * halfB - ray.m_lengthSquaredXY * startOffsetSquared;
+
+		if(discriminant >= 0.f)
+		{
+			float t = (-halfB - sqrtf(discriminant)) * ray.m_invLengthSquaredXY;
+			float z = ray.m_startZ + ray.m_fwdZ * t;
+
+			if(t >= 0.f && t <= ray.m_distance && z >= minZ && z <= maxZ)
+			{
+				impactDistance = t;
+			}
+		}
+	}
+
+	if(ray.m_canHitCap)
+	{
+		float capZ = ray.m_capIsTop ? maxZ : minZ;
+		float t = (capZ - ray.m_startZ) * ray.m_invFwdZ;
+		float capX = toStartX + ray.m_fwdX * t;
+		float capY = toStartY + ray.m_fwdY * t;
+
+		if(t >= 0.f && t <= ray.m_distance && capX * capX + capY * capY <= radiusSquared && t < impactDistance)
+		{
+			impactDistance = t;
+		}
+	}
+
+	return impactDistance;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void CylinderBatch::FillResult(int cylinderIndex, Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, float impactDistance, RaycastResult3D& out_result) const
+{
+	out_result.m_didImpact		  = true;
+	out_result.m_impactDistance	  = impactDistance;
+	out_result.m_impactPos		  = startPosition + fwdNormal * impactDistance;
+	out_result.m_rayStartPos	  = startPosition;
+	out_result.m_rayForwardNormal = fwdNormal;
+	out_result.m_rayMaxLength	  = distance;
+
+	float capTolerance = 0.0001f;
+
+	if(impactDistance <= 0.f)
+	{
+		out_result.m_impactNormal = -fwdNormal;
+	}
+	else if(fwdNormal.z < 0.f && fabsf(out_result.m_impactPos.z - m_maxZ[cylinderIndex]) < capTolerance)
+	{
+		out_result.m_impactNormal = Vec3(0.f, 0.f, 1.f);
+	}
+	else if(fwdNormal.z > 0.f && fabsf(out_result.m_impactPos.z - m_minZ[cylinderIndex]) < capTolerance)
+	{
+		out_result.m_impactNormal = Vec3(0.f, 0.f, -1.f);
+	}
+	else
+	{
+		out_result.m_impactNormal = Vec3(out_result.m_impactPos.x - m_centerX[cylinderIndex], out_result.m_impactPos.y - m_centerY[cylinderIndex], 0.f).GetNormalized();
+	}
+}
+
+#if defined(CYLINDER_BATCH_AVX2)
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Same math as GetImpactDistanceScalar, eight cylinders per iteration. Each lane keeps its own nearest hit with a strict
+// less-than, so it holds the lowest index among its ties, and the final reduction breaks ties on index too.
+int CylinderBatch::RaycastNearest(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, RaycastResult3D& out_result) const
+{
+	CylinderRay ray = MakeCylinderRay(startPosition, fwdNormal, distance);
+
+	__m256 startX		 = _mm256_set1_ps(ray.m_startX);
+	__m256 startY		 = _mm256_set1_ps(ray.m_startY);
+	__m256 startZ		 = _mm256_set1_ps(ray.m_startZ);
+	__m256 fwdX			 = _mm256_set1_ps(ray.m_fwdX);
+	__m256 fwdY			 = _mm256_set1_ps(ray.m_fwdY);
+	__m256 fwdZ			 = _mm256_set1_ps(ray.m_fwdZ);
+	__m256 maxT			 = _mm256_set1_ps(ray.m_distance);
+	__m256 lengthSqXY	 = _mm256_set1_ps(ray.m_lengthSquaredXY);
+	__m256 invLengthSqXY = _mm256_set1_ps(ray.m_invLengthSquaredXY);
+	__m256 invFwdZ		 = _mm256_set1_ps(ray.m_invFwdZ);
+	__m256 canHitSide	 = _mm256_castsi256_ps(_mm256_set1_epi32(ray.m_canHitSide ? -1 : 0));
+	__m256 canHitCap	 = _mm256_castsi256_ps(_mm256_set1_epi32(ray.m_canHitCap ? -1 : 0));
+	__m256 zero			 = _mm256_setzero_ps();
+	__m256 noHit		 = _mm256_set1_ps(s_noHitDistance);
+
+	__m256	nearestDistances = noHit;
+	__m256i nearestIndexes	 = _mm256_set1_epi32(-1);
+	__m256i laneIndexes		 = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i count			 = _mm256_set1_epi32(m_count);
+	__m256i laneStep		 = _mm256_set1_epi32(8);
+
+	for(int groupStart = 0; groupStart < m_count; groupStart += 8)
+	{
+		__m256 toStartX = _mm256_sub_ps(startX, _mm256_loadu_ps(&m_centerX[groupStart]));
+		__m256 toStartY = _mm256_sub_ps(startY, _mm256_loadu_ps(&m_centerY[groupStart]));
+		__m256 minZ		= _mm256_loadu_ps(&m_minZ[groupStart]);
+		__m256 maxZ		= _mm256_loadu_ps(&m_maxZ[groupStart]);
+		__m256 radius	= _mm256_loadu_ps(&m_radius[groupStart]);
+		__m256 radiusSq = _mm256_mul_ps(radius, radius);
+
+		__m256 startOffsetSq = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(toStartX, toStartX), _mm256_mul_ps(toStartY, toStartY)), radiusSq);
+		__m256 startInZRange = _mm256_and_ps(_mm256_cmp_ps(startZ, minZ, _CMP_GE_OQ), _mm256_cmp_ps(startZ, maxZ, _CMP_LE_OQ));
+		__m256 isInside		 = _mm256_and_ps(_mm256_cmp_ps(startOffsetSq, zero, _CMP_LE_OQ), startInZRange);
+
+		// side
+		__m256 halfB = _mm256_add_ps(_mm256_mul_ps(toStartX, fwdX), _mm256_mul_ps(toStartY, fwdY));
+		__m256 discriminant = _mm256_sub_ps(_mm256_mul_ps(halfB, halfB), _mm256_mul_ps(lengthSqXY, startOffsetSq));
+		__m256 sideT = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(zero, halfB), _mm256_sqrt_ps(_mm256_max_ps(discriminant, zero))), invLengthSqXY);
+		__m256 sideZ = _mm256_add_ps(startZ, _mm256_mul_ps(fwdZ, sideT));
+
+		__m256 sideHit = _mm256_and_ps(canHitSide, _mm256_cmp_ps(discriminant, zero, _CMP_GE_OQ));
+		sideHit = _mm256_and_ps(sideHit, _mm256_and_ps(_mm256_cmp_ps(sideT, zero, _CMP_GE_OQ), _mm256_cmp_ps(sideT, maxT, _CMP_LE_OQ)));
+		sideHit = _mm256_and_ps(sideHit, _mm256_and_ps(_mm256_cmp_ps(sideZ, minZ, _CMP_GE_OQ), _mm256_cmp_ps(sideZ, maxZ, _CMP_LE_OQ)));
+
+		// cap
+		__m256 capZ = ray.m_capIsTop ? maxZ : minZ;
+		__m256 capT = _mm256_mul_ps(_mm256_sub_ps(capZ, startZ), invFwdZ);
+		__m256 capX = _mm256_add_ps(toStartX, _mm256_mul_ps(fwdX, capT));
+		__m256 capY = _mm256_add_ps(toStartY, _mm256_mul_ps(fwdY, capT));
+
+		__m256 capHit = _mm256_and_ps(canHitCap, _mm256_and_ps(_mm256_cmp_ps(capT, zero, _CMP_GE_OQ), _mm256_cmp_ps(capT, maxT, _CMP_LE_OQ)));
+		capHit = _mm256_and_ps(capHit, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(capX, capX), _mm256_mul_ps(capY, capY)), radiusSq, _CMP_LE_OQ));
+
+		__m256 impactT = _mm256_blendv_ps(noHit, sideT, sideHit);
+		impactT = _mm256_blendv_ps(impactT, _mm256_min_ps(impactT, capT), capHit);
+		impactT = _mm256_blendv_ps(impactT, zero, isInside);
+
+		__m256 isValidLane = _mm256_castsi256_ps(_mm256_cmpgt_epi32(count, laneIndexes));
+		__m256 isNearer = _mm256_and_ps(isValidLane, _mm256_cmp_ps(impactT, nearestDistances, _CMP_LT_OQ));
+
+		nearestDistances = _mm256_blendv_ps(nearestDistances, impactT, isNearer);
+		nearestIndexes = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(nearestIndexes), _mm256_castsi256_ps(laneIndexes), isNearer));
+
+		laneIndexes = _mm256_add_epi32(laneIndexes, laneStep);
+	}
+
+	float laneDistances[8];
+	int laneNearestIndexes[8];
+	_mm256_storeu_ps(laneDistances, nearestDistances);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(laneNearestIndexes), nearestIndexes);
+
+	int nearestIndex = -1;
+	float nearestDistance = s_noHitDistance;
+
+	for(int lane = 0; lane < 8; ++lane)
+	{
+		bool isNearer = laneDistances[lane] < nearestDistance || (laneDistances[lane] == nearestDistance && laneNearestIndexes[lane] < nearestIndex);
+
+		if(laneNearestIndexes[lane] >= 0 && isNearer)
+		{
+			nearestDistance = laneDistances[lane];
+			nearestIndex = laneNearestIndexes[lane];
+		}
+	}
+
+	if(nearestIndex >= 0)
+	{
+		FillResult(nearestIndex, startPosition, fwdNormal, distance, nearestDistance, out_result);
+	}
+
+	return nearestIndex;
+}
+
+#elif defined(CYLINDER_BATCH_SSE)
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Same math as GetImpactDistanceScalar, four cylinders per iteration. Each lane keeps its own nearest hit with a strict
+// less-than, so it holds the lowest index among its ties, and the final reduction breaks ties on index too.
+// Only SSE2 is used, so selects are and/andnot/or instead of blendv.
+static __m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+{
+	return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int CylinderBatch::RaycastNearest(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, RaycastResult3D& out_result) const
+{
+	CylinderRay ray = MakeCylinderRay(startPosition, fwdNormal, distance);
+
+	__m128 startX		 = _mm_set1_ps(ray.m_startX);
+	__m128 startY		 = _mm_set1_ps(ray.m_startY);
+	__m128 startZ		 = _mm_set1_ps(ray.m_startZ);
+	__m128 fwdX			 = _mm_set1_ps(ray.m_fwdX);
+	__m128 fwdY			 = _mm_set1_ps(ray.m_fwdY);
+	__m128 fwdZ			 = _mm_set1_ps(ray.m_fwdZ);
+	__m128 maxT			 = _mm_set1_ps(ray.m_distance);
+	__m128 lengthSqXY	 = _mm_set1_ps(ray.m_lengthSquaredXY);
+	__m128 invLengthSqXY = _mm_set1_ps(ray.m_invLengthSquaredXY);
+	__m128 invFwdZ		 = _mm_set1_ps(ray.m_invFwdZ);
+	__m128 canHitSide	 = _mm_castsi128_ps(_mm_set1_epi32(ray.m_canHitSide ? -1 : 0));
+	__m128 canHitCap	 = _mm_castsi128_ps(_mm_set1_epi32(ray.m_canHitCap ? -1 : 0));
+	__m128 zero			 = _mm_setzero_ps();
+	__m128 noHit		 = _mm_set1_ps(s_noHitDistance);
+
+	__m128	nearestDistances = noHit;
+	__m128i nearestIndexes	 = _mm_set1_epi32(-1);
+	__m128i laneIndexes		 = _mm_setr_epi32(0, 1, 2, 3);
+	__m128i count			 = _mm_set1_epi32(m_count);
+	__m128i laneStep		 = _mm_set1_epi32(4);
+
+	for(int groupStart = 0; groupStart < m_count; groupStart += 4)
+	{
+		__m128 toStartX = _mm_sub_ps(startX, _mm_loadu_ps(&m_centerX[groupStart]));
+		__m128 toStartY = _mm_sub_ps(startY, _mm_loadu_ps(&m_centerY[groupStart]));
+		__m128 minZ		= _mm_loadu_ps(&m_minZ[groupStart]);
+		__m128 maxZ		= _mm_loadu_ps(&m_maxZ[groupStart]);
+		__m128 radius	= _mm_loadu_ps(&m_radius[groupStart]);
+		__m128 radiusSq = _mm_mul_ps(radius, radius);
+
+		__m128 startOffsetSq = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(toStartX, toStartX), _mm_mul_ps(toStartY, toStartY)), radiusSq);
+		__m128 startInZRange = _mm_and_ps(_mm_cmpge_ps(startZ, minZ), _mm_cmple_ps(startZ, maxZ));
+		__m128 isInside		 = _mm_and_ps(_mm_cmple_ps(startOffsetSq, zero), startInZRange);
+
+		// side
+		__m128 halfB = _mm_add_ps(_mm_mul_ps(toStartX, fwdX), _mm_mul_ps(toStartY, fwdY));
+		__m128 discriminant = _mm_sub_ps(_mm_mul_ps(halfB, halfB), _mm_mul_ps(lengthSqXY, startOffsetSq));
+		__m128 sideT = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(zero, halfB), _mm_sqrt_ps(_mm_max_ps(discriminant, zero))), invLengthSqXY);
+		__m128 sideZ = _mm_add_ps(startZ, _mm_mul_ps(fwdZ, sideT));
+
+		__m128 sideHit = _mm_and_ps(canHitSide, _mm_cmpge_ps(discriminant, zero));
+		sideHit = _mm_and_ps(sideHit, _mm_and_ps(_mm_cmpge_ps(sideT, zero), _mm_cmple_ps(sideT, maxT)));
+		sideHit = _mm_and_ps(sideHit, _mm_and_ps(_mm_cmpge_ps(sideZ, minZ), _mm_cmple_ps(sideZ, maxZ)));
+
+		// cap
+		__m128 capZ = ray.m_capIsTop ? maxZ : minZ;
+		__m128 capT = _mm_mul_ps(_mm_sub_ps(capZ, startZ), invFwdZ);
+		__m128 capX = _mm_add_ps(toStartX, _mm_mul_ps(fwdX, capT));
+		__m128 capY = _mm_add_ps(toStartY, _mm_mul_ps(fwdY, capT));
+
+		__m128 capHit = _mm_and_ps(canHitCap, _mm_and_ps(_mm_cmpge_ps(capT, zero), _mm_cmple_ps(capT, maxT)));
+		capHit = _mm_and_ps(capHit, _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(capX, capX), _mm_mul_ps(capY, capY)), radiusSq));
+
+		__m128 impactT = Select(sideHit, sideT, noHit);
+		impactT = Select(capHit, _mm_min_ps(impactT, capT), impactT);
+		impactT = Select(isInside, zero, impactT);
+
+		__m128 isValidLane = _mm_castsi128_ps(_mm_cmpgt_epi32(count, laneIndexes));
+		__m128 isNearer = _mm_and_ps(isValidLane, _mm_cmplt_ps(impactT, nearestDistances));
+
+		nearestDistances = Select(isNearer, impactT, nearestDistances);
+		nearestIndexes = _mm_castps_si128(Select(isNearer, _mm_castsi128_ps(laneIndexes), _mm_castsi128_ps(nearestIndexes)));
+
+		laneIndexes = _mm_add_epi32(laneIndexes, laneStep);
+	}
+
+	float laneDistances[4];
+	int laneNearestIndexes[4];
+	_mm_storeu_ps(laneDistances, nearestDistances);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(laneNearestIndexes), nearestIndexes);
+
+	int nearestIndex = -1;
+	float nearestDistance = s_noHitDistance;
+
+	for(int lane = 0; lane < 4; ++lane)
+	{
+		bool isNearer = laneDistances[lane] < nearestDistance || (laneDistances[lane] == nearestDistance && laneNearestIndexes[lane] < nearestIndex);
+
+		if(laneNearestIndexes[lane] >= 0 && isNearer)
+		{
+			nearestDistance = laneDistances[lane];
+			nearestIndex = laneNearestIndexes[lane];
+		}
+	}
+
+	if(nearestIndex >= 0)
+	{
+		FillResult(nearestIndex, startPosition, fwdNormal, distance, nearestDistance, out_result);
+	}
+
+	return nearestIndex;
+}
+
+#else
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int CylinderBatch::RaycastNearest(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, RaycastResult3D& out_result) const
+{
+	return RaycastNearestScalar(startPosition, fwdNormal, distance, out_result);
+}
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Engine/Math/Vec3.hpp"
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+struct RaycastResult3D;
+struct CylinderRay;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Arrays are padded to a multiple of the widest SIMD kernel so its last group can always be loaded in one go
+constexpr int CYLINDER_BATCH_PADDING = 8;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Vertical cylinders packed as structure-of-arrays so a ray can be tested against several of them per instruction.
+// The ray kernel is AVX2 (8 lanes) when the game is built with /arch:AVX2, SSE (4 lanes) on any other x64 build and
+// plain scalar code everywhere else. All three return the same cylinder: the nearest hit, lowest index on ties.
+// Padding lanes are masked off by the count, never by their contents.
+class CylinderBatch
+{
+public:
+
+	CylinderBatch() = default;
+	~CylinderBatch() = default;
+
+	void	Clear();
+	void	AddCylinder(Vec3 const& bottomCenter, float height, float radius, int userIndex);
+
+	int		GetCount() const;
+	int		GetUserIndex(int cylinderIndex) const;
+
+	// Both return the index of the nearest cylinder hit within distance, or -1, and fill out_result for that hit
+	int		RaycastNearest(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, RaycastResult3D& out_result) const;
+	int		RaycastNearestScalar(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, RaycastResult3D& out_result) const;
+
+	static char const* GetKernelName();
+
+private:
+
+	float	GetImpactDistanceScalar(int cylinderIndex, CylinderRay const& ray) const;
+	void	FillResult(int cylinderIndex, Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, float impactDistance, RaycastResult3D& out_result) const;
+
+private:
+
+	int					m_count = 0;
+	std::vector<float>	m_centerX;
+	std::vector<float>	m_centerY;
+	std::vector<float>	m_minZ;
+	std::vector<float>	m_maxZ;
+	std::vector<float>	m_radius;
+	std::vector<int>	m_userIndexes;
+};
@@ -0,0 +1,163 @@
+#include "Game/FlowField.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static IntVec2 const s_neighborOffsets[8] =
+{
+	IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1),
+	IntVec2(1, 1), IntVec2(1, -1), IntVec2(-1, 1), IntVec2(-1, -1)
+};
+
+static float const s_neighborCosts[8] = { 1.f, 1.f, 1.f, 1.f, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void FlowField::Initialize(std::vector<TileFlags> const& tileFlags, IntVec2 const& dimensions)
+{
+	m_dimensions = dimensions;
+	m_goalTile	 = IntVec2(-1, -1);
+
+	int numTiles = dimensions.x * dimensions.y;
+
+	m_isOpen.assign(numTiles, 0);
+	m_distances.assign(numTiles, UNREACHABLE_DISTANCE);
+	m_nextTileIndexes.assign(numTiles, -1);
+
+	for(int tileIndex = 0; tileIndex < numTiles; ++tileIndex)
+	{
+		m_isOpen[tileIndex] = (tileFlags[tileIndex] & TILE_FLAG_SOLID) ? 0 : 1;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Rebuilds the field from scratch; the map is small enough that a full Dijkstra on goal change costs well under a
+// millisecond, and it only runs when the goal moves to a different tile
+void FlowField::SetGoalTile(IntVec2 const& goalTile)
+{
+	m_goalTile = goalTile;
+
+	std::fill(m_distances.begin(), m_distances.end(), UNREACHABLE_DISTANCE);
+	std::fill(m_nextTileIndexes.begin(), m_nextTileIndexes.end(), -1);
+
+	if(!IsTileOpen(goalTile.x, goalTile.y))
+	{
+		return;
+	}
+
+	typedef std::pair<float, int> DistanceAndTile;
+	std::priority_queue<DistanceAndTile, std::vector<DistanceAndTile>, std::greater<DistanceAndTile>> openTiles;
+
+	int goalIndex = (goalTile.y * m_dimensions.x) + goalTile.x;
+	m_distances[goalIndex] = 0.f;
+	m_nextTileIndexes[goalIndex] = goalIndex;
+	openTiles.push(DistanceAndTile(0.f, goalIndex));
+
+	while(!openTiles.empty())
+	{
+		DistanceAndTile current = openTiles.top();
+		openTiles.pop();
+
+		int tileIndex = current.second;
+
+		if(current.first > m_distances[tileIndex])
+		{
+			continue;
+		}
+
+		int tileX = tileIndex % m_dimensions.x;
+		int tileY = tileIndex / m_dimensions.x;
+
+		for(int neighborIndex = 0; neighborIndex < 8; ++neighborIndex)
+		{
+			IntVec2 const& offset = s_neighborOffsets[neighborIndex];
+
+			int neighborX = tileX + offset.x;
+			int neighborY = tileY + offset.y;
+
+			if(!IsTileOpen(neighborX, neighborY))
+			{
+				continue;
+			}
+
+			if(offset.x != 0 && offset.y != 0 && (!IsTileOpen(tileX + offset.x, tileY) || !IsTileOpen(tileX, tileY + offset.y)))
+			{
+				continue;
+			}
+
+			int neighborTileIndex = (neighborY * m_dimensions.x) + neighborX;
+			float neighborDistance = current.first + s_neighborCosts[neighborIndex];
+
+			if(neighborDistance < m_distances[neighborTileIndex])
+			{
+				m_distances[neighborTileIndex] = neighborDistance;
+				m_nextTileIndexes[neighborTileIndex] = tileIndex;
+				openTiles.push(DistanceAndTile(neighborDistance, neighborTileIndex));
+			}
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+IntVec2 FlowField::GetGoalTile() const
+{
+	return m_goalTile;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool FlowField::HasPathFromPosition(Vec2 const& position) const
+{
+	int tileIndex = GetTileIndexForPosition(position);
+
+	return tileIndex >= 0 && m_nextTileIndexes[tileIndex] >= 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+float FlowField::GetDistanceAtPosition(Vec2 const& position) const
+{
+	int tileIndex = GetTileIndexForPosition(position);
+
+	return (tileIndex >= 0) ? m_distances[tileIndex] : UNREACHABLE_DISTANCE;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Center of the next tile along the path; the goal tile and tiles with no path return the position itself
+Vec2 FlowField::GetWaypointForPosition(Vec2 const& position) const
+{
+	int tileIndex = GetTileIndexForPosition(position);
+
+	if(tileIndex < 0 || m_nextTileIndexes[tileIndex] < 0 || m_nextTileIndexes[tileIndex] == tileIndex)
+	{
+		return position;
+	}
+
+	int nextTileIndex = m_nextTileIndexes[tileIndex];
+
+	return Vec2(static_cast<float>(nextTileIndex % m_dimensions.x) + 0.5f, static_cast<float>(nextTileIndex / m_dimensions.x) + 0.5f);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int FlowField::GetTileIndexForPosition(Vec2 const& position) const
+{
+	int tileX = static_cast<int>(position.x);
+	int tileY = static_cast<int>(position.y);
+
+	if(position.x < 0.f || position.y < 0.f || tileX >= m_dimensions.x || tileY >= m_dimensions.y)
+	{
+		return -1;
+	}
+
+	return (tileY * m_dimensions.x) + tileX;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool FlowField::IsTileOpen(int tileX, int tileY) const
+{
+	if(tileX < 0 || tileY < 0 || tileX >= m_dimensions.x || tileY >= m_dimensions.y)
+	{
+		return false;
+	}
+
+	return m_isOpen[(tileY * m_dimensions.x) + tileX] != 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include "Game/Tile.hpp"
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dijkstra distance field over the map's open tiles toward one goal tile. Each open tile stores the neighbour one step
+// closer to the goal, so any number of actors chasing the same goal can read their next waypoint in O(1).
+// Moves are 8-way, but diagonals are only allowed when both orthogonal tiles are open so paths never clip a wall corner.
+class FlowField
+{
+public:
+
+	FlowField() = default;
+	~FlowField() = default;
+
+	void	Initialize(std::vector<TileFlags> const& tileFlags, IntVec2 const& dimensions);
+	void	SetGoalTile(IntVec2 const& goalTile);
+
+	IntVec2 GetGoalTile() const;
+	bool	HasPathFromPosition(Vec2 const& position) const;
+	float	GetDistanceAtPosition(Vec2 const& position) const;
+	Vec2	GetWaypointForPosition(Vec2 const& position) const;
+
+public:
+
+	static constexpr float UNREACHABLE_DISTANCE = 1e30f;
+
+private:
+
+	int		GetTileIndexForPosition(Vec2 const& position) const;
+	bool	IsTileOpen(int tileX, int tileY) const;
+
+private:
+
+	IntVec2						m_dimensions;
+	IntVec2						m_goalTile = IntVec2(-1, -1);
+	std::vector<unsigned char>	m_isOpen;
+	std::vector<float>			m_distances;
+	std::vector<int>			m_nextTileIndexes;
+};
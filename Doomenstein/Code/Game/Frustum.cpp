@@ -0,0 +1,73 @@
+#include "Game/Frustum.hpp"
+
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Camera.hpp"
+
+#include <math.h>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Clip space is x and y in [-w, w] and z in [0, w], so each plane is a sum or difference of the matrix rows
+Frustum::Frustum(Mat44 const& worldToClip)
+{
+	float const* values = worldToClip.m_values;
+
+	Vec4 rowX = Vec4(values[Mat44::Ix], values[Mat44::Jx], values[Mat44::Kx], values[Mat44::Tx]);
+	Vec4 rowY = Vec4(values[Mat44::Iy], values[Mat44::Jy], values[Mat44::Ky], values[Mat44::Ty]);
+	Vec4 rowZ = Vec4(values[Mat44::Iz], values[Mat44::Jz], values[Mat44::Kz], values[Mat44::Tz]);
+	Vec4 rowW = Vec4(values[Mat44::Iw], values[Mat44::Jw], values[Mat44::Kw], values[Mat44::Tw]);
+
+	m_planes[0] = rowW + rowX;
+	m_planes[1] = rowW - rowX;
+	m_planes[2] = rowW + rowY;
+	m_planes[3] = rowW - rowY;
+	m_planes[4] = rowZ;
+	m_planes[5] = rowW - rowZ;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+Frustum::Frustum(Camera const& camera)
+	: Frustum(camera.GetWorldToClipTransform())
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Conservative: a box is only rejected when its corner furthest along a plane's normal is still outside that plane
+bool Frustum::DoesOverlapAABB3(AABB3 const& bounds) const
+{
+	for(int planeIndex = 0; planeIndex < NUM_PLANES; ++planeIndex)
+	{
+		Vec4 const& plane = m_planes[planeIndex];
+
+		float furthestX = (plane.x >= 0.f) ? bounds.m_maxs.x : bounds.m_mins.x;
+		float furthestY = (plane.y >= 0.f) ? bounds.m_maxs.y : bounds.m_mins.y;
+		float furthestZ = (plane.z >= 0.f) ? bounds.m_maxs.z : bounds.m_mins.z;
+
+		if((plane.x * furthestX) + (plane.y * furthestY) + (plane.z * furthestZ) + plane.w < 0.f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The planes are not normalized, so the radius is scaled by each plane's normal length instead
+bool Frustum::DoesOverlapSphere(Vec3 const& center, float radius) const
+{
+	for(int planeIndex = 0; planeIndex < NUM_PLANES; ++planeIndex)
+	{
+		Vec4 const& plane = m_planes[planeIndex];
+
+		float normalLength = sqrtf((plane.x * plane.x) + (plane.y * plane.y) + (plane.z * plane.z));
+		float distance = (plane.x * center.x) + (plane.y * center.y) + (plane.z * center.z) + plane.w;
+
+		if(distance < -radius * normalLength)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Engine/Math/Vec4.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class Camera;
+
+struct AABB3;
+struct Mat44;
+struct Vec3;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The six clip planes of a camera in world space, pulled straight out of its world to clip matrix so it works for
+// perspective and orthographic cameras alike. Each plane is stored as (normal, distance) with the inside positive.
+class Frustum
+{
+public:
+
+	Frustum() = default;
+	~Frustum() = default;
+
+	explicit Frustum(Mat44 const& worldToClip);
+	explicit Frustum(Camera const& camera);
+
+	bool	DoesOverlapAABB3(AABB3 const& bounds) const;
+	bool	DoesOverlapSphere(Vec3 const& center, float radius) const;
+
+public:
+
+	static constexpr int NUM_PLANES = 6;
+
+private:
+
+	Vec4	m_planes[NUM_PLANES];
+};
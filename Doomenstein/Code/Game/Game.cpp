@@ -6,6 +6,8 @@
 #include "Game/Weapon.hpp"
 #include "Game/PlayerController.hpp"
 #include "Game/Map.hpp"
+#include "Game/SimulationClock.hpp"
+#include "Game/Replay.hpp"
 
 #include "Game/MapDefinition.hpp"
 #include "Game/TileDefinition.hpp"
@@ -16,9 +18,13 @@
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/Timer.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/DevConsole.hpp"
 
 #include "Engine/Renderer/ShadowMap.hpp"
 
+#include <cstdlib>
+
 //------------------------------------------------------------------------------------------------------------------
 Game* g_game = nullptr;
 RandomNumberGenerator g_numGenerator;
@@ -53,12 +59,7 @@ void Game::Startup()
 
 	AddVertsForAABB2D(m_overlayVerts, m_screenCamera.m_viewportBounds, Rgba8(0, 0, 0, 100));
 
-	TileDefinition::InitializeTileDefinition();
-	MapDefinition::InitializeMapDefinition();
-
-	ActorDefinition::InitializeProjectileActorDefinition();
-	WeaponDefinition::InitializeWeaponDefinition();
-	ActorDefinition::InitializeActorDefinition();
+	LoadDefinitions();
 
 	CreateAllSounds();
 // 
@@ -83,6 +84,54 @@ void Game::Startup()
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// No window, renderer or audio: loads the same definitions and goes straight into a match on the default map, with
+// game time advanced only by the caller through m_simulationClock
+void Game::StartupHeadless()
+{
+	m_simulationClock = new SimulationClock();
+	m_gameClock = m_simulationClock;
+
+	LoadDefinitions();
+
+	ChangeGameState(GameState::PLAYING);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Throws the current match away and starts a new one on a fresh clock, so every restart begins from the same game time
+void Game::RestartHeadless()
+{
+	ChangeGameState(GameState::ATTRACT);
+
+	delete m_simulationClock;
+	m_simulationClock = new SimulationClock();
+	m_gameClock = m_simulationClock;
+
+	ChangeGameState(GameState::PLAYING);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Restarts the way a recorded match started: the same players joined, the clock at the total it had when the recorded
+// map was created, and rand seeded right before the map is
+void Game::RestartHeadlessReplay(std::vector<int> const& controllerIDs, double startSeconds, unsigned int seed)
+{
+	ChangeGameState(GameState::ATTRACT);
+
+	delete m_simulationClock;
+	m_simulationClock = new SimulationClock();
+	m_gameClock = m_simulationClock;
+	m_simulationClock->Step(startSeconds);
+
+	for(int controllerID : controllerIDs)
+	{
+		m_playerControllers.push_back(new PlayerController(controllerID));
+	}
+
+	srand(seed);
+
+	ChangeGameState(GameState::PLAYING);
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Game::Shutdown()
 {
@@ -90,6 +139,15 @@ void Game::Shutdown()
 	UnsubscribeEventCallbackFunction("DebugDraw", Event_DebugRender);
 	UnsubscribeEventCallbackFunction("ShowGrid", Event_OnShowGrid);
 
+	StopReplayRecording();
+
+	if(m_simulationClock)
+	{
+		delete m_simulationClock;
+		m_simulationClock = nullptr;
+		m_gameClock = nullptr;
+	}
+
 	if(m_gameClock)
 	{
 		delete m_gameClock;
@@ -138,6 +196,11 @@ void Game::Update()
 		}
 
 		m_currentMap->Update();
+
+		if(m_replayRecorder)
+		{
+			m_replayRecorder->RecordTick(*this);
+		}
 	}
 
 	UpdateCameras();
@@ -163,6 +226,44 @@ void Game::Update()
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Same order as Update, minus everything that reads devices or draws. Player controllers only exist here when a
+// replay is being played, and then take their input from it.
+void Game::UpdateHeadless()
+{
+	if(static_cast<int>(m_currentGameState) < static_cast<int>(GameState::PLAYING))
+	{
+		return;
+	}
+
+	for(PlayerController* playerController : m_playerControllers)
+	{
+		if(playerController)
+		{
+			playerController->Update();
+		}
+	}
+
+	m_currentMap->Update();
+
+	if(m_currentMap->m_didLevelJustStart && m_currentGameState == GameState::PLAYING)
+	{
+		m_currentMap->m_didLevelJustStart = false;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Game::LoadDefinitions()
+{
+	TileDefinition::InitializeTileDefinition();
+	MapDefinition::InitializeMapDefinition();
+
+	ActorDefinition::InitializeProjectileActorDefinition();
+	WeaponDefinition::InitializeWeaponDefinition();
+	ActorDefinition::InitializeActorDefinition();
+	WeaponDefinition::ResolveActorDefinitionIDs();
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Game::AddScreenText()
 {
@@ -313,6 +414,8 @@ void Game::ChangeGameState(GameState gameState)
 	{
 		case GameState::ATTRACT:
 		{
+			StopReplayRecording();
+
 			if(m_currentMap)
 			{
 				delete m_currentMap;
@@ -346,7 +449,7 @@ void Game::ChangeGameState(GameState gameState)
 
 		case GameState::PLAYING:
 		{
-			for(int index = 0; index < static_cast<int>(m_playerControllers.size()); ++index)
+			for(int index = 0; index < static_cast<int>(m_playerControllers.size()) && g_theWindow; ++index)
 			{
 				int numPlayerControllers = static_cast<int>(m_playerControllers.size());
 
@@ -367,6 +470,7 @@ void Game::ChangeGameState(GameState gameState)
 			}
 
 			std::string defaultMap = g_gameConfigBlackboard.GetValue("defaultMap", "MPMap");
+			StartReplayRecording();
 			m_currentMap = new Map(this, defaultMap);
 
 			for(PlayerController* playerController : m_playerControllers)
@@ -552,7 +656,7 @@ void Game::RenderGame()
 
 		g_theRenderer->BeginRenderEvent("Depth Pass");
 		m_shadowMap->BeginDepthPass();
-		m_currentMap->RenderDepth();
+		m_currentMap->RenderDepth(m_shadowMap->m_camera);
 		m_shadowMap->EndDepthPass();
 		g_theRenderer->EndRenderEvent("Depth Pass");
 
@@ -631,6 +735,50 @@ void Game::SpawnPlayerController()
 	m_playerControllers.push_back(playerController);
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Seeds rand itself so the recording knows the seed the map and everything after it is built from. The AI think budget
+// is wall clock time, which playback could never match, so it is turned off for recorded matches.
+void Game::StartReplayRecording()
+{
+	StopReplayRecording();
+
+	std::string filePath = g_gameConfigBlackboard.GetValue("replayRecordFile", "");
+
+	if(filePath.empty() || g_theApp->IsHeadless())
+	{
+		return;
+	}
+
+	unsigned int seed = static_cast<unsigned int>(GetCurrentTimeSeconds() * 1000.0);
+	srand(seed);
+
+	g_gameConfigBlackboard.SetValue("aiThinkBudgetMicroseconds", "0");
+
+	m_replayRecorder = new ReplayRecorder(filePath);
+	m_replayRecorder->Start(*this, seed);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Game::StopReplayRecording()
+{
+	if(!m_replayRecorder)
+	{
+		return;
+	}
+
+	if(m_replayRecorder->Stop())
+	{
+		g_devConsole->AddLine(DevConsole::INFO_MAJOR, Stringf("Replay: %d ticks saved to %s", m_replayRecorder->GetNumTicks(), m_replayRecorder->GetFilePath().c_str()));
+	}
+	else
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, Stringf("Replay: could not write %s", m_replayRecorder->GetFilePath().c_str()));
+	}
+
+	delete m_replayRecorder;
+	m_replayRecorder = nullptr;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 int Game::GetNumPlayerControllers()
 {
@@ -11,9 +11,11 @@
 
 //------------------------------------------------------------------------------------------------------------------
 class Clock;
+class SimulationClock;
 class PlayerController;
 class Map;
 class ShadowMap;
+class ReplayRecorder;
 
 typedef size_t SoundID;
 typedef size_t SoundPlaybackID;
@@ -42,8 +44,12 @@ public:
 	~Game();
 
 	void Startup();
+	void StartupHeadless();
+	void RestartHeadless();
+	void RestartHeadlessReplay(std::vector<int> const& controllerIDs, double startSeconds, unsigned int seed);
 	void Shutdown();
 	void Update();
+	void UpdateHeadless();
 	void Render();
 	void ChangeGameState(GameState gameState);
 	GameState GetGameState() const;
@@ -52,6 +58,8 @@ public:
 
 private:
 	
+	void LoadDefinitions();
+
 	void UpdateCameras();
 
 	void AddScreenText();
@@ -65,6 +73,9 @@ private:
 	void RenderGame();
 
 	void SpawnPlayerController();
+
+	void StartReplayRecording();
+	void StopReplayRecording();
 	
 	void InitializeGridVerts(float size);
 
@@ -94,9 +105,11 @@ public:
 	bool m_renderGrid = false;
 
 	Clock* m_gameClock = nullptr;
+	SimulationClock* m_simulationClock = nullptr;	// headless only; the same clock as m_gameClock
 	Timer  m_timerOne;
 	Map* m_currentMap = nullptr;
 	std::vector<PlayerController*> m_playerControllers;
+	ReplayRecorder* m_replayRecorder = nullptr;	// only while a match is played with replayRecordFile set
 
 	ShadowMap* m_shadowMap = nullptr;
 
@@ -48,4 +48,11 @@ struct RaycastResult
 {
 	RaycastResult3D m_rayResult;
 	Actor* m_hitActor = nullptr;
+};
+
+struct RayQuery
+{
+	Vec3  m_startPosition;
+	Vec3  m_fwdNormal;
+	float m_distance = 0.f;
 };
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "Game/JobSystem.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+JobSystem* g_jobSystem = nullptr;
+
+static thread_local int s_threadIndex = 0;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobQueue::Push(Job const& job)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_jobs.push_back(job);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool JobQueue::Pop(Job& out_job)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(m_jobs.empty())
+	{
+		return false;
+	}
+
+	out_job = m_jobs.back();
+	m_jobs.pop_back();
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool JobQueue::Steal(Job& out_job)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(m_jobs.empty())
+	{
+		return false;
+	}
+
+	out_job = m_jobs.front();
+	m_jobs.pop_front();
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::Startup(int numThreads)
+{
+	if(numThreads <= 0)
+	{
+		numThreads = static_cast<int>(std::thread::hardware_concurrency());
+	}
+
+	m_numThreads = (numThreads > 1) ? numThreads : 1;
+	m_numQueuedJobs = 0;
+	m_isQuitting = false;
+
+	for(int threadIndex = 0; threadIndex < m_numThreads; ++threadIndex)
+	{
+		m_queues.push_back(new JobQueue());
+	}
+
+	for(int threadIndex = 1; threadIndex < m_numThreads; ++threadIndex)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerMain, this, threadIndex);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_isQuitting = true;
+	}
+
+	m_wakeCondition.notify_all();
+
+	for(std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+
+	m_workers.clear();
+
+	for(JobQueue* queue : m_queues)
+	{
+		delete queue;
+	}
+
+	m_queues.clear();
+	m_numThreads = 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Calls function once per slice of up to grainSize indexes, covering [0, count) exactly once. Slices run in no
+// particular order, so function must only write state that belongs to the indexes it was given.
+void JobSystem::ParallelFor(int count, int grainSize, JobRangeFunction const& function)
+{
+	if(count <= 0)
+	{
+		return;
+	}
+
+	grainSize = (grainSize > 1) ? grainSize : 1;
+
+	if(m_numThreads <= 1 || count <= grainSize)
+	{
+		function(0, count);
+		return;
+	}
+
+	int numJobs = (count + grainSize - 1) / grainSize;
+	std::atomic<int> numPendingJobs = numJobs;
+
+	m_numQueuedJobs += numJobs;
+
+	// dealt round robin so every thread starts on its own queue and stealing only evens out the tail
+	for(int jobIndex = 0; jobIndex < numJobs; ++jobIndex)
+	{
+		Job job;
+		job.m_function		 = &function;
+		job.m_numPendingJobs = &numPendingJobs;
+		job.m_beginIndex	 = jobIndex * grainSize;
+		job.m_endIndex		 = (job.m_beginIndex + grainSize < count) ? job.m_beginIndex + grainSize : count;
+
+		m_queues[jobIndex % m_numThreads]->Push(job);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+
+	m_wakeCondition.notify_all();
+
+	while(numPendingJobs > 0)
+	{
+		if(!TryRunJob(0))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int JobSystem::GetNumThreads() const
+{
+	return m_numThreads;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int JobSystem::GetThreadIndex()
+{
+	return s_threadIndex;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::WorkerMain(int threadIndex)
+{
+	s_threadIndex = threadIndex;
+
+	while(!m_isQuitting)
+	{
+		if(TryRunJob(threadIndex))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.wait(lock, [this]() { return m_isQuitting || m_numQueuedJobs > 0; });
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Own queue first, then the other threads' queues starting with the next one over
+bool JobSystem::TryRunJob(int threadIndex)
+{
+	Job job;
+	bool foundJob = m_queues[threadIndex]->Pop(job);
+
+	for(int offset = 1; !foundJob && offset < m_numThreads; ++offset)
+	{
+		foundJob = m_queues[(threadIndex + offset) % m_numThreads]->Steal(job);
+	}
+
+	if(!foundJob)
+	{
+		return false;
+	}
+
+	m_numQueuedJobs -= 1;
+
+	(*job.m_function)(job.m_beginIndex, job.m_endIndex);
+
+	*job.m_numPendingJobs -= 1;
+
+	return true;
+}
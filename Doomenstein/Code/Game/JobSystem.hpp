@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class JobSystem;
+
+extern JobSystem* g_jobSystem;
+
+typedef std::function<void(int beginIndex, int endIndex)> JobRangeFunction;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// One slice of a ParallelFor. The function and the counter live on the stack of the thread waiting in ParallelFor.
+struct Job
+{
+	JobRangeFunction const*	m_function		 = nullptr;
+	std::atomic<int>*		m_numPendingJobs = nullptr;
+	int						m_beginIndex	 = 0;
+	int						m_endIndex		 = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Each thread owns one. The owner pushes and pops at the back, so it keeps working on the slices it touched last;
+// idle threads steal from the front, which holds the slices the owner would get to last.
+class JobQueue
+{
+public:
+
+	void			Push(Job const& job);
+	bool			Pop(Job& out_job);
+	bool			Steal(Job& out_job);
+
+private:
+
+	std::mutex		m_mutex;
+	std::deque<Job>	m_jobs;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Worker threads for splitting loops over actors across cores. ParallelFor deals the slices of a range out to every
+// thread's queue, runs slices on the calling thread too and returns once all of them are done; threads that run out
+// of slices steal from the others. Only the main thread may call ParallelFor, and never from inside a job.
+// Thread index 0 is the main thread and workers are 1 to GetNumThreads() - 1, so code running in a job can pick
+// per-thread scratch memory with GetThreadIndex().
+class JobSystem
+{
+public:
+
+	JobSystem() = default;
+	~JobSystem();
+
+	// numThreads counts the main thread; 0 or less uses one thread per hardware thread
+	void			Startup(int numThreads);
+	void			Shutdown();
+
+	void			ParallelFor(int count, int grainSize, JobRangeFunction const& function);
+
+	int				GetNumThreads() const;
+	static int		GetThreadIndex();
+
+private:
+
+	void			WorkerMain(int threadIndex);
+	bool			TryRunJob(int threadIndex);
+
+private:
+
+	int							m_numThreads = 1;
+	std::vector<JobQueue*>		m_queues;
+	std::vector<std::thread>	m_workers;
+
+	std::atomic<int>			m_numQueuedJobs = 0;
+	std::atomic<bool>			m_isQuitting	= false;
+	std::mutex					m_wakeMutex;
+	std::condition_variable		m_wakeCondition;
+};
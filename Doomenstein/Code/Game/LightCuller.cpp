@@ -0,0 +1,153 @@
+#include "Game/LightCuller.hpp"
+#include "Game/Frustum.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static int GetTileForScreenFraction(float screenFraction, int numTiles)
+{
+	int tile = static_cast<int>(screenFraction * static_cast<float>(numTiles));
+
+	return (tile < numTiles) ? tile : numTiles - 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void LightCuller::SelectLights(std::vector<Light> const& candidateLights, Camera const& camera, std::vector<Light>& out_selectedLights)
+{
+	out_selectedLights.clear();
+	m_visibleLights.clear();
+
+	Mat44 worldToClip = camera.GetWorldToClipTransform();
+	Frustum frustum = Frustum(worldToClip);
+	Vec3 cameraPosition = camera.GetPosition();
+
+	float const* values = worldToClip.m_values;
+
+	// how far one world unit moves a point in NDC at clip w = 1, used to size a light's screen footprint
+	float ndcScaleX = sqrtf((values[Mat44::Ix] * values[Mat44::Ix]) + (values[Mat44::Jx] * values[Mat44::Jx]) + (values[Mat44::Kx] * values[Mat44::Kx]));
+	float ndcScaleY = sqrtf((values[Mat44::Iy] * values[Mat44::Iy]) + (values[Mat44::Jy] * values[Mat44::Jy]) + (values[Mat44::Ky] * values[Mat44::Ky]));
+
+	for(int lightIndex = 0; lightIndex < static_cast<int>(candidateLights.size()); ++lightIndex)
+	{
+		Light const& light = candidateLights[lightIndex];
+		float radius = GetLightRadius(light);
+
+		if(radius <= 0.f || !frustum.DoesOverlapSphere(light.m_position, radius))
+		{
+			continue;
+		}
+
+		VisibleLight visibleLight;
+		visibleLight.m_lightIndex = lightIndex;
+		visibleLight.m_tileMinX = 0;
+		visibleLight.m_tileMinY = 0;
+		visibleLight.m_tileMaxX = NUM_TILES_X - 1;
+		visibleLight.m_tileMaxY = NUM_TILES_Y - 1;
+
+		float screenCoverage = 1.f;
+		Vec4 clipPosition = worldToClip.TransformHomogeneous3D(Vec4(light.m_position.x, light.m_position.y, light.m_position.z, 1.f));
+
+		// a light whose sphere reaches the camera plane may touch any pixel, so it keeps the full screen
+		if(clipPosition.w > radius)
+		{
+			float ndcX = clipPosition.x / clipPosition.w;
+			float ndcY = clipPosition.y / clipPosition.w;
+			float ndcRadiusX = (radius * ndcScaleX) / (clipPosition.w - radius);
+			float ndcRadiusY = (radius * ndcScaleY) / (clipPosition.w - radius);
+
+			float minU = RangeMapClamped(ndcX - ndcRadiusX, -1.f, 1.f, 0.f, 1.f);
+			float maxU = RangeMapClamped(ndcX + ndcRadiusX, -1.f, 1.f, 0.f, 1.f);
+			float minV = RangeMapClamped(ndcY - ndcRadiusY, -1.f, 1.f, 0.f, 1.f);
+			float maxV = RangeMapClamped(ndcY + ndcRadiusY, -1.f, 1.f, 0.f, 1.f);
+
+			visibleLight.m_tileMinX = GetTileForScreenFraction(minU, NUM_TILES_X);
+			visibleLight.m_tileMaxX = GetTileForScreenFraction(maxU, NUM_TILES_X);
+			visibleLight.m_tileMinY = GetTileForScreenFraction(minV, NUM_TILES_Y);
+			visibleLight.m_tileMaxY = GetTileForScreenFraction(maxV, NUM_TILES_Y);
+
+			screenCoverage = (maxU - minU) * (maxV - minV);
+		}
+
+		// brightness the light could still deliver at the closest point of its sphere to the camera, weighted by how
+		// much of the screen that sphere covers
+		float distanceToSphere = GetVectorDistance3D(cameraPosition, light.m_position) - radius;
+		distanceToSphere = (distanceToSphere > 0.f) ? distanceToSphere : 0.f;
+
+		float attenuation = 1.f / (light.m_constantAttenuation + (light.m_linearAttenuation * distanceToSphere) + (light.m_quadraticAttenuation * distanceToSphere * distanceToSphere));
+		float brightness = (light.m_color.x + light.m_color.y + light.m_color.z) * (1.f / 3.f);
+
+		visibleLight.m_score = light.m_intensity * brightness * attenuation * screenCoverage;
+
+		m_visibleLights.push_back(visibleLight);
+	}
+
+	std::sort(m_visibleLights.begin(), m_visibleLights.end(), [](VisibleLight const& lightA, VisibleLight const& lightB) { return lightA.m_score > lightB.m_score; });
+
+	std::fill(std::begin(m_tileLightCounts), std::end(m_tileLightCounts), 0);
+
+	for(VisibleLight const& visibleLight : m_visibleLights)
+	{
+		if(static_cast<int>(out_selectedLights.size()) >= MAX_LIGHTS)
+		{
+			break;
+		}
+
+		bool hasFreeTile = false;
+
+		for(int tileY = visibleLight.m_tileMinY; tileY <= visibleLight.m_tileMaxY; ++tileY)
+		{
+			for(int tileX = visibleLight.m_tileMinX; tileX <= visibleLight.m_tileMaxX; ++tileX)
+			{
+				int& tileLightCount = m_tileLightCounts[(tileY * NUM_TILES_X) + tileX];
+
+				if(tileLightCount < MAX_LIGHTS_PER_TILE)
+				{
+					tileLightCount += 1;
+					hasFreeTile = true;
+				}
+			}
+		}
+
+		if(hasFreeTile)
+		{
+			out_selectedLights.push_back(candidateLights[visibleLight.m_lightIndex]);
+		}
+	}
+
+	m_lastStats.m_numCandidates = static_cast<int>(candidateLights.size());
+	m_lastStats.m_numVisible	= static_cast<int>(m_visibleLights.size());
+	m_lastStats.m_numSelected	= static_cast<int>(out_selectedLights.size());
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+LightCullStats LightCuller::GetLastStats() const
+{
+	return m_lastStats;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Solves intensity / (c + l*d + q*d^2) = cutoff for d, matching the attenuation the diffuse shader applies
+float LightCuller::GetLightRadius(Light const& light)
+{
+	float constant	= light.m_constantAttenuation - (light.m_intensity / INTENSITY_CUTOFF);
+	float linear	= light.m_linearAttenuation;
+	float quadratic = light.m_quadraticAttenuation;
+
+	if(constant >= 0.f)
+	{
+		return 0.f;
+	}
+
+	if(quadratic <= 0.f)
+	{
+		return (linear > 0.f) ? (-constant / linear) : FLT_MAX;
+	}
+
+	return (-linear + sqrtf((linear * linear) - (4.f * quadratic * constant))) / (2.f * quadratic);
+}
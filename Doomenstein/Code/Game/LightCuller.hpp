@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Engine/Renderer/Light.hpp"
+
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class Camera;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+struct LightCullStats
+{
+	int m_numCandidates = 0;
+	int m_numVisible	= 0;
+	int m_numSelected	= 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Picks the lights one camera should send to the shader. Lights outside the camera frustum are dropped, the rest are
+// ranked by how much they can contribute on screen and binned into a coarse grid of screen tiles. Every tile keeps
+// only its strongest few lights, so a cluster of lights in one corner cannot use up the whole shader budget while the
+// rest of the view goes dark.
+class LightCuller
+{
+public:
+
+	LightCuller() = default;
+	~LightCuller() = default;
+
+	void			SelectLights(std::vector<Light> const& candidateLights, Camera const& camera, std::vector<Light>& out_selectedLights);
+
+	LightCullStats	GetLastStats() const;
+
+	static float	GetLightRadius(Light const& light);
+
+public:
+
+	static constexpr int	NUM_TILES_X			= 8;
+	static constexpr int	NUM_TILES_Y			= 8;
+	static constexpr int	MAX_LIGHTS_PER_TILE	= 8;
+
+	// a light is treated as having no effect past the distance its attenuated intensity drops below this
+	static constexpr float	INTENSITY_CUTOFF	= 0.02f;
+
+private:
+
+	struct VisibleLight
+	{
+		int		m_lightIndex = 0;
+		float	m_score		 = 0.f;
+		int		m_tileMinX	 = 0;
+		int		m_tileMinY	 = 0;
+		int		m_tileMaxX	 = 0;
+		int		m_tileMaxY	 = 0;
+	};
+
+private:
+
+	std::vector<VisibleLight>	m_visibleLights;
+	int							m_tileLightCounts[NUM_TILES_X * NUM_TILES_Y] = {};
+	LightCullStats				m_lastStats;
+};
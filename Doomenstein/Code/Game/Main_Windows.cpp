@@ -3,6 +3,7 @@
 #include <math.h>
 #include <cassert>
 #include <crtdbg.h>
+#include <stdio.h>
 
 #include "Game/App.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -16,11 +17,22 @@ extern InputSystem* g_inputSystem;
 //-----------------------------------------------------------------------------------------------
 int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR commandLineString, int )
 {
-	UNUSED(commandLineString);
 	UNUSED(applicationInstanceHandle);
 	
 	g_theApp = new App();
-	g_theApp->Startup();
+	g_theApp->Startup(commandLineString);
+
+	// headless runs report to the console they were launched from
+	if(g_theApp->IsHeadless())
+	{
+		if(!AttachConsole(ATTACH_PARENT_PROCESS))
+		{
+			AllocConsole();
+		}
+
+		FILE* consoleOutput = nullptr;
+		freopen_s(&consoleOutput, "CONOUT$", "w", stdout);
+	}
 
 	g_theApp->RunMainFrame();
 	
@@ -6,12 +6,19 @@
 #include "Game/Actor.hpp"
 #include "Game/Game.hpp"
 #include "Game/PlayerController.hpp"
+#include "Game/AIController.hpp"
+#include "Game/Frustum.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/JobSystem.hpp"
 #include "Engine/Core/Image.hpp"
+#include "Engine/Core/Time.hpp"
 #include "Engine/Math/RaycastUtils.hpp"
 #include "Engine/Math/EasingFunctions.hpp"
 #include "Engine/Math/CurveUtils.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 extern Game* g_game;
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -29,6 +36,14 @@ Map::Map(Game* owner, std::string mapName)
 		}
 	}
 
+	m_actorGrid.Initialize(m_bounds);
+	m_physicsSystem.Initialize();
+	m_aiScheduler.Initialize();
+	m_raycastScratch.resize(g_jobSystem->GetNumThreads());
+	m_commandBuffer.SetNumThreads(g_jobSystem->GetNumThreads());
+	InitializeTileVisibility();
+	PrewarmActorPools();
+
 	GenerateMapVerts();
 	SpawnAllActors();
 
@@ -37,10 +52,11 @@ Map::Map(Game* owner, std::string mapName)
 		SpawnPlayer();
 	}
 
-	double physicsTimeStep = static_cast<double>(1.f / 240.f);
-
-	m_physicsTimer = Timer(physicsTimeStep, m_game->m_gameClock);
-	m_physicsTimer.Start();
+	float physicsTicksPerSecond = g_gameConfigBlackboard.GetValue("physicsTicksPerSecond", 120.f);
+	GUARANTEE_OR_DIE(physicsTicksPerSecond > 0.f, "physicsTicksPerSecond must be greater than 0");
+	m_physicsStepSeconds = 1.f / physicsTicksPerSecond;
+	m_maxPhysicsTicksPerFrame = g_gameConfigBlackboard.GetValue("maxPhysicsTicksPerFrame", m_maxPhysicsTicksPerFrame);
+	GUARANTEE_OR_DIE(m_maxPhysicsTicksPerFrame > 0, "maxPhysicsTicksPerFrame must be at least 1");
 
 	float pitchDuration = g_gameConfigBlackboard.GetValue("sunPitchTimer", 1.f);
 	m_sunTimer = Timer(pitchDuration, m_game->m_gameClock);
@@ -59,9 +75,30 @@ Map::Map(Game* owner, std::string mapName)
 
 	g_game->m_gameClock->SetTimeScale(1.f);
 
+	SaveSnapshot(m_levelStartSnapshot);
+
 	SubscribeEventCallbackFunction("KillAllActors", Event_OnKillAllActors);
 	SubscribeEventCallbackFunction("SunSettings", Event_OnDisplaySunSettings);
 	SubscribeEventCallbackFunction("ControlLights", Event_DebugControlLighting);
+	SubscribeEventCallbackFunction("BenchmarkCollision", Event_BenchmarkCollision);
+	SubscribeEventCallbackFunction("VerifyCollisionGrid", Event_VerifyCollisionGrid);
+	SubscribeEventCallbackFunction("BenchmarkTileQueries", Event_BenchmarkTileQueries);
+	SubscribeEventCallbackFunction("BenchmarkSpawns", Event_BenchmarkSpawns);
+	SubscribeEventCallbackFunction("BenchmarkActorViews", Event_BenchmarkActorViews);
+	SubscribeEventCallbackFunction("VerifyActorBatches", Event_VerifyActorBatches);
+	SubscribeEventCallbackFunction("VerifyMapMeshes", Event_VerifyMapMeshes);
+	SubscribeEventCallbackFunction("ReportMapChunks", Event_ReportMapChunks);
+	SubscribeEventCallbackFunction("ReportLights", Event_ReportLights);
+	SubscribeEventCallbackFunction("ReportAIStats", Event_ReportAIStats);
+	SubscribeEventCallbackFunction("BenchmarkSightQueries", Event_BenchmarkSightQueries);
+	SubscribeEventCallbackFunction("BenchmarkRaycasts", Event_BenchmarkRaycasts);
+	SubscribeEventCallbackFunction("VerifyRayKernels", Event_VerifyRayKernels);
+	SubscribeEventCallbackFunction("BenchmarkPhysics", Event_BenchmarkPhysics);
+	SubscribeEventCallbackFunction("ReportPhysicsStats", Event_ReportPhysicsStats);
+	SubscribeEventCallbackFunction("SaveSnapshot", Event_SaveSnapshot);
+	SubscribeEventCallbackFunction("LoadSnapshot", Event_LoadSnapshot);
+	SubscribeEventCallbackFunction("RestartLevel", Event_RestartLevel);
+	SubscribeEventCallbackFunction("BenchmarkSnapshots", Event_BenchmarkSnapshots);
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -70,12 +107,34 @@ Map::~Map()
 	UnsubscribeEventCallbackFunction("KillAllActors", Event_OnKillAllActors);
 	UnsubscribeEventCallbackFunction("SunSettings", Event_OnDisplaySunSettings);
 	UnsubscribeEventCallbackFunction("ControlLights", Event_DebugControlLighting);
-
-	delete m_vbo;
-	m_vbo = nullptr;
-
-	delete m_ibo;
-	m_ibo = nullptr;
+	UnsubscribeEventCallbackFunction("BenchmarkCollision", Event_BenchmarkCollision);
+	UnsubscribeEventCallbackFunction("VerifyCollisionGrid", Event_VerifyCollisionGrid);
+	UnsubscribeEventCallbackFunction("BenchmarkTileQueries", Event_BenchmarkTileQueries);
+	UnsubscribeEventCallbackFunction("BenchmarkSpawns", Event_BenchmarkSpawns);
+	UnsubscribeEventCallbackFunction("BenchmarkActorViews", Event_BenchmarkActorViews);
+	UnsubscribeEventCallbackFunction("VerifyActorBatches", Event_VerifyActorBatches);
+	UnsubscribeEventCallbackFunction("VerifyMapMeshes", Event_VerifyMapMeshes);
+	UnsubscribeEventCallbackFunction("ReportMapChunks", Event_ReportMapChunks);
+	UnsubscribeEventCallbackFunction("ReportLights", Event_ReportLights);
+	UnsubscribeEventCallbackFunction("ReportAIStats", Event_ReportAIStats);
+	UnsubscribeEventCallbackFunction("BenchmarkSightQueries", Event_BenchmarkSightQueries);
+	UnsubscribeEventCallbackFunction("BenchmarkRaycasts", Event_BenchmarkRaycasts);
+	UnsubscribeEventCallbackFunction("VerifyRayKernels", Event_VerifyRayKernels);
+	UnsubscribeEventCallbackFunction("BenchmarkPhysics", Event_BenchmarkPhysics);
+	UnsubscribeEventCallbackFunction("ReportPhysicsStats", Event_ReportPhysicsStats);
+	UnsubscribeEventCallbackFunction("SaveSnapshot", Event_SaveSnapshot);
+	UnsubscribeEventCallbackFunction("LoadSnapshot", Event_LoadSnapshot);
+	UnsubscribeEventCallbackFunction("RestartLevel", Event_RestartLevel);
+	UnsubscribeEventCallbackFunction("BenchmarkSnapshots", Event_BenchmarkSnapshots);
+
+	for(MapChunk& chunk : m_chunks)
+	{
+		delete chunk.m_vbo;
+		chunk.m_vbo = nullptr;
+
+		delete chunk.m_ibo;
+		chunk.m_ibo = nullptr;
+	}
 
 	for(size_t index = 0; index < m_allActors.size(); ++index)
 	{
@@ -95,6 +154,16 @@ Map::~Map()
 		}
 	}
 
+	for(ActorPool& actorPool : m_actorPools)
+	{
+		for(Actor* pooledActor : actorPool.m_freeActors)
+		{
+			delete pooledActor;
+		}
+
+		actorPool.m_freeActors.clear();
+	}
+
 	m_mapDef = nullptr;
 	m_game = nullptr;
 }
@@ -112,6 +181,11 @@ void Map::DisplayTime()
 	int minutes = (elapsedTime % 3600) / 60;
 	int seconds = elapsedTime % 60;
 
+	if(!g_gameFont)
+	{
+		return;
+	}
+
 	std::string time = Stringf("Day %d\n\n%02d:%02d:%02d", m_numDaysPassed, m_hours, minutes, seconds);
 
 	g_gameFont->AddVertsForTextInBox2D(m_textVerts, time, AABB2(Vec2::ZERO, g_theWindow->GetClientDimensions().GetAsVec2()), 24.f, Rgba8::WHITE, 1.f, Vec2(0.5f, 0.95f), SHRINK_TO_FIT);
@@ -122,11 +196,119 @@ void Map::DisplayTime()
 void Map::InitializeMapByImage(Image& mapImage)
 {	
 	m_bounds = mapImage.GetDimensions();
-	float tileOffset = 1.f;
 
-	for(int y = 0; y < m_bounds.y; ++y)
+	ParseTilesFromImage(mapImage, m_tiles);
+
+	m_tileFlags.assign(m_tiles.size(), 0);
+
+	for(int tileIndex = 0; tileIndex < static_cast<int>(m_tiles.size()); ++tileIndex)
+	{
+		Tile const& tile = m_tiles[tileIndex];
+
+		if(!tile.HasDefinition())
+		{
+			continue;
+		}
+
+		m_tileFlags[tileIndex] = tile.GetFlags();
+
+		int x = tileIndex % m_bounds.x;
+		int y = tileIndex / m_bounds.x;
+
+		std::string const& tileType = tile.GetTileDefinition().GetName();
+		AABB3 tileBounds = tile.GetTileBounds(IntVec2(x, y));
+
+		if(tile.IsTileGoal())
+		{
+			Vec3 position = Vec3(tileBounds.m_mins.x + 0.5f, tileBounds.m_mins.y + 0.5f, 2.f);
+			Light light = Light::CreateSpotLight(position, Vec3::DOWN, 20.f, 3.f, 0.33f, 0.62f, 0.05f);
+
+			if(tileType == "BlueGoal")
+			{
+				light.m_color = Rgba8::BLUE.GetAsVec4();
+			}
+			else if(tileType == "YellowGoal")
+			{
+				light.m_color = Rgba8::YELLOW.GetAsVec4();
+			}				
+			else if(tileType == "RedGoal")
+			{
+				light.m_color = Rgba8::RED.GetAsVec4();
+
+			}
+			else if(tileType == "GreenGoal")
+			{
+				light.m_color = Rgba8::GREEN.GetAsVec4();
+
+			}
+
+			m_mapLights.push_back(light);
+		}
+
+		if(tileType == "BrickWall" && x != 0 && y != 0)
+		{
+			Vec3 position = Vec3(tileBounds.m_mins.x + 0.5f, tileBounds.m_mins.y + 0.5f, 3.f);
+			Light light = Light::CreatePointLight(position, 1.f, 0.2f, 0.7f, 0.1f, Rgba8::ORANGE);
+			m_mapLights.push_back(light);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The table is cached next to the map image (Senate.png -> Senate.pvs) and rebaked whenever the walls change.
+// The bake tests every pair of open tiles, so its time and the table's size grow with the square of the tile count:
+// a 64x64 map (4096 tiles) is about 8M pairs and 2 MB. Maps above maxTileVisibilityBakeTiles are never baked on load;
+// they use a cache file if one exists and otherwise confirm every sight check with a raycast.
+void Map::InitializeTileVisibility()
+{
+	bool useCache = g_gameConfigBlackboard.GetValue("cacheTileVisibility", true);
+	int maxBakeTiles = g_gameConfigBlackboard.GetValue("maxTileVisibilityBakeTiles", 4096);
+
+	std::string cachePath = m_mapDef->m_imagePath;
+	size_t extensionStart = cachePath.find_last_of('.');
+	cachePath = cachePath.substr(0, extensionStart) + ".pvs";
+
+	m_tileVisibilityBakeSeconds = -1.0;
+
+	if(useCache && m_tileVisibility.LoadFromFile(cachePath, m_tileFlags, m_bounds))
+	{
+		DebuggerPrintf("%s\n", Stringf("Loaded tile visibility for %s from %s", m_mapDef->m_name.c_str(), cachePath.c_str()).c_str());
+		return;
+	}
+
+	int numTiles = m_bounds.x * m_bounds.y;
+
+	if(numTiles > maxBakeTiles)
+	{
+		m_useTileVisibility = false;
+		DebuggerPrintf("%s\n", Stringf("Skipped tile visibility bake for %s: %d tiles is over maxTileVisibilityBakeTiles (%d)", m_mapDef->m_name.c_str(), numTiles, maxBakeTiles).c_str());
+		return;
+	}
+
+	double startTime = GetCurrentTimeSeconds();
+	m_tileVisibility.Build(m_tileFlags, m_bounds);
+	m_tileVisibilityBakeSeconds = GetCurrentTimeSeconds() - startTime;
+
+	DebuggerPrintf("%s\n", Stringf("Baked tile visibility for %s (%d tiles) in %.2f s", m_mapDef->m_name.c_str(), numTiles, m_tileVisibilityBakeSeconds).c_str());
+
+	if(useCache && !m_tileVisibility.SaveToFile(cachePath))
+	{
+		DebuggerPrintf("%s\n", Stringf("Could not write tile visibility cache %s", cachePath.c_str()).c_str());
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// One tile per texel so tile coordinates follow from the index; texels that are transparent or match no tile
+// definition keep an empty tile that generates no geometry and behaves like open floor
+void Map::ParseTilesFromImage(Image const& mapImage, std::vector<Tile>& out_tiles)
+{
+	IntVec2 dimensions = mapImage.GetDimensions();
+
+	out_tiles.assign(dimensions.x * dimensions.y, Tile());
+
+	for(int y = 0; y < dimensions.y; ++y)
 	{
-		for(int x = 0; x < m_bounds.x; ++x)
+		for(int x = 0; x < dimensions.x; ++x)
 		{
 			bool colorFound = false;
 
@@ -146,52 +328,7 @@ void Map::InitializeMapByImage(Image& mapImage)
 				if(tileMapColor.r == texelColor.r && tileMapColor.g == texelColor.g && tileMapColor.b == texelColor.b)
 				{
 					colorFound = true;
-
-					std::string tileType = TileDefinition::s_definitions[tileDef].GetName();
-					float tileHeight = static_cast<float>(TileDefinition::s_definitions[tileDef].m_height);
-
-					AABB3 tileBounds;
-
-					tileBounds.m_mins = Vec3(x , y, 0) * tileOffset;
-					tileBounds.m_maxs = tileBounds.m_mins + Vec3(tileOffset, tileOffset, tileHeight);
-
-					Tile tile(tileBounds, tileType);
-					m_tiles.push_back(tile);
-
-					if(tile.IsTileGoal())
-					{
-						Vec3 position = Vec3(tileBounds.m_mins.x + 0.5f, tileBounds.m_mins.y + 0.5f, 2.f);
-						Light light = Light::CreateSpotLight(position, Vec3::DOWN, 20.f, 3.f, 0.33f, 0.62f, 0.05f);
-
-						if(tileType == "BlueGoal")
-						{
-							light.m_color = Rgba8::BLUE.GetAsVec4();
-						}
-						else if(tileType == "YellowGoal")
-						{
-							light.m_color = Rgba8::YELLOW.GetAsVec4();
-						}				
-						else if(tileType == "RedGoal")
-						{
-							light.m_color = Rgba8::RED.GetAsVec4();
-
-						}
-						else if(tileType == "GreenGoal")
-						{
-							light.m_color = Rgba8::GREEN.GetAsVec4();
-
-						}
-
-						m_mapLights.push_back(light);
-					}
-
-					if(tileType == "BrickWall" && x != 0 && y != 0)
-					{
-						Vec3 position = Vec3(tileBounds.m_mins.x + 0.5f, tileBounds.m_mins.y + 0.5f, 3.f);
-						Light light = Light::CreatePointLight(position, 1.f, 0.2f, 0.7f, 0.1f, Rgba8::ORANGE);
-						m_mapLights.push_back(light);
-					}
-
+					out_tiles[(y * dimensions.x) + x] = Tile(static_cast<int>(tileDef));
 					break;
 				}
 			}
@@ -208,67 +345,172 @@ void Map::InitializeMapByImage(Image& mapImage)
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Map::GenerateMapVerts()
 {
+	// the chunk meshes are only drawn, so a headless run has nothing to build
+	if(!g_theRenderer)
+	{
+		return;
+	}
 
 	SpriteSheet mapSpriteSheet = SpriteSheet(*m_mapDef->m_spriteSheetTexture, IntVec2(8, 8));
 
-	for(size_t tileIndex = 0; tileIndex < m_tiles.size(); ++tileIndex)
+	std::vector<Vertex_PCUTBN>	chunkVerts;
+	std::vector<unsigned int>	chunkIndexes;
+
+	for(int chunkY = 0; chunkY < m_bounds.y; chunkY += MAP_CHUNK_SIZE)
 	{
-		if(m_tiles[tileIndex].IsTileSolid())
+		for(int chunkX = 0; chunkX < m_bounds.x; chunkX += MAP_CHUNK_SIZE)
 		{
-			AABB2 wallUVs = mapSpriteSheet.GetSpriteUVs(m_tiles[tileIndex].GetTileDefinition().m_wallSpriteCoords, 8);
-			AddVertsForWall(m_verts, m_indexes, m_tiles[tileIndex].GetTileBounds(), wallUVs);
+			IntVec2 tileMins = IntVec2(chunkX, chunkY);
+			IntVec2 tileMaxs = IntVec2(chunkX + MAP_CHUNK_SIZE, chunkY + MAP_CHUNK_SIZE);
+
+			tileMaxs.x = (tileMaxs.x < m_bounds.x) ? tileMaxs.x : m_bounds.x;
+			tileMaxs.y = (tileMaxs.y < m_bounds.y) ? tileMaxs.y : m_bounds.y;
+
+			BuildMapMeshForTiles(m_tiles, m_bounds, tileMins, tileMaxs, mapSpriteSheet, true, chunkVerts, chunkIndexes);
+
+			if(chunkIndexes.empty())
+			{
+				continue;
+			}
+
+			MapChunk chunk;
+			chunk.m_bounds = AABB3(chunkVerts[0].m_position, chunkVerts[0].m_position);
+
+			for(Vertex_PCUTBN const& vert : chunkVerts)
+			{
+				chunk.m_bounds.m_mins.x = (vert.m_position.x < chunk.m_bounds.m_mins.x) ? vert.m_position.x : chunk.m_bounds.m_mins.x;
+				chunk.m_bounds.m_mins.y = (vert.m_position.y < chunk.m_bounds.m_mins.y) ? vert.m_position.y : chunk.m_bounds.m_mins.y;
+				chunk.m_bounds.m_mins.z = (vert.m_position.z < chunk.m_bounds.m_mins.z) ? vert.m_position.z : chunk.m_bounds.m_mins.z;
+				chunk.m_bounds.m_maxs.x = (vert.m_position.x > chunk.m_bounds.m_maxs.x) ? vert.m_position.x : chunk.m_bounds.m_maxs.x;
+				chunk.m_bounds.m_maxs.y = (vert.m_position.y > chunk.m_bounds.m_maxs.y) ? vert.m_position.y : chunk.m_bounds.m_maxs.y;
+				chunk.m_bounds.m_maxs.z = (vert.m_position.z > chunk.m_bounds.m_maxs.z) ? vert.m_position.z : chunk.m_bounds.m_maxs.z;
+			}
+
+			unsigned int vboSize = sizeof(Vertex_PCUTBN) * static_cast<unsigned int>(chunkVerts.size());
+			unsigned int iboSize = sizeof(unsigned int) * static_cast<unsigned int>(chunkIndexes.size());
+
+			chunk.m_vbo = g_theRenderer->CreateVertexBuffer(sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
+			chunk.m_ibo = g_theRenderer->CreateIndexBuffer(sizeof(unsigned int), sizeof(unsigned int));
+
+			g_theRenderer->CopyCPUToGPU(chunkVerts.data(), vboSize, chunk.m_vbo);
+			g_theRenderer->CopyCPUToGPU(chunkIndexes.data(), iboSize, chunk.m_ibo);
+
+			chunk.m_numIndexes = static_cast<unsigned int>(chunkIndexes.size());
+
+			m_chunks.push_back(chunk);
 		}
-		else
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Builds the static floor and wall mesh for a tile grid. With cullHiddenWallFaces, a wall face is skipped when the tile
+// it faces is a solid wall at least as tall, since it can never be seen from inside the map.
+void Map::BuildMapMesh(std::vector<Tile> const& tiles, IntVec2 const& dimensions, SpriteSheet const& spriteSheet, bool cullHiddenWallFaces, std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes)
+{
+	BuildMapMeshForTiles(tiles, dimensions, IntVec2(0, 0), dimensions, spriteSheet, cullHiddenWallFaces, verts, indexes);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Same as BuildMapMesh for the tiles in [tileMins, tileMaxs) only; neighbours outside the range still hide wall faces
+void Map::BuildMapMeshForTiles(std::vector<Tile> const& tiles, IntVec2 const& dimensions, IntVec2 const& tileMins, IntVec2 const& tileMaxs, SpriteSheet const& spriteSheet, bool cullHiddenWallFaces, std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes)
+{
+	verts.clear();
+	indexes.clear();
+
+	for(int tileY = tileMins.y; tileY < tileMaxs.y; ++tileY)
+	{
+		for(int tileX = tileMins.x; tileX < tileMaxs.x; ++tileX)
 		{
-			AABB2 floorUVs = mapSpriteSheet.GetSpriteUVs(m_tiles[tileIndex].GetTileDefinition().m_floorSpriteCoords, 8);
-			AABB2 ceilingUVs = mapSpriteSheet.GetSpriteUVs(m_tiles[tileIndex].GetTileDefinition().m_ceilingSpriteCoords, 8);
+			IntVec2 tileCoord = IntVec2(tileX, tileY);
+			Tile const& tile = tiles[(tileY * dimensions.x) + tileX];
+
+			if(!tile.HasDefinition())
+			{
+				continue;
+			}
+
+			TileDefinition const& tileDef = tile.GetTileDefinition();
+			AABB3 tileBounds = tile.GetTileBounds(tileCoord);
+
+			if(tile.IsTileSolid())
+			{
+				unsigned char visibleFaces = cullHiddenWallFaces ? GetVisibleWallFaces(tiles, dimensions, tileCoord) : WALL_FACE_ALL;
+
+				AABB2 wallUVs = spriteSheet.GetSpriteUVs(tileDef.m_wallSpriteCoords, 8);
+				AddVertsForWall(verts, indexes, tileBounds, wallUVs, visibleFaces);
+			}
+			else
+			{
+				AABB2 floorUVs = spriteSheet.GetSpriteUVs(tileDef.m_floorSpriteCoords, 8);
 
-//			AddVertsForCeiling(m_verts, m_indexes, m_tiles[tileIndex].GetTileBounds(), ceilingUVs);
-			AddVertsForFloor(m_verts, m_indexes, m_tiles[tileIndex].GetTileBounds(), floorUVs);
-//			AddVertsForFloor(verts, indexes, m_tiles[tileIndex].GetTileBounds(), floorUVs);
+				AddVertsForFloor(verts, indexes, tileBounds, floorUVs);
+			}
 		}
 	}
+}
 
-	unsigned int vboSize = sizeof(Vertex_PCUTBN) * static_cast<unsigned int>(m_verts.size());
-	unsigned int iboSize = sizeof(unsigned int) * static_cast<unsigned int>(m_indexes.size());
-
-// 	unsigned int vboSize = sizeof(Vertex_PCUTBN) * static_cast<unsigned int>(verts.size());
-// 	unsigned int iboSize = sizeof(unsigned int) * static_cast<unsigned int>(indexes.size());
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned char Map::GetVisibleWallFaces(std::vector<Tile> const& tiles, IntVec2 const& dimensions, IntVec2 const& tileCoord)
+{
+	static IntVec2 const s_faceNeighborOffsets[4] = { IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1) };
+	static unsigned char const s_faceBits[4] = { WALL_FACE_POSITIVE_X, WALL_FACE_NEGATIVE_X, WALL_FACE_POSITIVE_Y, WALL_FACE_NEGATIVE_Y };
 
+	TileFlags tileHeight = tiles[(tileCoord.y * dimensions.x) + tileCoord.x].GetFlags() & TILE_FLAG_HEIGHT_MASK;
+	unsigned char visibleFaces = WALL_FACE_ALL;
 
-	m_vbo = g_theRenderer->CreateVertexBuffer(sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
-	m_ibo = g_theRenderer->CreateIndexBuffer(sizeof(unsigned int), sizeof(unsigned int));
+	for(int faceIndex = 0; faceIndex < 4; ++faceIndex)
+	{
+		IntVec2 neighborCoord = tileCoord + s_faceNeighborOffsets[faceIndex];
 
-	g_theRenderer->CopyCPUToGPU(m_verts.data(), vboSize, m_vbo);
-	g_theRenderer->CopyCPUToGPU(m_indexes.data(), iboSize, m_ibo);
+		if(neighborCoord.x < 0 || neighborCoord.y < 0 || neighborCoord.x >= dimensions.x || neighborCoord.y >= dimensions.y)
+		{
+			continue;
+		}
 
-//	g_theRenderer->CopyCPUToGPU(verts.data(), vboSize, m_vbo);
-//	g_theRenderer->CopyCPUToGPU(indexes.data(), iboSize, m_ibo);
+		TileFlags neighborFlags = tiles[(neighborCoord.y * dimensions.x) + neighborCoord.x].GetFlags();
 
+		if((neighborFlags & TILE_FLAG_SOLID) && (neighborFlags & TILE_FLAG_HEIGHT_MASK) >= tileHeight)
+		{
+			visibleFaces &= ~s_faceBits[faceIndex];
+		}
+	}
 
+	return visibleFaces;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Map::AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs) const
+void Map::AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs, unsigned char visibleFaces)
 {
 	std::vector<Vec3> eightCornerPoints;
 	bounds.GetCornerPoints(eightCornerPoints);
 
 	// Positive X Face
-	AddVertsForQuad3D(verts, indexes, eightCornerPoints[POINT_F], eightCornerPoints[POINT_E], eightCornerPoints[POINT_H], eightCornerPoints[POINT_G], Rgba8::WHITE, UVs);
+	if(visibleFaces & WALL_FACE_POSITIVE_X)
+	{
+		AddVertsForQuad3D(verts, indexes, eightCornerPoints[POINT_F], eightCornerPoints[POINT_E], eightCornerPoints[POINT_H], eightCornerPoints[POINT_G], Rgba8::WHITE, UVs);
+	}
 
 	// Negative X Face
-	AddVertsForQuad3D(verts, indexes, eightCornerPoints[POINT_D], eightCornerPoints[POINT_A], eightCornerPoints[POINT_B], eightCornerPoints[POINT_C], Rgba8::WHITE, UVs);
+	if(visibleFaces & WALL_FACE_NEGATIVE_X)
+	{
+		AddVertsForQuad3D(verts, indexes, eightCornerPoints[POINT_D], eightCornerPoints[POINT_A], eightCornerPoints[POINT_B], eightCornerPoints[POINT_C], Rgba8::WHITE, UVs);
+	}
 
 	// Positive Y Face
-	AddVertsForQuad3D(verts, indexes, eightCornerPoints[POINT_E], eightCornerPoints[POINT_D], eightCornerPoints[POINT_C], eightCornerPoints[POINT_H], Rgba8::WHITE, UVs);
+	if(visibleFaces & WALL_FACE_POSITIVE_Y)
+	{
+		AddVertsForQuad3D(verts, indexes, eightCornerPoints[POINT_E], eightCornerPoints[POINT_D], eightCornerPoints[POINT_C], eightCornerPoints[POINT_H], Rgba8::WHITE, UVs);
+	}
 
 	// Negative Y Face
-	AddVertsForQuad3D(verts, indexes, eightCornerPoints[POINT_A], eightCornerPoints[POINT_F], eightCornerPoints[POINT_G], eightCornerPoints[POINT_B], Rgba8::WHITE, UVs);
+	if(visibleFaces & WALL_FACE_NEGATIVE_Y)
+	{
+		AddVertsForQuad3D(verts, indexes, eightCornerPoints[POINT_A], eightCornerPoints[POINT_F], eightCornerPoints[POINT_G], eightCornerPoints[POINT_B], Rgba8::WHITE, UVs);
+	}
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Map::AddVertsForFloor(std::vector<Vertex_PCUTBN>&verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs) const
+void Map::AddVertsForFloor(std::vector<Vertex_PCUTBN>&verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs)
 {
 	std::vector<Vec3> eightCornerPoints;
 	bounds.GetCornerPoints(eightCornerPoints);
@@ -277,7 +519,7 @@ void Map::AddVertsForFloor(std::vector<Vertex_PCUTBN>&verts, std::vector<unsigne
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Map::AddVertsForCeiling(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs) const
+void Map::AddVertsForCeiling(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs)
 {
 	std::vector<Vec3> eightCornerPoints;
 	bounds.GetCornerPoints(eightCornerPoints);
@@ -290,6 +532,13 @@ void Map::Update()
 {
 	m_allLights.clear();
 
+	// the job system may have been restarted with more threads since the map was made
+	if(static_cast<int>(m_raycastScratch.size()) < g_jobSystem->GetNumThreads())
+	{
+		m_raycastScratch.resize(g_jobSystem->GetNumThreads());
+		m_commandBuffer.SetNumThreads(g_jobSystem->GetNumThreads());
+	}
+
 	if(m_sunTimer.HasPeriodElapsed())
 	{
 		m_numDaysPassed += 1;
@@ -298,13 +547,20 @@ void Map::Update()
 
 	UpdateLights();
 
-	ActorUpdate();
+	UpdatePlayerFlowFields();
 
-	if(m_physicsTimer.DecrementPeriodIfElapsed())
+	if(m_game->m_aiEnabled)
 	{
-		PhysicsUpdate();
+		m_aiScheduler.Update(m_allActors);
 	}
 
+	ActorUpdate();
+
+	// the one sync point for what weapons and events queued this frame, so physics sees the spawns and impulses
+	m_commandBuffer.Apply(*this);
+
+	StepPhysics();
+
 	DisplayTime();
 
 	ActorAudioUpdate();
@@ -502,13 +758,14 @@ void Map::UpdateAmbientLighting()
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Gathers every light that could be on screen this frame; each camera picks its own subset in Render
 void Map::CheckAndFillLights()
 {
 	for(Actor* actor : m_allActors)
 	{
 		if(actor && actor->m_definition->m_isLightSource)
 		{
-			if(IsValidPosition(actor->m_light.m_position) && static_cast<int>(m_allLights.size()) < MAX_LIGHTS)
+			if(IsValidPosition(actor->m_light.m_position))
 			{
 				m_allLights.push_back(actor->m_light);
 			}
@@ -517,7 +774,7 @@ void Map::CheckAndFillLights()
 
 	for(Light const& light : m_mapLights)
 	{
-		if(IsValidPosition(light.m_position) && static_cast<int>(m_allLights.size()) < MAX_LIGHTS)
+		if(IsValidPosition(light.m_position))
 		{
 			m_allLights.push_back(light);
 		}
@@ -526,53 +783,126 @@ void Map::CheckAndFillLights()
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-bool Map::IsLightInScreenSpace(Light const& light)
+// Two phases so the result does not depend on how many threads run it. The read phase plans every AI actor's steering
+// in parallel against the same world state and writes nothing but the planning controller. The commit phase then
+// updates the actors one at a time in slot order, which is where plans turn into movement, attacks, damage, deaths
+// and spawns.
+void Map::ActorUpdate()
 {
-	Mat44 worldToClip = m_game->m_playerControllers[0]->m_worldCamera.GetWorldToCameraTransform();
-
-	worldToClip.AppendTranslation3D(light.m_position);
+	g_jobSystem->ParallelFor(static_cast<int>(m_allActors.size()), ACTOR_JOB_GRAIN_SIZE, [this](int beginIndex, int endIndex)
+	{
+		for(int actorIndex = beginIndex; actorIndex < endIndex; ++actorIndex)
+		{
+			Actor* actor = m_allActors[actorIndex];
 
-	Vec4 clipPos = worldToClip.GetTranslation4D();
+			if(actor && actor->m_aiController && actor->m_possessedController == actor->m_aiController)
+			{
+				actor->m_aiController->PlanSteering();
+			}
+		}
+	});
 
-	if(clipPos.w < 0.f)
+	for(size_t actorIndex = 0; actorIndex < m_allActors.size(); ++actorIndex)
 	{
-		return false;
+		if(m_allActors[actorIndex] && m_allActors[actorIndex]->m_state != ActorState::DEAD && m_allActors[actorIndex]->m_state != ActorState::DYING)
+		{
+			m_allActors[actorIndex]->Update();
+		}
 	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Runs as many fixed physics ticks as the frame's game time covers, so the simulation does not depend on the frame rate.
+// The movement forces controllers added this frame apply to each of those ticks and are cleared afterwards. A frame
+// that would need more than m_maxPhysicsTicksPerFrame ticks drops the rest of its backlog instead of falling further behind.
+// Actors are drawn between their last two tick positions by how far the leftover time is into the next tick.
+void Map::StepPhysics()
+{
+	double startTime = GetCurrentTimeSeconds();
 
-	Vec3 clipDivideByW = Vec3(clipPos.x, clipPos.y, clipPos.z) / clipPos.w;
+	m_physicsAccumulatorSeconds += m_game->m_gameClock->GetDeltaSeconds();
 
-	if(clipDivideByW.x > 1.f || clipDivideByW.x < -1.f || clipDivideByW.y > 1.f || clipDivideByW.y < -1.f)
+	PhysicsStepStats stats;
+
+	while(m_physicsAccumulatorSeconds >= m_physicsStepSeconds && stats.m_numTicks < m_maxPhysicsTicksPerFrame)
 	{
-		return false;
+		for(Actor* actor : m_allActors)
+		{
+			if(actor)
+			{
+				actor->m_previousPosition = actor->m_position;
+			}
+		}
+
+		PhysicsUpdate();
+
+		m_physicsAccumulatorSeconds -= m_physicsStepSeconds;
+		stats.m_numTicks += 1;
 	}
 
-	return true;
-}
+	if(m_physicsAccumulatorSeconds >= m_physicsStepSeconds)
+	{
+		stats.m_numDroppedTicks = static_cast<int>(m_physicsAccumulatorSeconds / m_physicsStepSeconds);
+		m_physicsAccumulatorSeconds -= static_cast<float>(stats.m_numDroppedTicks) * m_physicsStepSeconds;
+	}
 
-//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Map::ActorUpdate()
-{
-	for(size_t actorIndex = 0; actorIndex < m_allActors.size(); ++actorIndex)
+	float tickFraction = m_physicsAccumulatorSeconds / m_physicsStepSeconds;
+
+	for(Actor* actor : m_allActors)
 	{
-		if(m_allActors[actorIndex] && m_allActors[actorIndex]->m_state != ActorState::DEAD && m_allActors[actorIndex]->m_state != ActorState::DYING)
+		if(actor)
 		{
-			m_allActors[actorIndex]->Update();
+			actor->m_acceleration = Vec3::ZERO;
+			actor->UpdateRenderPosition(tickFraction);
 		}
 	}
+
+	stats.m_stepMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+	m_lastPhysicsStepStats = stats;
+	m_peakPhysicsStepStats.m_numTicks		  = stats.m_numTicks > m_peakPhysicsStepStats.m_numTicks ? stats.m_numTicks : m_peakPhysicsStepStats.m_numTicks;
+	m_peakPhysicsStepStats.m_numDroppedTicks  += stats.m_numDroppedTicks;
+	m_peakPhysicsStepStats.m_stepMilliseconds = stats.m_stepMilliseconds > m_peakPhysicsStepStats.m_stepMilliseconds ? stats.m_stepMilliseconds : m_peakPhysicsStepStats.m_stepMilliseconds;
+	m_totalPhysicsStepMilliseconds += stats.m_stepMilliseconds;
+	m_numPhysicsStatFrames += 1;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Map::PhysicsUpdate()
 {
+	m_physicsSystem.Gather(m_allActors);
+	m_physicsSystem.Integrate(m_physicsStepSeconds);
+	m_physicsSystem.Scatter(m_allActors);
+
+	RebuildActorGrid();
+	CheckForCollisions();
+
+	m_actorColliders.Refresh(m_allActors);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Map::RebuildActorGrid()
+{
+	m_actorGridCellIndices.assign(m_allActors.size(), -1);
+	m_maxActorRadius = 0.f;
+
 	for(size_t actorIndex = 0; actorIndex < m_allActors.size(); ++actorIndex)
 	{
-		if(m_allActors[actorIndex] && m_allActors[actorIndex]->m_state != ActorState::DEAD)
+		Actor* actor = m_allActors[actorIndex];
+
+		// dead and zero radius actors stay binned too, since the full scans this grid replaces never skipped them
+		if(actor)
 		{
-			m_allActors[actorIndex]->PhysicsUpdate();
+			m_actorGridCellIndices[actorIndex] = m_actorGrid.GetCellIndexForPosition(actor->m_position.GetXY2D());
+
+			if(actor->m_definition->m_physicsRadius > m_maxActorRadius)
+			{
+				m_maxActorRadius = actor->m_definition->m_physicsRadius;
+			}
 		}
 	}
 
-	CheckForCollisions();
+	m_actorGrid.Rebuild(m_actorGridCellIndices);
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -598,8 +928,7 @@ void Map::ManageDeadActors()
 
 			if(m_allActors[index] && m_allActors[index]->m_state == ActorState::DEAD)
 			{
-				delete m_allActors[index];
-				m_allActors[index] = nullptr;
+				DestroyActor(static_cast<int>(index));
 			}
 		}
 	}
@@ -640,19 +969,48 @@ void Map::CheckForCollisions()
 
 			CheckActorVsActorCollision(currentActor);
 			CheckActorVsMapCollision(currentActor);
+
+			// a push can carry the actor into another cell; the pending list keeps it visible to the queries after it
+			if(actorIndex < m_actorGridCellIndices.size() && m_actorGridCellIndices[actorIndex] >= 0)
+			{
+				int cellIndex = m_actorGrid.GetCellIndexForPosition(currentActor->m_position.GetXY2D());
+
+				if(cellIndex != m_actorGridCellIndices[actorIndex])
+				{
+					m_actorGridCellIndices[actorIndex] = cellIndex;
+					m_actorGrid.AddPending(static_cast<int>(actorIndex));
+				}
+			}
 		}
 	}
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Map::CheckActorVsActorCollision(Actor* collidingActor)
+{
+	// only actors in the grid cells the two cylinders could share are tested, visited in slot order like the full scan was
+	float queryRadius = collidingActor->m_definition->m_physicsRadius + m_maxActorRadius;
+	Vec2 queryCenter = collidingActor->m_position.GetXY2D();
+
+	m_actorCandidates.clear();
+	m_actorGrid.GetActorSlotsInBox(queryCenter - Vec2(queryRadius, queryRadius), queryCenter + Vec2(queryRadius, queryRadius), m_actorCandidates);
+
+	std::sort(m_actorCandidates.begin(), m_actorCandidates.end());
+	m_actorCandidates.erase(std::unique(m_actorCandidates.begin(), m_actorCandidates.end()), m_actorCandidates.end());
+
+	CheckActorVsActorCollision(collidingActor, m_actorCandidates);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Tests the candidates in the order given, which must be ascending slot order for pushes to match the full scan
+void Map::CheckActorVsActorCollision(Actor* collidingActor, std::vector<int> const& candidateSlots)
 {
 	Cylinder3D collisionCylinder;
 	collisionCylinder.m_startPosition = collidingActor->m_position;
 	collisionCylinder.m_height = collidingActor->m_definition->m_physicsHeight;
 	collisionCylinder.m_radius = collidingActor->m_definition->m_physicsRadius;
 
-	for(size_t actorIndex = 0; actorIndex < m_allActors.size(); ++actorIndex)
+	for(int actorIndex : candidateSlots)
 	{
 		if(m_allActors[actorIndex] && m_allActors[actorIndex]->m_definition->m_physicsSimulated)
 		{
@@ -667,7 +1025,7 @@ void Map::CheckActorVsActorCollision(Actor* collidingActor)
 
 			bool collidingOwner = (collidingActor->m_owner && collidingActor->m_owner == otherActor);
 			bool collidingChild = (otherActor->m_owner && otherActor->m_owner == collidingActor);
-			bool projectileCollision = (collidingActor->m_definition->m_name == "PlasmaProjectile") && (otherActor->m_definition->m_name == "PlasmaProjectile");
+			bool projectileCollision = collidingActor->m_definition->IsProjectile() && otherActor->m_definition->IsProjectile();
 
 			if(collidingSelf || collidingOwner || collidingChild || projectileCollision)
 			{
@@ -680,6 +1038,11 @@ void Map::CheckActorVsActorCollision(Actor* collidingActor)
 				Vec2 fixedDiscCenter = Vec2(otherActor->m_position.x, otherActor->m_position.y);
 				PushDiscsOutOfEachOther2D(mobileDiscCenter, collisionCylinder.m_radius, fixedDiscCenter, otherCollisionCylinder.m_radius);
 
+				if(m_collisionPairLog)
+				{
+					m_collisionPairLog->push_back(IntVec2(static_cast<int>(collidingActor->m_handle.GetIndex()), actorIndex));
+				}
+
 				collidingActor->OnCollide(otherActor);
 
 				collidingActor->m_position.x = mobileDiscCenter.x;
@@ -692,22 +1055,42 @@ void Map::CheckActorVsActorCollision(Actor* collidingActor)
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Map::CheckActorVsMapCollision(Actor* actor)
 {
+	// same neighbour order as the old eight-surrounding-tiles list: +x, -x, +y, -y, then the diagonals
+	static IntVec2 const s_neighborOffsets[8] =
+	{
+		IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1),
+		IntVec2(1, 1), IntVec2(1, -1), IntVec2(-1, 1), IntVec2(-1, -1)
+	};
+
 	Cylinder3D collisionCylinder;
 	collisionCylinder.m_startPosition = actor->m_position;
 	collisionCylinder.m_height = actor->m_definition->m_physicsHeight;
 	collisionCylinder.m_radius = actor->m_definition->m_physicsRadius;
 
-	std::vector<Tile> eightSurroundingTiles = GetEightSurroundingTiles(static_cast<int>(actor->m_position.x), static_cast<int>(actor->m_position.y));
+	IntVec2 actorTileCoord = IntVec2(static_cast<int>(actor->m_position.x), static_cast<int>(actor->m_position.y));
 
-	// wall check
-	for(size_t tileIndex = 0; tileIndex < eightSurroundingTiles.size(); ++tileIndex)
+	for(int neighborIndex = 0; neighborIndex < 8; ++neighborIndex)
 	{
-		if(eightSurroundingTiles[tileIndex].IsTileSolid())
+		IntVec2 tileCoord = actorTileCoord + s_neighborOffsets[neighborIndex];
+
+		if(!DoesTileExist(tileCoord))
+		{
+			continue;
+		}
+
+		int tileIndex = GetTileIndexForTileCoord(tileCoord);
+
+		// wall check
+		if(m_tileFlags[tileIndex] & TILE_FLAG_SOLID)
 		{
-			if(DoesCylinderAndBoxOverlap(collisionCylinder, eightSurroundingTiles[tileIndex].GetTileBounds()))
+			AABB3 tileBounds;
+			tileBounds.m_mins = Vec3(static_cast<float>(tileCoord.x), static_cast<float>(tileCoord.y), 0.f);
+			tileBounds.m_maxs = tileBounds.m_mins + Vec3(1.f, 1.f, GetTileHeight(tileIndex));
+
+			if(DoesCylinderAndBoxOverlap(collisionCylinder, tileBounds))
 			{
 				Vec2 mobileDiscCenter = Vec2(actor->m_position.x, actor->m_position.y);
-				AABB2 tileBox = AABB2(eightSurroundingTiles[tileIndex].GetTileBounds().m_mins.x, eightSurroundingTiles[tileIndex].GetTileBounds().m_mins.y, eightSurroundingTiles[tileIndex].GetTileBounds().m_maxs.x, eightSurroundingTiles[tileIndex].GetTileBounds().m_maxs.y);
+				AABB2 tileBox = AABB2(tileBounds.m_mins.x, tileBounds.m_mins.y, tileBounds.m_maxs.x, tileBounds.m_maxs.y);
 				PushDiscOutOfAABB2D(mobileDiscCenter, collisionCylinder.m_radius, tileBox);
 
 				actor->m_position.x = mobileDiscCenter.x;
@@ -719,20 +1102,17 @@ void Map::CheckActorVsMapCollision(Actor* actor)
 		}
 		else
 		{
-			// ceiling and floor check
-			AABB3 tileBounds = eightSurroundingTiles[tileIndex].GetTileBounds();
-
+			// ceiling and floor check, every tile's floor sits at z = 0
 			Vec3 startPosition = collisionCylinder.m_startPosition;
-			Vec3 endPosition = collisionCylinder.GetEndPosition();
 
-			if(startPosition.z < tileBounds.m_mins.z)
+			if(startPosition.z < 0.f)
 			{
-				actor->m_position.z = tileBounds.m_mins.z;
+				actor->m_position.z = 0.f;
 				actor->OnCollide();
 				actor->m_isGrounded = true;
 				actor->m_velocity.z = 0.f;
 			}
-			else if(startPosition.z > tileBounds.m_mins.z)
+			else if(startPosition.z > 0.f)
 			{
 				actor->m_isGrounded = false;
 			}
@@ -758,14 +1138,16 @@ void Map::Render(Camera const& camera)
 	
 	g_theRenderer->ClearScreen(clearColor);
 	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetLightConstants(m_directionalLight, m_allLights, m_game->m_playerControllers[0]->m_position, m_ambientIntensity);
+	m_lightCuller.SelectLights(m_allLights, camera, m_cameraLights);
+
+	g_theRenderer->SetLightConstants(m_directionalLight, m_cameraLights, camera.GetPosition(), m_ambientIntensity);
 	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
 	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
 	g_theRenderer->SetBlendMode(BlendMode::OPAQUE);
 	g_theRenderer->BindShader(m_mapDef->m_mapShader);
 	g_theRenderer->BindTexture(m_mapDef->m_spriteSheetTexture);
-	g_theRenderer->DrawIndexedVertexBuffer(m_vbo, m_ibo, static_cast<unsigned int>(m_indexes.size()));
+	RenderMapChunks(camera);
 
 	g_theRenderer->BeginRenderEvent("Actor Render");
 	RenderAllActors(camera);
@@ -774,13 +1156,13 @@ void Map::Render(Camera const& camera)
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Map::RenderDepth() const
+void Map::RenderDepth(Camera const& depthCamera) const
 {
 	g_theRenderer->SetModelConstants();
 	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
  	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
 	g_theRenderer->SetBlendMode(BlendMode::OPAQUE);
-	g_theRenderer->DrawIndexedVertexBuffer(m_vbo, m_ibo, static_cast<unsigned int>(m_indexes.size()));
+	RenderMapChunks(depthCamera);
 
 	for(size_t actorIndex = 0; actorIndex < m_allActors.size(); ++actorIndex)
 	{
@@ -792,15 +1174,64 @@ void Map::RenderDepth() const
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Map::RenderAllActors(Camera const& camera) const
+MapChunkStats Map::RenderMapChunks(Camera const& camera) const
 {
+	Frustum frustum = Frustum(camera);
+	MapChunkStats stats;
+
+	for(MapChunk const& chunk : m_chunks)
+	{
+		stats.m_numChunksTotal += 1;
+		stats.m_numTrianglesTotal += static_cast<int>(chunk.m_numIndexes / 3);
+
+		if(!frustum.DoesOverlapAABB3(chunk.m_bounds))
+		{
+			continue;
+		}
+
+		g_theRenderer->DrawIndexedVertexBuffer(chunk.m_vbo, chunk.m_ibo, chunk.m_numIndexes);
+
+		stats.m_numChunksSubmitted += 1;
+		stats.m_numTrianglesSubmitted += static_cast<int>(chunk.m_numIndexes / 3);
+	}
+
+	return stats;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+MapChunkStats Map::GetVisibleChunkStats(Camera const& camera) const
+{
+	Frustum frustum = Frustum(camera);
+	MapChunkStats stats;
+
+	for(MapChunk const& chunk : m_chunks)
+	{
+		int numTriangles = static_cast<int>(chunk.m_numIndexes / 3);
+		bool isVisible = frustum.DoesOverlapAABB3(chunk.m_bounds);
+
+		stats.m_numChunksTotal += 1;
+		stats.m_numTrianglesTotal += numTriangles;
+		stats.m_numChunksSubmitted += isVisible ? 1 : 0;
+		stats.m_numTrianglesSubmitted += isVisible ? numTriangles : 0;
+	}
+
+	return stats;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Map::RenderAllActors(Camera const& camera)
+{
+	m_actorBatchRenderer.BeginBatches();
+
 	for(size_t actorIndex = 0; actorIndex < m_allActors.size(); ++actorIndex)
 	{
 		if(m_allActors[actorIndex])
 		{
-			m_allActors[actorIndex]->Render(camera);
+			m_actorBatchRenderer.AddActor(*m_allActors[actorIndex], camera);
 		}
 	}
+
+	m_actorBatchRenderer.RenderBatches();
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -850,47 +1281,103 @@ void Map::SpawnPlayer()
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// A marine at a random spawn point driven by its own AI controller, standing in for a player in headless runs
+Actor* Map::SpawnBot()
+{
+	IntRange spawnPointIndexRange = IntRange(0, static_cast<int>(m_allSpawnPoints.size()) - 1);
+
+	int randomSpawnPointIndex = spawnPointIndexRange.GetRandomInt();
+
+	SpawnInfo botSpawnInfo;
+	botSpawnInfo.m_actorName = "Marine";
+	botSpawnInfo.m_position = m_allSpawnPoints[randomSpawnPointIndex]->m_position;
+	botSpawnInfo.m_orientation = m_allSpawnPoints[randomSpawnPointIndex]->m_orientation;
+
+	Actor* botActor = SpawnActor(botSpawnInfo);
+
+	// pooled marines keep the controller they were given and Respawn re-possesses with it
+	if(!botActor->m_aiController)
+	{
+		botActor->m_aiController = new AIController(this);
+		botActor->m_aiController->Possess(botActor);
+	}
+
+	return botActor;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Drops a demon somewhere on a random open tile, for load tests that want far more demons than the map spawns
+Actor* Map::SpawnDemon()
+{
+	IntRange tileIndexRange = IntRange(0, static_cast<int>(m_tiles.size()) - 1);
+	FloatRange offsetRange = FloatRange(0.2f, 0.8f);
+
+	int tileIndex = tileIndexRange.GetRandomInt();
+
+	while(!m_tiles[tileIndex].HasDefinition() || m_tiles[tileIndex].IsTileSolid())
+	{
+		tileIndex = tileIndexRange.GetRandomInt();
+	}
+
+	SpawnInfo demonSpawnInfo;
+	demonSpawnInfo.m_actorName = "Demon";
+	demonSpawnInfo.m_position = Vec3(static_cast<float>(tileIndex % m_bounds.x) + offsetRange.GetRandomFloat(), static_cast<float>(tileIndex / m_bounds.x) + offsetRange.GetRandomFloat(), 0.f);
+	demonSpawnInfo.m_orientation = EulerAngles(FloatRange(0.f, 360.f).GetRandomFloat(), 0.f, 0.f);
+
+	return SpawnActor(demonSpawnInfo);
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 Actor* Map::SpawnActor(SpawnInfo const& spawnInfo)
 {
-	ActorHandle handle;
-	
-	for(size_t index = 0; index < m_allActors.size(); ++index)
+	ActorDefinition* actorDef = nullptr;
+
+	if(spawnInfo.m_actorDefID != INVALID_ACTOR_DEFINITION_ID)
 	{
-		if(!m_allActors[index])
-		{
-			handle = ActorHandle(m_currentUID, static_cast<int>(index));
-			Actor* actor = new Actor(this, spawnInfo.m_actorName, spawnInfo.m_position, spawnInfo.m_orientation, handle);
+		actorDef = &ActorDefinition::s_actorDefinitions[spawnInfo.m_actorDefID];
+	}
+	else
+	{
+		actorDef = ActorDefinition::GetActorDefinitionByName(spawnInfo.m_actorName);
+	}
 
-			if(spawnInfo.m_actorName == "SpawnPoint")
-			{
-				AddActorToList(actor, m_allSpawnPoints);
-				m_currentUID += 1;
-				return actor;
-			}
+	GUARANTEE_OR_DIE(actorDef, Stringf("Tried to spawn unknown actor: %s. Map::SpawnActor", spawnInfo.m_actorName.c_str()));
 
-			actor->m_velocity = spawnInfo.m_velocity;
+	// spawn points are only looked up by list position, so they never take a slot in m_allActors
+	if(actorDef->IsSpawnPoint())
+	{
+		ActorHandle handle = ActorHandle(GetNextActorUID(), static_cast<unsigned int>(m_allSpawnPoints.size()));
+		Actor* spawnPoint = new Actor(this, actorDef, spawnInfo.m_position, spawnInfo.m_orientation, handle);
 
-			AddActorToList(actor, m_allActors);
-			m_currentUID += 1;
-			return actor;
-		}
+		m_allSpawnPoints.push_back(spawnPoint);
+		return spawnPoint;
 	}
 
-	handle = ActorHandle(m_currentUID, static_cast<int>(m_allActors.size()));
-	Actor* actor = new Actor(this, spawnInfo.m_actorName, spawnInfo.m_position, spawnInfo.m_orientation, handle);
+	unsigned int slot = AllocateActorSlot();
+
+	ActorHandle handle = ActorHandle(GetNextActorUID(), slot);
+	Actor* actor = nullptr;
+
+	ActorList& freeActors = m_actorPools[actorDef->m_id].m_freeActors;
 
- 	if(spawnInfo.m_actorName == "SpawnPoint")
- 	{
- 		AddActorToList(actor, m_allSpawnPoints);
- 		m_currentUID += 1;
- 		return actor;
- 	}
+	if(!freeActors.empty())
+	{
+		actor = freeActors.back();
+		freeActors.pop_back();
+
+		actor->Respawn(spawnInfo.m_position, spawnInfo.m_orientation, handle);
+	}
+	else
+	{
+		actor = new Actor(this, actorDef, spawnInfo.m_position, spawnInfo.m_orientation, handle);
+	}
 
 	actor->m_velocity = spawnInfo.m_velocity;
 
-	AddActorToList(actor, m_allActors);
-	m_currentUID += 1;
+	m_allActors[slot] = actor;
+	m_actorColliders.SetSlot(static_cast<int>(slot), *actor);
+	AddActorToGrid(actor);
 
 	if(actor->m_definition->m_isLightSource)
 	{
@@ -900,6 +1387,97 @@ Actor* Map::SpawnActor(SpawnInfo const& spawnInfo)
 	return actor;
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Map::DestroyActor(int actorSlot)
+{
+	Actor* actor = m_allActors[actorSlot];
+	ActorPool& actorPool = m_actorPools[actor->m_definition->m_id];
+
+	if(actorPool.m_isEnabled)
+	{
+		actorPool.m_freeActors.push_back(actor);
+	}
+	else
+	{
+		delete actor;
+	}
+
+	m_allActors[actorSlot] = nullptr;
+	m_actorColliders.ClearSlot(actorSlot);
+
+	m_freeActorSlots.push_back(static_cast<unsigned int>(actorSlot));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Map::PrewarmActorPools()
+{
+	m_actorPools.resize(ActorDefinition::s_actorDefinitions.size());
+
+	for(ActorPoolInfo const& actorPoolInfo : m_mapDef->m_actorPools)
+	{
+		ActorDefinition* actorDef = ActorDefinition::GetActorDefinitionByName(actorPoolInfo.m_actorName);
+
+		if(!actorDef)
+		{
+			ERROR_RECOVERABLE(Stringf("Actor pool for unknown actor: %s. Map::PrewarmActorPools", actorPoolInfo.m_actorName.c_str()));
+			continue;
+		}
+
+		ActorPool& actorPool = m_actorPools[actorDef->m_id];
+		actorPool.m_isEnabled = true;
+		actorPool.m_freeActors.reserve(actorPoolInfo.m_size);
+
+		for(int poolIndex = 0; poolIndex < actorPoolInfo.m_size; ++poolIndex)
+		{
+			actorPool.m_freeActors.push_back(new Actor(this, actorDef));
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned int Map::AllocateActorSlot()
+{
+	// freed slots are reused last-in first-out; a fresh slot is only appended when none are free
+	if(!m_freeActorSlots.empty())
+	{
+		unsigned int slot = m_freeActorSlots.back();
+		m_freeActorSlots.pop_back();
+
+		return slot;
+	}
+
+	unsigned int slot = static_cast<unsigned int>(m_allActors.size());
+	GUARANTEE_OR_DIE(slot < ActorHandle::MAX_ACTOR_INDEX, "Map::AllocateActorSlot: out of actor slots, ActorHandle can only address 65535");
+
+	m_allActors.push_back(nullptr);
+
+	return slot;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned int Map::GetNextActorUID()
+{
+	// uids cycle through 0..MAX_ACTOR_UID so a live handle can never collide with ActorHandle::INVALID
+	unsigned int uid = m_currentUID;
+
+	m_currentUID = (m_currentUID >= ActorHandle::MAX_ACTOR_UID) ? 0 : m_currentUID + 1;
+
+	return uid;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Map::AddActorToGrid(Actor* actor)
+{
+	float radius = actor->m_definition->m_physicsRadius;
+
+	m_actorGrid.AddPending(actor->m_handle.GetIndex());
+
+	if(radius > m_maxActorRadius)
+	{
+		m_maxActorRadius = radius;
+	}
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 Actor* Map::GetActorByHandle(ActorHandle const& handle)
 {
@@ -908,9 +1486,9 @@ Actor* Map::GetActorByHandle(ActorHandle const& handle)
 		return nullptr;
 	}
 
- 	int actorIndex = handle.GetIndex();
+ 	unsigned int actorIndex = handle.GetIndex();
 
-	if(!m_allActors[actorIndex])
+	if(actorIndex >= m_allActors.size() || !m_allActors[actorIndex])
 	{
 		return nullptr;
 	}
@@ -926,26 +1504,54 @@ Actor* Map::GetActorByHandle(ActorHandle const& handle)
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Map::AddActorToList(Actor* actor, std::vector<Actor*>& actorList)
+static unsigned int HashStateBits(unsigned int hash, unsigned int bits)
+{
+	return (hash ^ bits) * 16777619u;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static unsigned int HashStateFloat(unsigned int hash, float value)
+{
+	unsigned int bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+
+	return HashStateBits(hash, bits);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// FNV-1a over every actor slot's simulation state, bit for bit. Two runs of the same match only hash the same if they
+// stayed identical the whole way, which is what the headless thread scaling runs check.
+unsigned int Map::GetStateHash() const
 {
-	bool isAdded = false;
+	unsigned int hash = 2166136261u;
 
-	for(size_t actorIndex = 0; actorIndex < actorList.size(); ++actorIndex)
+	for(Actor const* actor : m_allActors)
 	{
-		isAdded = false;
+		if(!actor)
+		{
+			hash = HashStateBits(hash, 0xffffffffu);
+			continue;
+		}
 
-		if(actorList[actorIndex] == nullptr)
+		hash = HashStateBits(hash, static_cast<unsigned int>(actor->m_definition->m_id));
+		hash = HashStateBits(hash, static_cast<unsigned int>(actor->m_state));
+		hash = HashStateFloat(hash, actor->m_health);
+		hash = HashStateFloat(hash, actor->m_position.x);
+		hash = HashStateFloat(hash, actor->m_position.y);
+		hash = HashStateFloat(hash, actor->m_position.z);
+		hash = HashStateFloat(hash, actor->m_velocity.x);
+		hash = HashStateFloat(hash, actor->m_velocity.y);
+		hash = HashStateFloat(hash, actor->m_velocity.z);
+		hash = HashStateFloat(hash, actor->m_orientation.m_yawDegrees);
+		hash = HashStateFloat(hash, actor->m_orientation.m_pitchDegrees);
+
+		if(actor->m_aiController)
 		{
-			actorList[actorIndex] = actor;
-			isAdded = true;
-			break;
+			hash = HashStateBits(hash, actor->m_aiController->m_targetActorHandle.GetIndex());
 		}
 	}
 
-	if(isAdded == false)
-	{
-		actorList.push_back(actor);
-	}
+	return hash;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -960,6 +1566,23 @@ bool Map::DoesTileExist(IntVec2 const& tileCoord)
 	return (tileCoord.x >= 0 && tileCoord.y >= 0 && tileCoord.x < m_bounds.x && tileCoord.y < m_bounds.y);
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Map::IsTileSolid(IntVec2 const& tileCoord) const
+{
+	if(tileCoord.x < 0 || tileCoord.y < 0 || tileCoord.x >= m_bounds.x || tileCoord.y >= m_bounds.y)
+	{
+		return false;
+	}
+
+	return (m_tileFlags[(tileCoord.y * m_bounds.x) + tileCoord.x] & TILE_FLAG_SOLID) != 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+float Map::GetTileHeight(int tileIndex) const
+{
+	return static_cast<float>((m_tileFlags[tileIndex] & TILE_FLAG_HEIGHT_MASK) >> TILE_FLAG_HEIGHT_SHIFT);
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 int Map::GetActorIndexInList(Actor* actor, ActorList const& actorList)
 {
@@ -1006,8 +1629,14 @@ Actor* Map::GetClosestVisibleActor(Actor* searchingActor)
 
 	for(Actor* actor : m_allActors)
 	{
-		if(actor && (searchingActor != actor) && (searchingActor->m_definition->m_faction != actor->m_definition->m_faction) && (actor->m_definition->m_faction != Faction::NEUTRAL) && (actor->m_definition->m_name != "PlasmaProjectile"))
+		if(actor && (searchingActor != actor) && (searchingActor->m_definition->m_faction != actor->m_definition->m_faction) && (actor->m_definition->m_faction != Faction::NEUTRAL) && !actor->m_definition->IsProjectile())
 		{
+			// one bit test rules out targets behind static walls before any of the geometry below
+			if(m_useTileVisibility && m_tileVisibility.IsBuilt() && !m_tileVisibility.IsPositionVisibleFromPosition(searchingActor->m_position.GetXY2D(), actor->m_position.GetXY2D()))
+			{
+				continue;
+			}
+
 			Cylinder3D actorCylinder = Cylinder3D(actor->m_position, actor->m_definition->m_physicsHeight, actor->m_definition->m_physicsRadius);
 
 			Vec3 nearestPoint = GetNearestPointOnCylinder3D(searchingActor->GetEyePosition(), actorCylinder);
@@ -1043,68 +1672,67 @@ Actor* Map::GetClosestVisibleActor(Actor* searchingActor)
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-std::vector<Tile> Map::GetEightSurroundingTiles(int posX, int posY)
+// One field per player; a field is only rebuilt when its player's actor changes or steps into a different tile
+void Map::UpdatePlayerFlowFields()
 {
-	std::vector<Tile> eightSurroundingTiles;
-
-	IntVec2 frontTileCoord		= IntVec2(posX + 1, posY);
-	IntVec2 backTileCoord		= IntVec2(posX - 1, posY);
-	IntVec2 leftTileCoord		= IntVec2(posX, posY + 1);
-	IntVec2 rightTileCoord		= IntVec2(posX, posY - 1);
-	IntVec2 frontLeftTileCoord	= IntVec2(posX + 1, posY + 1);
-	IntVec2 frontRightTileCoord = IntVec2(posX + 1, posY - 1);
-	IntVec2 backLeftTileCoord	= IntVec2(posX - 1, posY + 1);
-	IntVec2 backRightTileCoord	= IntVec2(posX - 1, posY - 1);
-
-	if(DoesTileExist(frontTileCoord))
-	{	
-		int tileIndex = GetTileIndexForTileCoord(frontTileCoord);
-		eightSurroundingTiles.push_back(m_tiles[tileIndex]);
-	}
-
-	if(DoesTileExist(backTileCoord))
-	{
-		int tileIndex = GetTileIndexForTileCoord(backTileCoord);
-		eightSurroundingTiles.push_back(m_tiles[tileIndex]);
-	}
-	
-	if(DoesTileExist(leftTileCoord))
-	{
-		int tileIndex = GetTileIndexForTileCoord(leftTileCoord);
-		eightSurroundingTiles.push_back(m_tiles[tileIndex]);
-	}
-	
-	if(DoesTileExist(rightTileCoord))
+	while(m_playerFlowFields.size() < m_game->m_playerControllers.size())
 	{
-		int tileIndex = GetTileIndexForTileCoord(rightTileCoord);
-		eightSurroundingTiles.push_back(m_tiles[tileIndex]);
+		m_playerFlowFields.emplace_back();
+		m_playerFlowFields.back().m_field.Initialize(m_tileFlags, m_bounds);
 	}
 
-	if(DoesTileExist(frontLeftTileCoord))
+	for(size_t controllerIndex = 0; controllerIndex < m_game->m_playerControllers.size(); ++controllerIndex)
 	{
-		int tileIndex = GetTileIndexForTileCoord(frontLeftTileCoord);
-		eightSurroundingTiles.push_back(m_tiles[tileIndex]);
+		PlayerFlowField& playerFlowField = m_playerFlowFields[controllerIndex];
+		PlayerController* playerController = m_game->m_playerControllers[controllerIndex];
+		Actor* playerActor = playerController ? playerController->GetActor() : nullptr;
+
+		if(!playerActor || !playerActor->IsAlive())
+		{
+			playerFlowField.m_targetHandle = ActorHandle::INVALID;
+			continue;
+		}
+
+		IntVec2 playerTile = IntVec2(static_cast<int>(floorf(playerActor->m_position.x)), static_cast<int>(floorf(playerActor->m_position.y)));
+
+		if(playerFlowField.m_targetHandle != playerActor->m_handle || playerFlowField.m_field.GetGoalTile() != playerTile)
+		{
+			playerFlowField.m_targetHandle = playerActor->m_handle;
+			playerFlowField.m_field.SetGoalTile(playerTile);
+		}
 	}
+}
 
-	if(DoesTileExist(frontRightTileCoord))
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Only player actors have fields; demons chasing anything else walk straight at it
+FlowField const* Map::GetFlowFieldToActor(Actor const* targetActor) const
+{
+	if(!targetActor)
 	{
-		int tileIndex = GetTileIndexForTileCoord(frontRightTileCoord);
-		eightSurroundingTiles.push_back(m_tiles[tileIndex]);
+		return nullptr;
 	}
 
-	if(DoesTileExist(backLeftTileCoord))
+	for(PlayerFlowField const& playerFlowField : m_playerFlowFields)
 	{
-		int tileIndex = GetTileIndexForTileCoord(backLeftTileCoord);
-		eightSurroundingTiles.push_back(m_tiles[tileIndex]);
+		if(playerFlowField.m_targetHandle == targetActor->m_handle)
+		{
+			return &playerFlowField.m_field;
+		}
 	}
 
-	if(DoesTileExist(backRightTileCoord))
+	return nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Headless runs have no font or window, so capture progress only shows in windowed games
+void Map::AddCaptureText(std::string const& text)
+{
+	if(!g_gameFont)
 	{
-		int tileIndex = GetTileIndexForTileCoord(backRightTileCoord);
-		eightSurroundingTiles.push_back(m_tiles[tileIndex]);
+		return;
 	}
 
-	return eightSurroundingTiles;
+	g_gameFont->AddVertsForTextInBox2D(m_textVerts, text, AABB2(Vec2::ZERO, g_theWindow->GetClientDimensions().GetAsVec2()), 18.f, Rgba8::GREEN, 1.f, Vec2(0.01f, 0.98f), SHRINK_TO_FIT);
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1151,7 +1779,7 @@ void Map::CheckGoalConditions()
 
 		std::string capture = Stringf("Capturing Green : %0.2f", m_greenCapturePercent);
 
-		g_gameFont->AddVertsForTextInBox2D(m_textVerts, capture, AABB2(Vec2::ZERO, g_theWindow->GetClientDimensions().GetAsVec2()), 18.f, Rgba8::GREEN, 1.f, Vec2(0.01f, 0.98f), SHRINK_TO_FIT);
+		AddCaptureText(capture);
 
 	}
 	else if(!m_isGreenCaptured)
@@ -1165,7 +1793,7 @@ void Map::CheckGoalConditions()
 
 		std::string capture = Stringf("Capturing Yellow : %0.2f", m_yellowCapturePercent);
 
-		g_gameFont->AddVertsForTextInBox2D(m_textVerts, capture, AABB2(Vec2::ZERO, g_theWindow->GetClientDimensions().GetAsVec2()), 18.f, Rgba8::GREEN, 1.f, Vec2(0.01f, 0.98f), SHRINK_TO_FIT);
+		AddCaptureText(capture);
 
 	}
 	else if(!m_isYellowCaptured)
@@ -1179,7 +1807,7 @@ void Map::CheckGoalConditions()
 
 		std::string capture = Stringf("Capturing Red : %0.2f", m_redCapturePercent);
 
-		g_gameFont->AddVertsForTextInBox2D(m_textVerts, capture, AABB2(Vec2::ZERO, g_theWindow->GetClientDimensions().GetAsVec2()), 18.f, Rgba8::GREEN, 1.f, Vec2(0.01f, 0.98f), SHRINK_TO_FIT);
+		AddCaptureText(capture);
 
 	}
 	else if(!m_isRedCaptured)
@@ -1194,7 +1822,7 @@ void Map::CheckGoalConditions()
 
 		std::string capture = Stringf("Capturing Blue : %0.2f", m_blueCapturePercent);
 
-		g_gameFont->AddVertsForTextInBox2D(m_textVerts, capture, AABB2(Vec2::ZERO, g_theWindow->GetClientDimensions().GetAsVec2()), 18.f, Rgba8::GREEN, 1.f, Vec2(0.01f, 0.98f), SHRINK_TO_FIT);
+		AddCaptureText(capture);
 
 	}
 	else if(!m_isBlueCaptured)
@@ -1281,7 +1909,7 @@ void Map::CheckGoalConditions()
 
 			std::string capture = Stringf("Capturing Courtyard : %0.2f", m_courtyardCapturePercent);
 
-			g_gameFont->AddVertsForTextInBox2D(m_textVerts, capture, AABB2(Vec2::ZERO, g_theWindow->GetClientDimensions().GetAsVec2()), 18.f, Rgba8::GREEN, 1.f, Vec2(0.01f, 0.98f), SHRINK_TO_FIT);
+			AddCaptureText(capture);
 
 		}
 		else if(!m_isCourtyardCaptured)
@@ -1303,28 +1931,90 @@ void Map::CheckGoalConditions()
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 RaycastResult Map::RaycastAll(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, Actor* firingActor)
 {
+	// walls first: nothing past the first wall can be hit, so the floor and actor tests only run up to it
+	RaycastResult closestRaycast = RaycastVsWalls(startPosition, fwdNormal, distance);
+	float clampedDistance = closestRaycast.m_rayResult.m_didImpact ? closestRaycast.m_rayResult.m_impactDistance : distance;
 
-	RaycastResult closestRaycast;
-	RaycastResult raycastVsActors  = RaycastVsActors(startPosition, fwdNormal, distance, firingActor);
-	RaycastResult raycastVsFloor   = RaycastVsFloor(startPosition, fwdNormal, distance);
-	RaycastResult raycastVsWalls   = RaycastVsWalls(startPosition, fwdNormal, distance);
+	RaycastResult raycastVsFloor = RaycastVsFloor(startPosition, fwdNormal, clampedDistance);
 
-	if(raycastVsActors.m_rayResult.m_impactDistance < raycastVsFloor.m_rayResult.m_impactDistance && raycastVsActors.m_rayResult.m_impactDistance < raycastVsWalls.m_rayResult.m_impactDistance)
-	{
-		closestRaycast = raycastVsActors;
-	} 
-	else if(raycastVsFloor.m_rayResult.m_impactDistance < raycastVsWalls.m_rayResult.m_impactDistance)
+	if(raycastVsFloor.m_rayResult.m_didImpact && raycastVsFloor.m_rayResult.m_impactDistance < clampedDistance)
 	{
 		closestRaycast = raycastVsFloor;
+		clampedDistance = raycastVsFloor.m_rayResult.m_impactDistance;
 	}
-	else
+
+	RaycastResult raycastVsActors = RaycastVsActors(startPosition, fwdNormal, clampedDistance, firingActor);
+
+	if(raycastVsActors.m_rayResult.m_didImpact && raycastVsActors.m_rayResult.m_impactDistance < clampedDistance)
 	{
-		closestRaycast = raycastVsWalls;
+		closestRaycast = raycastVsActors;
 	}
 
+	closestRaycast.m_rayResult.m_rayMaxLength = distance;
+
 	return closestRaycast;
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Same results as calling RaycastAll once per ray, but the actor candidates along all the rays are gathered and packed
+// once and every ray runs the SIMD cylinder kernel over that one shared batch.
+void Map::RaycastBatch(std::vector<RayQuery> const& rays, std::vector<RaycastResult>& out_results, Actor* firingActor)
+{
+	int numRays = static_cast<int>(rays.size());
+
+	RaycastScratch& scratch = GetRaycastScratch();
+
+	out_results.resize(numRays);
+	scratch.m_batchDistances.resize(numRays);
+	scratch.m_actorCandidates.clear();
+
+	for(int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		RayQuery const& ray = rays[rayIndex];
+		RaycastResult& closestRaycast = out_results[rayIndex];
+
+		closestRaycast = RaycastVsWalls(ray.m_startPosition, ray.m_fwdNormal, ray.m_distance);
+		float clampedDistance = closestRaycast.m_rayResult.m_didImpact ? closestRaycast.m_rayResult.m_impactDistance : ray.m_distance;
+
+		RaycastResult raycastVsFloor = RaycastVsFloor(ray.m_startPosition, ray.m_fwdNormal, clampedDistance);
+
+		if(raycastVsFloor.m_rayResult.m_didImpact && raycastVsFloor.m_rayResult.m_impactDistance < clampedDistance)
+		{
+			closestRaycast = raycastVsFloor;
+			clampedDistance = raycastVsFloor.m_rayResult.m_impactDistance;
+		}
+
+		scratch.m_batchDistances[rayIndex] = clampedDistance;
+		AddActorSlotsAlongRay(ray.m_startPosition, ray.m_fwdNormal, clampedDistance, scratch.m_actorCandidates);
+	}
+
+	std::sort(scratch.m_actorCandidates.begin(), scratch.m_actorCandidates.end());
+	scratch.m_actorCandidates.erase(std::unique(scratch.m_actorCandidates.begin(), scratch.m_actorCandidates.end()), scratch.m_actorCandidates.end());
+
+	int firingSlot = firingActor ? static_cast<int>(firingActor->m_handle.GetIndex()) : -1;
+
+	scratch.m_cylinders.Clear();
+	m_actorColliders.AddSlotsToBatch(scratch.m_actorCandidates, firingSlot, scratch.m_cylinders);
+
+	for(int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		RayQuery const& ray = rays[rayIndex];
+		float clampedDistance = scratch.m_batchDistances[rayIndex];
+
+		// candidates are packed in slot order, so ties resolve the same way RaycastVsActors resolves them
+		RaycastResult3D rayVsActors;
+		int cylinderIndex = scratch.m_cylinders.RaycastNearest(ray.m_startPosition, ray.m_fwdNormal, clampedDistance, rayVsActors);
+
+		if(cylinderIndex >= 0 && rayVsActors.m_impactDistance < clampedDistance)
+		{
+			out_results[rayIndex].m_rayResult = rayVsActors;
+			out_results[rayIndex].m_hitActor = m_allActors[scratch.m_cylinders.GetUserIndex(cylinderIndex)];
+		}
+
+		out_results[rayIndex].m_rayResult.m_rayMaxLength = ray.m_distance;
+	}
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 RaycastResult Map::RaycastVsActors(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, Actor* firingActor)
 {
@@ -1334,28 +2024,84 @@ RaycastResult Map::RaycastVsActors(Vec3 const& startPosition, Vec3 const& fwdNor
 	closestRaycast.m_rayResult.m_rayForwardNormal = fwdNormal;
 	closestRaycast.m_rayResult.m_rayMaxLength = distance;
 
-	for(size_t actorIndex = 0; actorIndex < m_allActors.size(); ++actorIndex)
+	// only actors in the grid cells along the ray are tested, packed in slot order so ties resolve like the full scan did
+	RaycastScratch& scratch = GetRaycastScratch();
+
+	scratch.m_actorCandidates.clear();
+	AddActorSlotsAlongRay(startPosition, fwdNormal, distance, scratch.m_actorCandidates);
+
+	std::sort(scratch.m_actorCandidates.begin(), scratch.m_actorCandidates.end());
+	scratch.m_actorCandidates.erase(std::unique(scratch.m_actorCandidates.begin(), scratch.m_actorCandidates.end()), scratch.m_actorCandidates.end());
+
+	int firingSlot = firingActor ? static_cast<int>(firingActor->m_handle.GetIndex()) : -1;
+
+	scratch.m_cylinders.Clear();
+	m_actorColliders.AddSlotsToBatch(scratch.m_actorCandidates, firingSlot, scratch.m_cylinders);
+
+	int cylinderIndex = scratch.m_cylinders.RaycastNearest(startPosition, fwdNormal, distance, closestRaycast.m_rayResult);
+
+	if(cylinderIndex >= 0)
 	{
-		if(m_allActors[actorIndex])
+		closestRaycast.m_hitActor = m_allActors[scratch.m_cylinders.GetUserIndex(cylinderIndex)];
+	}
+
+	return closestRaycast;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Walks the tiles under the ray with the same DDA as RaycastVsWalls and appends the grid slots around each one to
+// out_actorSlots, so the cost grows with the length of the ray instead of with the number of actors on the map.
+// Slots come out unsorted and may repeat; callers sort and de-duplicate once they have added all their rays.
+void Map::AddActorSlotsAlongRay(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, std::vector<int>& out_actorSlots)
+{
+	// one radius for the cylinders themselves and one for collision pushes that moved actors since the last grid rebuild
+	float padding = 2.f * m_maxActorRadius;
+
+	IntVec2 tileCoord = IntVec2(RoundDownToInt(startPosition.x), RoundDownToInt(startPosition.y));
+
+	int xStepDirection = fwdNormal.x < 0.f ? -1 : 1;
+	int yStepDirection = fwdNormal.y < 0.f ? -1 : 1;
+
+	float fwdDistancePerX = 1.f / fabsf(fwdNormal.x);
+	float xPosAtFirstXCrossing = static_cast<float>(tileCoord.x + (xStepDirection + 1) / 2);
+	float fwdDistanceAtNextXCrossing = fabsf(xPosAtFirstXCrossing - startPosition.x) * fwdDistancePerX;
+
+	float fwdDistancePerY = 1.f / fabsf(fwdNormal.y);
+	float yPosAtFirstYCrossing = static_cast<float>(tileCoord.y + (yStepDirection + 1) / 2);
+	float fwdDistanceAtNextYCrossing = fabsf(yPosAtFirstYCrossing - startPosition.y) * fwdDistancePerY;
+
+	while(true)
+	{
+		Vec2 tileMins = Vec2(static_cast<float>(tileCoord.x), static_cast<float>(tileCoord.y));
+		m_actorGrid.GetActorSlotsInBox(tileMins - Vec2(padding, padding), tileMins + Vec2(1.f + padding, 1.f + padding), out_actorSlots);
+
+		if(fwdDistanceAtNextXCrossing < fwdDistanceAtNextYCrossing)
 		{
-			if(m_allActors[actorIndex] == firingActor)
+			if(fwdDistanceAtNextXCrossing > distance)
 			{
-				continue;
+				break;
 			}
 
-			Cylinder3D cylinder = Cylinder3D(m_allActors[actorIndex]->m_position, m_allActors[actorIndex]->m_definition->m_physicsHeight, m_allActors[actorIndex]->m_definition->m_physicsRadius);
-
-			RaycastResult3D rayVsActor = RaycastVsCylinder3D(startPosition, fwdNormal, distance, cylinder);
-
-			if(rayVsActor.m_didImpact && rayVsActor.m_impactDistance < closestRaycast.m_rayResult.m_impactDistance)
+			tileCoord.x += xStepDirection;
+			fwdDistanceAtNextXCrossing += fwdDistancePerX;
+		}
+		else
+		{
+			if(fwdDistanceAtNextYCrossing > distance)
 			{
-				closestRaycast.m_rayResult = rayVsActor;
-				closestRaycast.m_hitActor = m_allActors[actorIndex];
+				break;
 			}
+
+			tileCoord.y += yStepDirection;
+			fwdDistanceAtNextYCrossing += fwdDistancePerY;
 		}
 	}
+}
 
-	return closestRaycast;
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+RaycastScratch& Map::GetRaycastScratch()
+{
+	return m_raycastScratch[JobSystem::GetThreadIndex()];
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1448,14 +2194,12 @@ RaycastResult Map::RaycastVsWalls(Vec3 const& startPosition, Vec3 const& fwdNorm
 	raycastResult.m_hitActor = nullptr;
 
 	FloatRange zRange = FloatRange(0.f, 1.f);
-	IntRange  tileIndexRange = IntRange(0, static_cast<int>(m_tiles.size()) - 1);
 
 	IntVec2 startTileCoord = IntVec2(static_cast<int>(startPosition.x), static_cast<int>(startPosition.y));
-	int startTileIndex = GetTileIndexForTileCoord(startTileCoord);
 
-	if(tileIndexRange.IsOnRange(startTileIndex)) 
+	if(IsTileSolid(startTileCoord)) 
 	{
-		if(m_tiles[startTileIndex].IsTileSolid() && zRange.IsOnRange(startPosition.z))
+		if(zRange.IsOnRange(startPosition.z))
 		{
 			raycastResult.m_rayResult.m_didImpact = true;
 			raycastResult.m_rayResult.m_impactDistance = 0.f;
@@ -1495,9 +2239,7 @@ RaycastResult Map::RaycastVsWalls(Vec3 const& startPosition, Vec3 const& fwdNorm
 
 			startTileCoord.x += xStepDirection;
 			
-			int tileIndex = GetTileIndexForTileCoord(startTileCoord);
-
-			if(tileIndex > 0 && tileIndex < static_cast<int>(m_tiles.size()) && m_tiles[tileIndex].IsTileSolid())
+			if(IsTileSolid(startTileCoord))
 			{
 				raycastResult.m_rayResult.m_impactDistance = fwdDistanceAtNextXCrossing;
 				raycastResult.m_rayResult.m_impactPos = startPosition + (raycastResult.m_rayResult.m_impactDistance * raycastResult.m_rayResult.m_rayForwardNormal);
@@ -1524,9 +2266,7 @@ RaycastResult Map::RaycastVsWalls(Vec3 const& startPosition, Vec3 const& fwdNorm
 
 			startTileCoord.y += yStepDirection;
 
-			int tileIndex = GetTileIndexForTileCoord(startTileCoord);
-
-			if(tileIndex > 0 && tileIndex < static_cast<int>(m_tiles.size()) && m_tiles[tileIndex].IsTileSolid())
+			if(IsTileSolid(startTileCoord))
 			{
 				raycastResult.m_rayResult.m_impactDistance = fwdDistanceAtNextYCrossing;
 				raycastResult.m_rayResult.m_impactPos = startPosition + (raycastResult.m_rayResult.m_impactDistance * raycastResult.m_rayResult.m_rayForwardNormal);
@@ -1587,8 +2327,7 @@ bool Map::Event_OnKillAllActors(EventArgs& args)
 	{
 		if(g_game->m_currentMap->m_allActors[index] && g_game->m_currentMap->m_allActors[index]->m_definition->m_canBePossessed)
 		{
-			g_game->m_currentMap->m_allActors[index]->m_health = 0;
-			g_game->m_currentMap->m_allActors[index]->SetActorState(ActorState::DYING);
+			g_game->m_currentMap->m_commandBuffer.QueueKill(nullptr, g_game->m_currentMap->m_allActors[index]);
 		}
 	}
 
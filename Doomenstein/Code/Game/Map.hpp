@@ -9,6 +9,18 @@
 #include "Engine/Renderer/Light.hpp"
 
 #include "Game/Tile.hpp"
+#include "Game/ActorGrid.hpp"
+#include "Game/ActorColliders.hpp"
+#include "Game/ActorPhysicsSystem.hpp"
+#include "Game/ActorBatchRenderer.hpp"
+#include "Game/LightCuller.hpp"
+#include "Game/AIScheduler.hpp"
+#include "Game/TileVisibility.hpp"
+#include "Game/FlowField.hpp"
+#include "Game/ActorHandle.hpp"
+#include "Game/CylinderBatch.hpp"
+#include "Game/ActorCommandBuffer.hpp"
+#include "Game/MapSnapshot.hpp"
 
 #include <string>
 #include <vector>
@@ -24,16 +36,84 @@ class	Actor;
 class	Camera;
 class	SpawnInfo;
 class	NamedStrings;
+class	SpriteSheet;
 
 struct	LightConstants;
 struct	RaycastResult3D;
 struct	AABB2;
 struct	RaycastResult;
+struct	RayQuery;
 struct	ActorHandle;
 
 typedef NamedStrings EventArgs;
 typedef std::vector<Actor*> ActorList;
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Side faces of a wall tile that still need geometry after hidden face culling
+constexpr unsigned char WALL_FACE_POSITIVE_X = 1 << 0;
+constexpr unsigned char WALL_FACE_NEGATIVE_X = 1 << 1;
+constexpr unsigned char WALL_FACE_POSITIVE_Y = 1 << 2;
+constexpr unsigned char WALL_FACE_NEGATIVE_Y = 1 << 3;
+constexpr unsigned char WALL_FACE_ALL		 = 0x0f;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Actor slots per job when a loop over actors is split across the job system's threads
+constexpr int ACTOR_JOB_GRAIN_SIZE = 128;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Static map geometry is split into square chunks of tiles so each camera only submits what its frustum can see
+constexpr int MAP_CHUNK_SIZE = 16;
+
+struct MapChunk
+{
+	AABB3			m_bounds;
+	VertexBuffer*	m_vbo		 = nullptr;
+	IndexBuffer*	m_ibo		 = nullptr;
+	unsigned int	m_numIndexes = 0;
+};
+
+struct MapChunkStats
+{
+	int m_numChunksSubmitted	= 0;
+	int m_numChunksTotal		= 0;
+	int m_numTrianglesSubmitted = 0;
+	int m_numTrianglesTotal		= 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+struct PhysicsStepStats
+{
+	int		m_numTicks			= 0;
+	int		m_numDroppedTicks	= 0;
+	double	m_stepMilliseconds	= 0.0;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Navigation field toward one player's actor, shared by every demon chasing that actor
+struct PlayerFlowField
+{
+	ActorHandle	m_targetHandle = ActorHandle::INVALID;
+	FlowField	m_field;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dead actors of one definition waiting to be respawned in place, see MapDefinition's <ActorPools>
+struct ActorPool
+{
+	ActorList	m_freeActors;
+	bool		m_isEnabled = false;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Buffers the actor raycasts reuse between calls. There is one per job system thread, so sight queries running in
+// parallel jobs never share one.
+struct RaycastScratch
+{
+	std::vector<int>	m_actorCandidates;
+	CylinderBatch		m_cylinders;
+	std::vector<float>	m_batchDistances;
+};
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 class Map
 {
@@ -44,33 +124,72 @@ public:
 
 	void				Update();
 	void				Render(Camera const& camera);
-	void				RenderDepth() const;
+	void				RenderDepth(Camera const& depthCamera) const;
+	MapChunkStats		GetVisibleChunkStats(Camera const& camera) const;
 						
 	Actor*				SpawnActor(SpawnInfo const& spawnInfo);
+	Actor*				SpawnBot();
+	Actor*				SpawnDemon();
 	Actor*				GetActorByHandle(ActorHandle const& handle);
+	unsigned int		GetStateHash() const;
+
+	void				SaveSnapshot(MapSnapshot& out_snapshot) const;
+	bool				RestoreSnapshot(MapSnapshot const& snapshot);
 						
 	int					GetTileIndexForTileCoord(IntVec2 const& tileCoord);
 	bool				DoesTileExist(IntVec2 const& tileCoord);
+	bool				IsTileSolid(IntVec2 const& tileCoord) const;
+	float				GetTileHeight(int tileIndex) const;
 	bool				CheckActorAreSameFaction(Actor* actorOne, Actor* actorTwo);
 	Actor*				GetClosestVisibleActor(Actor* searchingActor);
+	FlowField const*	GetFlowFieldToActor(Actor const* targetActor) const;
 						
 	RaycastResult		RaycastAll(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, Actor* firingActor = nullptr);
+	void				RaycastBatch(std::vector<RayQuery> const& rays, std::vector<RaycastResult>& out_results, Actor* firingActor = nullptr);
 						
 	void				DebugPossessNext();
 						
 	static bool			Event_OnKillAllActors(EventArgs& args);
 	static bool			Event_OnDisplaySunSettings(EventArgs& args);
 	static bool			Event_DebugControlLighting(EventArgs& args);
+	static bool			Event_BenchmarkCollision(EventArgs& args);
+	static bool			Event_VerifyCollisionGrid(EventArgs& args);
+	static bool			Event_BenchmarkTileQueries(EventArgs& args);
+	static bool			Event_BenchmarkSpawns(EventArgs& args);
+	static bool			Event_BenchmarkActorViews(EventArgs& args);
+	static bool			Event_VerifyActorBatches(EventArgs& args);
+	static bool			Event_VerifyMapMeshes(EventArgs& args);
+	static bool			Event_ReportMapChunks(EventArgs& args);
+	static bool			Event_ReportLights(EventArgs& args);
+	static bool			Event_ReportAIStats(EventArgs& args);
+	static bool			Event_BenchmarkSightQueries(EventArgs& args);
+	static bool			Event_BenchmarkRaycasts(EventArgs& args);
+	static bool			Event_VerifyRayKernels(EventArgs& args);
+	static bool			Event_BenchmarkPhysics(EventArgs& args);
+	static bool			Event_ReportPhysicsStats(EventArgs& args);
+	static bool			Event_SaveSnapshot(EventArgs& args);
+	static bool			Event_LoadSnapshot(EventArgs& args);
+	static bool			Event_RestartLevel(EventArgs& args);
+	static bool			Event_BenchmarkSnapshots(EventArgs& args);
 						
 private:				
 	
 	void				DisplayTime();
 
+	bool				IsSnapshotRecordSizeValid(std::vector<unsigned char> const& bytes, size_t tableStart, size_t recordsStart, unsigned int numSlots, unsigned int numSpawnPoints, unsigned int numPlayers, unsigned int numMapLights) const;
+
 	void				InitializeMapByImage(Image& mapImage);
+	void				InitializeTileVisibility();
 	void				GenerateMapVerts();
-	void				AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs) const;
-	void				AddVertsForFloor(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs) const;
-	void				AddVertsForCeiling(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs) const;
+
+	static void			ParseTilesFromImage(Image const& mapImage, std::vector<Tile>& out_tiles);
+	static void			BuildMapMesh(std::vector<Tile> const& tiles, IntVec2 const& dimensions, SpriteSheet const& spriteSheet, bool cullHiddenWallFaces, std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes);
+	static void			BuildMapMeshForTiles(std::vector<Tile> const& tiles, IntVec2 const& dimensions, IntVec2 const& tileMins, IntVec2 const& tileMaxs, SpriteSheet const& spriteSheet, bool cullHiddenWallFaces, std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes);
+	MapChunkStats		RenderMapChunks(Camera const& camera) const;
+	static unsigned char GetVisibleWallFaces(std::vector<Tile> const& tiles, IntVec2 const& dimensions, IntVec2 const& tileCoord);
+	static void			AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs, unsigned char visibleFaces = WALL_FACE_ALL);
+	static void			AddVertsForFloor(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs);
+	static void			AddVertsForCeiling(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, AABB3 const& bounds, AABB2 const& UVs);
 	
 	void				SunColors();
 	void				UpdateLights();
@@ -78,31 +197,40 @@ private:
 	void				UpdateSunIntensity();
 	void				UpdateAmbientLighting();
 	void				CheckAndFillLights();
-	bool				IsLightInScreenSpace(Light const& light);
 
 	void				ActorUpdate();
+	void				UpdatePlayerFlowFields();
+	void				StepPhysics();
 	void				PhysicsUpdate();
 	void				ActorAudioUpdate();
 	void				ManageDeadActors();
 	void				SpawnNewPlayerIfPlayerControllerActorIsDead();
 						
+	void				RebuildActorGrid();
+	void				AddActorToGrid(Actor* actor);
 	void				CheckForCollisions();
 	void				CheckActorVsActorCollision(Actor* collidingActor);
+	void				CheckActorVsActorCollision(Actor* collidingActor, std::vector<int> const& candidateSlots);
 	void				CheckActorVsMapCollision(Actor* actor);
 						
-	void				RenderAllActors(Camera const& camera) const;
+	void				RenderAllActors(Camera const& camera);
 	void				RespawnDemons();
 	void				SpawnAllActors();
 	void				SpawnPlayer();
-	void				AddActorToList(Actor* actor, std::vector<Actor*>& actorList);
+	void				DestroyActor(int actorSlot);
+	void				PrewarmActorPools();
+	unsigned int		AllocateActorSlot();
+	unsigned int		GetNextActorUID();
 
 	int					GetActorIndexInList(Actor* actor, ActorList const& actorList);
 	bool				IsValidPosition(Vec3 const& position);
-	std::vector<Tile>	GetEightSurroundingTiles(int posX, int posY);
 
 	void				CheckGoalConditions();
+	void				AddCaptureText(std::string const& text);
 
 	RaycastResult		RaycastVsActors(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, Actor* firingActor = nullptr);
+	void				AddActorSlotsAlongRay(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance, std::vector<int>& out_actorSlots);
+	RaycastScratch&		GetRaycastScratch();
 	RaycastResult		RaycastVsCeiling(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance);
 	RaycastResult		RaycastVsFloor(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance);
 	RaycastResult		RaycastVsWalls(Vec3 const& startPosition, Vec3 const& fwdNormal, float distance);
@@ -116,6 +244,9 @@ public:
 
 	ActorList			m_allActors;
 	ActorList			m_allSpawnPoints;
+
+	// spawns, damage, impulses and kills asked for during the frame, applied by Update right after the actor update
+	ActorCommandBuffer	m_commandBuffer;
 	Vec3				m_sunDirection		= Vec3(0.f, 0.f, 0.f);
 
 // Event bool
@@ -124,7 +255,9 @@ public:
 	std::vector<Vertex_PCU> m_textVerts;
 
 private:
-	unsigned int		m_currentUID = 0;
+	unsigned int				m_currentUID = 0;
+	std::vector<unsigned int>	m_freeActorSlots;
+	std::vector<ActorPool>		m_actorPools;
 
 // Sun Settings
 	float				m_sunIntensity		= 0.7f;
@@ -139,20 +272,52 @@ private:
 
 	IntVec2				m_bounds;
 	std::vector<Tile>	m_tiles;
+	std::vector<TileFlags> m_tileFlags;
+
+// Broadphase
+	ActorGrid			m_actorGrid;
+	std::vector<int>	m_actorGridCellIndices;
+	std::vector<int>	m_actorCandidates;
+	float				m_maxActorRadius = 0.f;
+	ActorColliders		m_actorColliders;
+	std::vector<IntVec2>* m_collisionPairLog = nullptr;	// (colliding slot, pushed-against slot) of every push, set by VerifyCollisionGrid
+
+// Physics
+	ActorPhysicsSystem	m_physicsSystem;
+	float				m_physicsStepSeconds		= 1.f / 120.f;
+	int					m_maxPhysicsTicksPerFrame	= 8;
+	float				m_physicsAccumulatorSeconds	= 0.f;
+	PhysicsStepStats	m_lastPhysicsStepStats;
+	PhysicsStepStats	m_peakPhysicsStepStats;
+	double				m_totalPhysicsStepMilliseconds	= 0.0;
+	int					m_numPhysicsStatFrames			= 0;
+
+// Raycasts
+	std::vector<RaycastScratch> m_raycastScratch;
+
+// AI
+	AIScheduler			m_aiScheduler;
+	TileVisibility		m_tileVisibility;
+	bool				m_useTileVisibility = true;
+	double				m_tileVisibilityBakeSeconds = -1.0;	// how long the bake on load took, or -1 when it came from the cache or was skipped
+	std::vector<PlayerFlowField> m_playerFlowFields;
 
 // Timers
-	Timer				m_physicsTimer;
 	Timer				m_sunTimer;
 	Timer				m_sunYawTimer;
+
+// Snapshots
+	MapSnapshot			m_levelStartSnapshot;	// taken once the map is built, for RestartLevel
+	MapSnapshot			m_savedSnapshot;		// SaveSnapshot and LoadSnapshot
 	
 //Renderer
-	VertexBuffer*		m_vbo = nullptr;
-	IndexBuffer*		m_ibo = nullptr;
-
-	std::vector<unsigned int>		m_indexes;
-	std::vector<Vertex_PCUTBN>		m_verts;
+	std::vector<MapChunk>			m_chunks;
 	std::vector<Rgba8>				m_colors;
 
+	ActorBatchRenderer				m_actorBatchRenderer;
+	LightCuller						m_lightCuller;
+	std::vector<Light>				m_cameraLights;
+
  	FloatRange m_greenXGoalRange = FloatRange(1.f, 13.f);
 	FloatRange m_greenYGoalRange = FloatRange(1.f, 13.f);
 	
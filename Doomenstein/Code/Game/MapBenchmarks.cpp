@@ -0,0 +1,1521 @@
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/Actor.hpp"
+#include "Game/Game.hpp"
+#include "Game/PlayerController.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Tile.hpp"
+#include "Game/CylinderBatch.hpp"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RaycastUtils.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/SpriteSheet.hpp"
+
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dev console benchmarks for the map systems. Each one runs against the currently loaded map, prints its results to the
+// dev console and the debugger output, and leaves the map the way it found it.
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+extern Game* g_game;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void PrintBenchmarkLine(std::string const& text)
+{
+	g_devConsole->AddLine(DevConsole::INFO_MAJOR, text);
+	DebuggerPrintf("%s\n", text.c_str());
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Map::Event_BenchmarkCollision(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("BenchmarkCollision: no map is loaded");
+		return false;
+	}
+
+	std::vector<Vec3> openTilePositions;
+
+	for(int tileIndex = 0; tileIndex < static_cast<int>(map->m_tiles.size()); ++tileIndex)
+	{
+		Tile const& tile = map->m_tiles[tileIndex];
+
+		if(tile.HasDefinition() && !tile.IsTileSolid())
+		{
+			openTilePositions.push_back(Vec3(static_cast<float>(tileIndex % map->m_bounds.x), static_cast<float>(tileIndex / map->m_bounds.x), 0.f));
+		}
+	}
+
+	if(openTilePositions.empty())
+	{
+		PrintBenchmarkLine("BenchmarkCollision: map has no open tiles");
+		return false;
+	}
+
+	int const	actorCounts[] = { 100, 500, 1000, 2500, 5000, 10000 };
+	int const	numTicks = 10;
+	IntRange	tileRange = IntRange(0, static_cast<int>(openTilePositions.size()) - 1);
+	FloatRange	offsetRange = FloatRange(0.2f, 0.8f);
+
+	PrintBenchmarkLine(Stringf("BenchmarkCollision on %s (%d open tiles, %d ticks per sample)", map->m_mapDef->m_name.c_str(), static_cast<int>(openTilePositions.size()), numTicks));
+
+	// the timed ticks move, push and damage every actor on the live map, so each sample ends by putting it all back
+	MapSnapshot originalSnapshot;
+	map->SaveSnapshot(originalSnapshot);
+
+	for(int actorCount : actorCounts)
+	{
+		SpawnInfo spawnInfo;
+		spawnInfo.m_actorName = "Demon";
+
+		for(int spawnIndex = 0; spawnIndex < actorCount; ++spawnIndex)
+		{
+			Vec3 tileMins = openTilePositions[tileRange.GetRandomInt()];
+			spawnInfo.m_position = Vec3(tileMins.x + offsetRange.GetRandomFloat(), tileMins.y + offsetRange.GetRandomFloat(), 0.f);
+
+			map->SpawnActor(spawnInfo);
+		}
+
+		double startTime = GetCurrentTimeSeconds();
+
+		for(int tick = 0; tick < numTicks; ++tick)
+		{
+			map->PhysicsUpdate();
+		}
+
+		double millisecondsPerTick = (GetCurrentTimeSeconds() - startTime) * 1000.0 / static_cast<double>(numTicks);
+
+		PrintBenchmarkLine(Stringf("  %6d demons: %8.3f ms per physics tick", actorCount, millisecondsPerTick));
+
+		if(!map->RestoreSnapshot(originalSnapshot))
+		{
+			PrintBenchmarkLine("BenchmarkCollision: could not restore the map to where it started");
+			return false;
+		}
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Packs a crowd of demons into a few tiles so most of them overlap, runs one collision pass through the grid, then runs
+// it again from the same start testing every actor against every slot the way CheckActorVsActorCollision used to.
+// The two passes have to make the same pushes in the same order and leave every actor in the same place.
+bool Map::Event_VerifyCollisionGrid(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("VerifyCollisionGrid: no map is loaded");
+		return false;
+	}
+
+	std::vector<Vec3> openTilePositions;
+
+	for(int tileIndex = 0; tileIndex < static_cast<int>(map->m_tiles.size()); ++tileIndex)
+	{
+		Tile const& tile = map->m_tiles[tileIndex];
+
+		if(tile.HasDefinition() && !tile.IsTileSolid())
+		{
+			openTilePositions.push_back(Vec3(static_cast<float>(tileIndex % map->m_bounds.x), static_cast<float>(tileIndex / map->m_bounds.x), 0.f));
+		}
+	}
+
+	if(openTilePositions.empty())
+	{
+		PrintBenchmarkLine("VerifyCollisionGrid: map has no open tiles");
+		return false;
+	}
+
+	int const	numDemons = 2000;
+	int const	numCrowdTiles = 16;
+	IntRange	tileRange = IntRange(0, static_cast<int>(openTilePositions.size()) - 1);
+	IntRange	crowdTileRange = IntRange(0, numCrowdTiles - 1);
+	FloatRange	offsetRange = FloatRange(0.f, 1.f);
+
+	std::vector<Vec3> crowdTilePositions;
+
+	for(int crowdTileIndex = 0; crowdTileIndex < numCrowdTiles; ++crowdTileIndex)
+	{
+		crowdTilePositions.push_back(openTilePositions[tileRange.GetRandomInt()]);
+	}
+
+	MapSnapshot originalSnapshot;
+	MapSnapshot crowdSnapshot;
+	map->SaveSnapshot(originalSnapshot);
+
+	SpawnInfo spawnInfo;
+	spawnInfo.m_actorName = "Demon";
+
+	for(int spawnIndex = 0; spawnIndex < numDemons; ++spawnIndex)
+	{
+		Vec3 tileMins = crowdTilePositions[crowdTileRange.GetRandomInt()];
+		spawnInfo.m_position = Vec3(tileMins.x + offsetRange.GetRandomFloat(), tileMins.y + offsetRange.GetRandomFloat(), 0.f);
+
+		map->SpawnActor(spawnInfo);
+	}
+
+	map->SaveSnapshot(crowdSnapshot);
+
+	int numSlots = static_cast<int>(map->m_allActors.size());
+	std::vector<Vec3> startPositions(numSlots);
+	std::vector<Vec3> gridPositions(numSlots);
+	std::vector<Vec3> fullScanPositions(numSlots);
+	std::vector<IntVec2> gridPairs;
+	std::vector<IntVec2> fullScanPairs;
+
+	for(int slot = 0; slot < numSlots; ++slot)
+	{
+		startPositions[slot] = map->m_allActors[slot] ? map->m_allActors[slot]->m_position : Vec3::ZERO;
+	}
+
+	// grid pass, exactly as PhysicsUpdate runs it
+	map->m_collisionPairLog = &gridPairs;
+	map->RebuildActorGrid();
+	map->CheckForCollisions();
+
+	for(int slot = 0; slot < numSlots; ++slot)
+	{
+		gridPositions[slot] = map->m_allActors[slot] ? map->m_allActors[slot]->m_position : Vec3::ZERO;
+	}
+
+	// full scan pass from the same start
+	map->RestoreSnapshot(crowdSnapshot);
+	map->m_collisionPairLog = &fullScanPairs;
+
+	std::vector<int> allSlots(numSlots);
+
+	for(int slot = 0; slot < numSlots; ++slot)
+	{
+		allSlots[slot] = slot;
+	}
+
+	for(int slot = 0; slot < numSlots; ++slot)
+	{
+		Actor* actor = map->m_allActors[slot];
+
+		if(actor && actor->m_state != ActorState::DEAD && actor->m_state != ActorState::DYING)
+		{
+			map->CheckActorVsActorCollision(actor, allSlots);
+			map->CheckActorVsMapCollision(actor);
+		}
+	}
+
+	map->m_collisionPairLog = nullptr;
+
+	int numCellChanges = 0;
+	int numPositionMismatches = 0;
+
+	for(int slot = 0; slot < numSlots; ++slot)
+	{
+		fullScanPositions[slot] = map->m_allActors[slot] ? map->m_allActors[slot]->m_position : Vec3::ZERO;
+
+		numCellChanges += (map->m_actorGrid.GetCellIndexForPosition(startPositions[slot].GetXY2D()) != map->m_actorGrid.GetCellIndexForPosition(gridPositions[slot].GetXY2D())) ? 1 : 0;
+		numPositionMismatches += (gridPositions[slot] != fullScanPositions[slot]) ? 1 : 0;
+	}
+
+	// pushes are order dependent, so the pair lists have to match entry for entry, not just as sets
+	size_t numComparedPairs = gridPairs.size() < fullScanPairs.size() ? gridPairs.size() : fullScanPairs.size();
+	int numPairMismatches = static_cast<int>(gridPairs.size() + fullScanPairs.size() - 2 * numComparedPairs);
+
+	for(size_t pairIndex = 0; pairIndex < numComparedPairs; ++pairIndex)
+	{
+		numPairMismatches += (gridPairs[pairIndex] != fullScanPairs[pairIndex]) ? 1 : 0;
+	}
+
+	bool didPass = numPairMismatches == 0 && numPositionMismatches == 0;
+
+	PrintBenchmarkLine(Stringf("VerifyCollisionGrid on %s: %d demons in %d tiles, %d changed cells during the pass", map->m_mapDef->m_name.c_str(), numDemons, numCrowdTiles, numCellChanges));
+	PrintBenchmarkLine(Stringf("  %d pushes via grid vs %d via full scan, %d pair mismatches, %d position mismatches -> %s", static_cast<int>(gridPairs.size()), static_cast<int>(fullScanPairs.size()),
+							   numPairMismatches, numPositionMismatches, didPass ? "PASS" : "FAIL"));
+
+	if(!map->RestoreSnapshot(originalSnapshot))
+	{
+		PrintBenchmarkLine("VerifyCollisionGrid: could not restore the map to where it started");
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Map::Event_BenchmarkTileQueries(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("BenchmarkTileQueries: no map is loaded");
+		return false;
+	}
+
+	static IntVec2 const s_neighborOffsets[8] =
+	{
+		IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1),
+		IntVec2(1, 1), IntVec2(1, -1), IntVec2(-1, 1), IntVec2(-1, -1)
+	};
+
+	int const numPasses = 100;
+	int const numTiles = map->m_bounds.x * map->m_bounds.y;
+	int solidCount = 0;
+
+	// before: copy the existing neighbours into a fresh vector and ask each Tile for its definition
+	double startTime = GetCurrentTimeSeconds();
+
+	for(int pass = 0; pass < numPasses; ++pass)
+	{
+		for(int tileIndex = 0; tileIndex < numTiles; ++tileIndex)
+		{
+			IntVec2 tileCoord = IntVec2(tileIndex % map->m_bounds.x, tileIndex / map->m_bounds.x);
+
+			std::vector<Tile> surroundingTiles;
+
+			for(IntVec2 const& offset : s_neighborOffsets)
+			{
+				IntVec2 neighborCoord = tileCoord + offset;
+
+				if(map->DoesTileExist(neighborCoord))
+				{
+					surroundingTiles.push_back(map->m_tiles[map->GetTileIndexForTileCoord(neighborCoord)]);
+				}
+			}
+
+			for(Tile const& tile : surroundingTiles)
+			{
+				solidCount += tile.IsTileSolid() ? 1 : 0;
+			}
+		}
+	}
+
+	double vectorSeconds = GetCurrentTimeSeconds() - startTime;
+	int vectorSolidCount = solidCount;
+
+	// after: read the packed flags in place
+	solidCount = 0;
+	startTime = GetCurrentTimeSeconds();
+
+	for(int pass = 0; pass < numPasses; ++pass)
+	{
+		for(int tileIndex = 0; tileIndex < numTiles; ++tileIndex)
+		{
+			IntVec2 tileCoord = IntVec2(tileIndex % map->m_bounds.x, tileIndex / map->m_bounds.x);
+
+			for(IntVec2 const& offset : s_neighborOffsets)
+			{
+				solidCount += map->IsTileSolid(tileCoord + offset) ? 1 : 0;
+			}
+		}
+	}
+
+	double flagsSeconds = GetCurrentTimeSeconds() - startTime;
+
+	double numQueries = static_cast<double>(numTiles) * static_cast<double>(numPasses);
+
+	PrintBenchmarkLine(Stringf("BenchmarkTileQueries on %s (%dx%d, %d passes)", map->m_mapDef->m_name.c_str(), map->m_bounds.x, map->m_bounds.y, numPasses));
+	PrintBenchmarkLine(Stringf("  tile vector copies: %12.0f tiles/sec (%d solid neighbours)", numQueries / vectorSeconds, vectorSolidCount));
+	PrintBenchmarkLine(Stringf("  packed tile flags:  %12.0f tiles/sec (%d solid neighbours)", numQueries / flagsSeconds, solidCount));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Map::Event_BenchmarkSpawns(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("BenchmarkSpawns: no map is loaded");
+		return false;
+	}
+
+	// keep a small ring of live effects so slots are recycled the way sustained weapon fire recycles them
+	int const numSpawns = 100000;
+	int const maxLiveEffects = 64;
+
+	std::vector<ActorHandle> liveEffects(maxLiveEffects, ActorHandle::INVALID);
+
+	SpawnInfo spawnInfo;
+	spawnInfo.m_actorName = "BulletHit";
+	spawnInfo.m_position = Vec3(1.5f, 1.5f, 0.5f);
+
+	size_t slotCountBefore = map->m_allActors.size();
+
+	double startTime = GetCurrentTimeSeconds();
+
+	for(int spawnIndex = 0; spawnIndex < numSpawns; ++spawnIndex)
+	{
+		ActorHandle& ringEntry = liveEffects[spawnIndex % maxLiveEffects];
+
+		if(map->GetActorByHandle(ringEntry))
+		{
+			map->DestroyActor(static_cast<int>(ringEntry.GetIndex()));
+		}
+
+		ringEntry = map->SpawnActor(spawnInfo)->m_handle;
+	}
+
+	for(ActorHandle const& handle : liveEffects)
+	{
+		if(map->GetActorByHandle(handle))
+		{
+			map->DestroyActor(static_cast<int>(handle.GetIndex()));
+		}
+	}
+
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+	map->RebuildActorGrid();
+
+	PrintBenchmarkLine(Stringf("BenchmarkSpawns: %d BulletHit spawns and kills in %.3f s", numSpawns, elapsedSeconds));
+	PrintBenchmarkLine(Stringf("  %.0f spawns/sec, actor slots grew from %d to %d", static_cast<double>(numSpawns) / elapsedSeconds, static_cast<int>(slotCountBefore), static_cast<int>(map->m_allActors.size())));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Map::Event_BenchmarkActorViews(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("BenchmarkActorViews: no map is loaded");
+		return false;
+	}
+
+	ActorList viewedActors;
+
+	for(Actor* actor : map->m_allActors)
+	{
+		if(actor && actor->m_definition->m_visible && !actor->m_definition->m_animGroups.empty())
+		{
+			viewedActors.push_back(actor);
+		}
+	}
+
+	if(viewedActors.empty())
+	{
+		PrintBenchmarkLine("BenchmarkActorViews: map has no animated actors");
+		return false;
+	}
+
+	// orbit a camera around the map center so every actor is seen from a changing direction
+	int const	numCameraSteps = 360;
+	Vec3		mapCenter	   = Vec3(static_cast<float>(map->m_bounds.x) * 0.5f, static_cast<float>(map->m_bounds.y) * 0.5f, 0.5f);
+	float		orbitRadius	   = static_cast<float>(map->m_bounds.x + map->m_bounds.y);
+
+	Camera camera;
+
+	double startTime = GetCurrentTimeSeconds();
+
+	for(int cameraStep = 0; cameraStep < numCameraSteps; ++cameraStep)
+	{
+		float orbitDegrees = static_cast<float>(cameraStep);
+		camera.m_position = mapCenter + Vec3(CosDegrees(orbitDegrees), SinDegrees(orbitDegrees), 0.f) * orbitRadius;
+
+		for(Actor* actor : viewedActors)
+		{
+			actor->SetAnimationIfViewChanged(camera);
+		}
+	}
+
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+	double numUpdates = static_cast<double>(viewedActors.size()) * static_cast<double>(numCameraSteps);
+
+	PrintBenchmarkLine(Stringf("BenchmarkActorViews on %s (%d actors, %d camera positions)", map->m_mapDef->m_name.c_str(), static_cast<int>(viewedActors.size()), numCameraSteps));
+	PrintBenchmarkLine(Stringf("  %.0f actor view updates/sec", numUpdates / elapsedSeconds));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Checks the batched actor vertex stream against what the per-actor path would put on screen: each actor's local
+// verts under its own billboard model matrix, with the vertex color multiplied by the model color.
+bool Map::Event_VerifyActorBatches(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map || g_game->m_playerControllers.empty())
+	{
+		PrintBenchmarkLine("VerifyActorBatches: no map or player camera is available");
+		return false;
+	}
+
+	Camera const& camera = g_game->m_playerControllers[0]->m_worldCamera;
+
+	ActorBatchRenderer batchRenderer;
+	batchRenderer.BeginBatches();
+
+	for(Actor* actor : map->m_allActors)
+	{
+		if(actor)
+		{
+			batchRenderer.AddActor(*actor, camera);
+		}
+	}
+
+	std::vector<ActorBatch> const& batches = batchRenderer.GetBatches();
+	std::vector<size_t> batchVertCursors(batches.size(), 0);
+	std::vector<size_t> batchIndexCursors(batches.size(), 0);
+
+	float const positionTolerance = 0.0001f;
+
+	int numDrawnActors = 0;
+	int numMismatches = 0;
+
+	for(Actor* actor : map->m_allActors)
+	{
+		if(!actor || !actor->ShouldRenderForCamera(camera))
+		{
+			continue;
+		}
+
+		numDrawnActors += 1;
+
+		ActorDefinition const* actorDef = actor->m_definition;
+		size_t batchIndex = 0;
+
+		while(batchIndex < batches.size() && !(batches[batchIndex].m_shader == actorDef->m_shader && batches[batchIndex].m_texture == actorDef->m_texture && batches[batchIndex].m_isLit == actorDef->m_renderLit))
+		{
+			batchIndex += 1;
+		}
+
+		if(batchIndex == batches.size())
+		{
+			numMismatches += 1;
+			continue;
+		}
+
+		ActorBatch const& batch = batches[batchIndex];
+		Mat44 modelMatrix = actor->GetBillboardMatrix(camera);
+
+		if(actorDef->m_renderLit)
+		{
+			size_t baseVertex = batchVertCursors[batchIndex];
+
+			for(Vertex_PCUTBN const& localVert : actor->m_verts)
+			{
+				Vertex_PCUTBN const& batchVert = batch.m_litVerts[batchVertCursors[batchIndex]];
+				Vec3 expectedPosition = modelMatrix.TransformPosition3D(localVert.m_position);
+				Rgba8 expectedColor = ActorBatchRenderer::GetTintedColor(localVert.m_color, actor->m_color);
+
+				bool isSameVert = (GetVectorDistanceSquared3D(expectedPosition, batchVert.m_position) <= positionTolerance * positionTolerance) &&
+								  (expectedColor.r == batchVert.m_color.r && expectedColor.g == batchVert.m_color.g && expectedColor.b == batchVert.m_color.b && expectedColor.a == batchVert.m_color.a) &&
+								  (localVert.m_uvCoords == batchVert.m_uvCoords);
+
+				numMismatches += isSameVert ? 0 : 1;
+				batchVertCursors[batchIndex] += 1;
+			}
+
+			for(unsigned int localIndex : actor->m_indexes)
+			{
+				numMismatches += (batch.m_litIndexes[batchIndexCursors[batchIndex]] == static_cast<unsigned int>(baseVertex) + localIndex) ? 0 : 1;
+				batchIndexCursors[batchIndex] += 1;
+			}
+		}
+		else
+		{
+			for(Vertex_PCU const& localVert : actor->m_unlitVerts)
+			{
+				Vertex_PCU const& batchVert = batch.m_unlitVerts[batchVertCursors[batchIndex]];
+				Vec3 expectedPosition = modelMatrix.TransformPosition3D(localVert.m_position);
+				Rgba8 expectedColor = ActorBatchRenderer::GetTintedColor(localVert.m_color, actor->m_color);
+
+				bool isSameVert = (GetVectorDistanceSquared3D(expectedPosition, batchVert.m_position) <= positionTolerance * positionTolerance) &&
+								  (expectedColor.r == batchVert.m_color.r && expectedColor.g == batchVert.m_color.g && expectedColor.b == batchVert.m_color.b && expectedColor.a == batchVert.m_color.a) &&
+								  (localVert.m_uvTexCoords == batchVert.m_uvTexCoords);
+
+				numMismatches += isSameVert ? 0 : 1;
+				batchVertCursors[batchIndex] += 1;
+			}
+		}
+	}
+
+	// every batched vertex must have been claimed by exactly one actor
+	for(size_t batchIndex = 0; batchIndex < batches.size(); ++batchIndex)
+	{
+		size_t numBatchVerts = batches[batchIndex].m_isLit ? batches[batchIndex].m_litVerts.size() : batches[batchIndex].m_unlitVerts.size();
+		numMismatches += (batchVertCursors[batchIndex] == numBatchVerts) ? 0 : 1;
+	}
+
+	PrintBenchmarkLine(Stringf("VerifyActorBatches: %d actors, %d draw calls per-actor vs %d batched, %d mismatches -> %s", numDrawnActors, numDrawnActors, batchRenderer.GetNumActiveBatches(), numMismatches, (numMismatches == 0) ? "PASS" : "FAIL"));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// A wall face culled from the mesh is only allowed if solid tiles at least as tall sit on both sides of it
+static bool IsQuadHiddenByWalls(std::vector<Tile> const& tiles, IntVec2 const& dimensions, Vertex_PCUTBN const* quadVerts)
+{
+	Vec3 centroid = (quadVerts[0].m_position + quadVerts[1].m_position + quadVerts[2].m_position + quadVerts[3].m_position) * 0.25f;
+	Vec3 normal = CrossProduct3D(quadVerts[1].m_position - quadVerts[0].m_position, quadVerts[2].m_position - quadVerts[0].m_position).GetNormalized();
+
+	float quadTop = quadVerts[0].m_position.z;
+
+	for(int vertIndex = 1; vertIndex < 4; ++vertIndex)
+	{
+		quadTop = (quadVerts[vertIndex].m_position.z > quadTop) ? quadVerts[vertIndex].m_position.z : quadTop;
+	}
+
+	for(float side = -1.f; side <= 1.f; side += 2.f)
+	{
+		Vec3 samplePoint = centroid + normal * (0.5f * side);
+		IntVec2 tileCoord = IntVec2(RoundDownToInt(samplePoint.x), RoundDownToInt(samplePoint.y));
+
+		if(tileCoord.x < 0 || tileCoord.y < 0 || tileCoord.x >= dimensions.x || tileCoord.y >= dimensions.y)
+		{
+			return false;
+		}
+
+		TileFlags flags = tiles[(tileCoord.y * dimensions.x) + tileCoord.x].GetFlags();
+		float tileHeight = static_cast<float>((flags & TILE_FLAG_HEIGHT_MASK) >> TILE_FLAG_HEIGHT_SHIFT);
+
+		if(!(flags & TILE_FLAG_SOLID) || tileHeight < quadTop)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Builds every map definition's mesh with and without hidden face culling and checks that the culled mesh is exactly
+// the full mesh minus faces that are sandwiched between solid walls. Quads are emitted in the same order by both
+// builds, so walking them side by side is enough to prove nothing visible moved or went missing.
+bool Map::Event_VerifyMapMeshes(EventArgs& args)
+{
+	UNUSED(args);
+
+	int numFailedMaps = 0;
+
+	for(MapDefinition const& mapDef : MapDefinition::s_definitions)
+	{
+		if(!mapDef.m_spriteSheetTexture)
+		{
+			continue;
+		}
+
+		std::vector<Tile> tiles;
+		ParseTilesFromImage(mapDef.m_mapImage, tiles);
+
+		IntVec2 dimensions = mapDef.m_mapImage.GetDimensions();
+		SpriteSheet spriteSheet = SpriteSheet(*mapDef.m_spriteSheetTexture, IntVec2(8, 8));
+
+		std::vector<Vertex_PCUTBN> fullVerts;
+		std::vector<unsigned int>  fullIndexes;
+		std::vector<Vertex_PCUTBN> culledVerts;
+		std::vector<unsigned int>  culledIndexes;
+
+		BuildMapMesh(tiles, dimensions, spriteSheet, false, fullVerts, fullIndexes);
+		BuildMapMesh(tiles, dimensions, spriteSheet, true, culledVerts, culledIndexes);
+
+		size_t culledQuad = 0;
+		size_t numCulledQuads = culledVerts.size() / 4;
+		int numMismatches = 0;
+
+		for(size_t fullQuad = 0; fullQuad < fullVerts.size() / 4; ++fullQuad)
+		{
+			Vertex_PCUTBN const* fullQuadVerts = &fullVerts[fullQuad * 4];
+			bool isSameQuad = culledQuad < numCulledQuads;
+
+			for(int vertIndex = 0; vertIndex < 4 && isSameQuad; ++vertIndex)
+			{
+				Vertex_PCUTBN const& culledVert = culledVerts[(culledQuad * 4) + vertIndex];
+
+				isSameQuad = (culledVert.m_position == fullQuadVerts[vertIndex].m_position) && (culledVert.m_uvCoords == fullQuadVerts[vertIndex].m_uvCoords);
+			}
+
+			if(isSameQuad)
+			{
+				culledQuad += 1;
+			}
+			else if(!IsQuadHiddenByWalls(tiles, dimensions, fullQuadVerts))
+			{
+				numMismatches += 1;
+			}
+		}
+
+		numMismatches += (culledQuad == numCulledQuads) ? 0 : 1;
+		numFailedMaps += (numMismatches == 0) ? 0 : 1;
+
+		PrintBenchmarkLine(Stringf("VerifyMapMeshes: %s (%dx%d) verts %d -> %d, indexes %d -> %d, %d mismatches -> %s", mapDef.m_name.c_str(), dimensions.x, dimensions.y,
+								   static_cast<int>(fullVerts.size()), static_cast<int>(culledVerts.size()), static_cast<int>(fullIndexes.size()), static_cast<int>(culledIndexes.size()),
+								   numMismatches, (numMismatches == 0) ? "PASS" : "FAIL"));
+	}
+
+	PrintBenchmarkLine(Stringf("VerifyMapMeshes: %d maps failed", numFailedMaps));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Prints how many map chunks and triangles each player camera submits this frame after frustum culling
+bool Map::Event_ReportMapChunks(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("ReportMapChunks: no map is loaded");
+		return false;
+	}
+
+	for(size_t controllerIndex = 0; controllerIndex < g_game->m_playerControllers.size(); ++controllerIndex)
+	{
+		PlayerController const* playerController = g_game->m_playerControllers[controllerIndex];
+
+		if(!playerController)
+		{
+			continue;
+		}
+
+		MapChunkStats stats = map->GetVisibleChunkStats(playerController->m_worldCamera);
+
+		PrintBenchmarkLine(Stringf("ReportMapChunks: camera %d submits %d / %d chunks, %d / %d triangles", static_cast<int>(controllerIndex),
+								   stats.m_numChunksSubmitted, stats.m_numChunksTotal, stats.m_numTrianglesSubmitted, stats.m_numTrianglesTotal));
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Runs each player camera's light selection on this frame's candidate lights and prints what it kept
+bool Map::Event_ReportLights(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("ReportLights: no map is loaded");
+		return false;
+	}
+
+	LightCuller lightCuller;
+	std::vector<Light> selectedLights;
+
+	for(size_t controllerIndex = 0; controllerIndex < g_game->m_playerControllers.size(); ++controllerIndex)
+	{
+		PlayerController const* playerController = g_game->m_playerControllers[controllerIndex];
+
+		if(!playerController)
+		{
+			continue;
+		}
+
+		double startTime = GetCurrentTimeSeconds();
+		lightCuller.SelectLights(map->m_allLights, playerController->m_worldCamera, selectedLights);
+		double elapsedMs = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+		LightCullStats stats = lightCuller.GetLastStats();
+
+		PrintBenchmarkLine(Stringf("ReportLights: camera %d keeps %d of %d visible lights (%d candidates, shader budget %d) in %.3f ms", static_cast<int>(controllerIndex),
+								   stats.m_numSelected, stats.m_numVisible, stats.m_numCandidates, MAX_LIGHTS, elapsedMs));
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Prints the AI scheduler's target acquisition cost for the last frame and since the last report, then resets the peaks
+bool Map::Event_ReportAIStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("ReportAIStats: no map is loaded");
+		return false;
+	}
+
+	AIScheduler& scheduler = map->m_aiScheduler;
+	AISchedulerStats lastFrame = scheduler.GetLastFrameStats();
+	AISchedulerStats peak = scheduler.GetPeakStats();
+
+	PrintBenchmarkLine(Stringf("ReportAIStats: interval %d frames, budget %.0f us", scheduler.m_thinkIntervalFrames, scheduler.m_thinkBudgetMicroseconds));
+	PrintBenchmarkLine(Stringf("ReportAIStats: last frame %d thinks, %d deferred, %.1f us", lastFrame.m_numThinks, lastFrame.m_numDeferredThinks, lastFrame.m_thinkMicroseconds));
+	PrintBenchmarkLine(Stringf("ReportAIStats: peak %d thinks, %d deferred, %.1f us; average %.1f us per frame", peak.m_numThinks, peak.m_numDeferredThinks, peak.m_thinkMicroseconds, scheduler.GetAverageThinkMicroseconds()));
+
+	scheduler.ResetStats();
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Runs every AI actor's target search with and without the tile visibility table and reports sight queries per second.
+// The per-pair raycast below GetClosestVisibleActor is unchanged, so any difference in the chosen targets comes from
+// pairs the table rejects before a ray was cast.
+bool Map::Event_BenchmarkSightQueries(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("BenchmarkSightQueries: no map is loaded");
+		return false;
+	}
+
+	std::vector<Actor*> searchingActors;
+
+	for(Actor* actor : map->m_allActors)
+	{
+		if(actor && actor->m_aiController && actor->IsAlive())
+		{
+			searchingActors.push_back(actor);
+		}
+	}
+
+	if(searchingActors.empty() || !map->m_tileVisibility.IsBuilt())
+	{
+		PrintBenchmarkLine("BenchmarkSightQueries: no AI actors or no tile visibility table on this map");
+		return false;
+	}
+
+	int const numPasses = 50;
+	bool wasUsingTileVisibility = map->m_useTileVisibility;
+
+	std::vector<Actor*> raycastTargets(searchingActors.size(), nullptr);
+	std::vector<Actor*> tableTargets(searchingActors.size(), nullptr);
+
+	// before: every candidate in the sight sector is confirmed with RaycastAll
+	map->m_useTileVisibility = false;
+	double startTime = GetCurrentTimeSeconds();
+
+	for(int pass = 0; pass < numPasses; ++pass)
+	{
+		for(size_t searchIndex = 0; searchIndex < searchingActors.size(); ++searchIndex)
+		{
+			raycastTargets[searchIndex] = map->GetClosestVisibleActor(searchingActors[searchIndex]);
+		}
+	}
+
+	double raycastSeconds = GetCurrentTimeSeconds() - startTime;
+
+	// after: candidates behind static walls are rejected by the table first
+	map->m_useTileVisibility = true;
+	startTime = GetCurrentTimeSeconds();
+
+	for(int pass = 0; pass < numPasses; ++pass)
+	{
+		for(size_t searchIndex = 0; searchIndex < searchingActors.size(); ++searchIndex)
+		{
+			tableTargets[searchIndex] = map->GetClosestVisibleActor(searchingActors[searchIndex]);
+		}
+	}
+
+	double tableSeconds = GetCurrentTimeSeconds() - startTime;
+
+	map->m_useTileVisibility = wasUsingTileVisibility;
+
+	int numDifferentTargets = 0;
+
+	for(size_t searchIndex = 0; searchIndex < searchingActors.size(); ++searchIndex)
+	{
+		numDifferentTargets += (raycastTargets[searchIndex] != tableTargets[searchIndex]) ? 1 : 0;
+	}
+
+	double numQueries = static_cast<double>(searchingActors.size()) * static_cast<double>(numPasses);
+
+	PrintBenchmarkLine(Stringf("BenchmarkSightQueries on %s (%d searching actors, %d passes)", map->m_mapDef->m_name.c_str(), static_cast<int>(searchingActors.size()), numPasses));
+	PrintBenchmarkLine(Stringf("  raycast only:         %12.0f queries/sec", numQueries / raycastSeconds));
+	PrintBenchmarkLine(Stringf("  tile visibility + ray: %11.0f queries/sec", numQueries / tableSeconds));
+	PrintBenchmarkLine(Stringf("  %d searches picked a different target", numDifferentTargets));
+
+	// cold bake of the same walls into a scratch table, so the cost of a first launch without a cache shows up here too
+	int numTiles = map->m_bounds.x * map->m_bounds.y;
+	TileVisibility scratchVisibility;
+
+	startTime = GetCurrentTimeSeconds();
+	scratchVisibility.Build(map->m_tileFlags, map->m_bounds);
+	double bakeSeconds = GetCurrentTimeSeconds() - startTime;
+
+	std::string loadBake = (map->m_tileVisibilityBakeSeconds >= 0.0) ? Stringf("%.2f s on load", map->m_tileVisibilityBakeSeconds) : std::string("loaded from cache");
+
+	PrintBenchmarkLine(Stringf("  bake: %d tiles, %.0f tile pairs, %.2f s cold (%s)", numTiles, 0.5 * static_cast<double>(numTiles) * static_cast<double>(numTiles - 1), bakeSeconds, loadBake.c_str()));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Map::Event_BenchmarkRaycasts(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("BenchmarkRaycasts: no map is loaded");
+		return false;
+	}
+
+	std::vector<Vec3> openTilePositions;
+
+	for(int tileIndex = 0; tileIndex < static_cast<int>(map->m_tiles.size()); ++tileIndex)
+	{
+		Tile const& tile = map->m_tiles[tileIndex];
+
+		if(tile.HasDefinition() && !tile.IsTileSolid())
+		{
+			openTilePositions.push_back(Vec3(static_cast<float>(tileIndex % map->m_bounds.x), static_cast<float>(tileIndex / map->m_bounds.x), 0.f));
+		}
+	}
+
+	if(openTilePositions.empty())
+	{
+		PrintBenchmarkLine("BenchmarkRaycasts: map has no open tiles");
+		return false;
+	}
+
+	int const	actorCounts[] = { 1000, 10000 };
+	int const	numRays = 20000;
+	float const	rayRange = 32.f;
+	IntRange	tileRange = IntRange(0, static_cast<int>(openTilePositions.size()) - 1);
+	FloatRange	offsetRange = FloatRange(0.2f, 0.8f);
+	FloatRange	yawRange = FloatRange(0.f, 360.f);
+	FloatRange	pitchRange = FloatRange(-10.f, 10.f);
+	int const	pelletsPerVolley = 16;
+	float const	pelletConeDegrees = 5.f;
+
+	PrintBenchmarkLine(Stringf("BenchmarkRaycasts on %s (%d rays of length %.0f per sample)", map->m_mapDef->m_name.c_str(), numRays, rayRange));
+
+	for(int actorCount : actorCounts)
+	{
+		std::vector<ActorHandle> benchmarkActors;
+		benchmarkActors.reserve(actorCount);
+
+		SpawnInfo spawnInfo;
+		spawnInfo.m_actorName = "Demon";
+
+		for(int spawnIndex = 0; spawnIndex < actorCount; ++spawnIndex)
+		{
+			Vec3 tileMins = openTilePositions[tileRange.GetRandomInt()];
+			spawnInfo.m_position = Vec3(tileMins.x + offsetRange.GetRandomFloat(), tileMins.y + offsetRange.GetRandomFloat(), 0.f);
+
+			Actor* actor = map->SpawnActor(spawnInfo);
+			benchmarkActors.push_back(actor->m_handle);
+		}
+
+		map->RebuildActorGrid();
+
+		std::vector<Vec3> rayStarts;
+		std::vector<Vec3> rayDirections;
+		rayStarts.reserve(numRays);
+		rayDirections.reserve(numRays);
+
+		for(int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			Vec3 tileMins = openTilePositions[tileRange.GetRandomInt()];
+			rayStarts.push_back(Vec3(tileMins.x + offsetRange.GetRandomFloat(), tileMins.y + offsetRange.GetRandomFloat(), 0.5f));
+
+			Vec3 fwd;
+			Vec3 left;
+			Vec3 up;
+			EulerAngles(yawRange.GetRandomFloat(), pitchRange.GetRandomFloat(), 0.f).GetAsVectors_IFwd_JLeft_KUp(fwd, left, up);
+			rayDirections.push_back(fwd);
+		}
+
+		std::vector<RaycastResult> fullScanResults(numRays);
+		std::vector<RaycastResult> clampedResults(numRays);
+
+		// before: every actor slot, the floor and the walls are tested over the whole ray and the nearest hit wins
+		double startTime = GetCurrentTimeSeconds();
+
+		for(int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			Vec3 const& start = rayStarts[rayIndex];
+			Vec3 const& fwd = rayDirections[rayIndex];
+
+			RaycastResult raycastVsActors;
+			raycastVsActors.m_rayResult.m_impactDistance = 9999999.f;
+
+			for(Actor* actor : map->m_allActors)
+			{
+				if(actor)
+				{
+					RaycastResult3D rayVsActor = RaycastVsCylinder3D(start, fwd, rayRange, Cylinder3D(actor->m_position, actor->m_definition->m_physicsHeight, actor->m_definition->m_physicsRadius));
+
+					if(rayVsActor.m_didImpact && rayVsActor.m_impactDistance < raycastVsActors.m_rayResult.m_impactDistance)
+					{
+						raycastVsActors.m_rayResult = rayVsActor;
+						raycastVsActors.m_hitActor = actor;
+					}
+				}
+			}
+
+			RaycastResult raycastVsFloor = map->RaycastVsFloor(start, fwd, rayRange);
+			RaycastResult raycastVsWalls = map->RaycastVsWalls(start, fwd, rayRange);
+
+			if(raycastVsActors.m_rayResult.m_impactDistance < raycastVsFloor.m_rayResult.m_impactDistance && raycastVsActors.m_rayResult.m_impactDistance < raycastVsWalls.m_rayResult.m_impactDistance)
+			{
+				fullScanResults[rayIndex] = raycastVsActors;
+			}
+			else if(raycastVsFloor.m_rayResult.m_impactDistance < raycastVsWalls.m_rayResult.m_impactDistance)
+			{
+				fullScanResults[rayIndex] = raycastVsFloor;
+			}
+			else
+			{
+				fullScanResults[rayIndex] = raycastVsWalls;
+			}
+		}
+
+		double fullScanSeconds = GetCurrentTimeSeconds() - startTime;
+
+		// after: walls first, then the floor and the actors in the grid cells along the clamped ray
+		startTime = GetCurrentTimeSeconds();
+
+		for(int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			clampedResults[rayIndex] = map->RaycastAll(rayStarts[rayIndex], rayDirections[rayIndex], rayRange);
+		}
+
+		double clampedSeconds = GetCurrentTimeSeconds() - startTime;
+
+		int numMismatches = 0;
+		int numActorHits = 0;
+
+		for(int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			RaycastResult const& before = fullScanResults[rayIndex];
+			RaycastResult const& after = clampedResults[rayIndex];
+
+			bool sameHit = before.m_hitActor == after.m_hitActor && before.m_rayResult.m_didImpact == after.m_rayResult.m_didImpact;
+			bool sameDistance = fabsf(before.m_rayResult.m_impactDistance - after.m_rayResult.m_impactDistance) < 0.001f;
+
+			numMismatches += (sameHit && sameDistance) ? 0 : 1;
+			numActorHits += after.m_hitActor ? 1 : 0;
+		}
+
+		PrintBenchmarkLine(Stringf("  %6d demons: full scan %10.0f rays/sec, wall clamped %10.0f rays/sec, %d actor hits, %d mismatches",
+			actorCount, static_cast<double>(numRays) / fullScanSeconds, static_cast<double>(numRays) / clampedSeconds, numActorHits, numMismatches));
+
+		// shotgun volleys: the same pellets traced one RaycastAll at a time and then as one RaycastBatch per volley
+		int const	numVolleys = numRays / pelletsPerVolley;
+		FloatRange	pelletConeRange = FloatRange(-pelletConeDegrees, pelletConeDegrees);
+
+		std::vector<RayQuery> pelletRays;
+		pelletRays.reserve(numVolleys * pelletsPerVolley);
+
+		for(int volleyIndex = 0; volleyIndex < numVolleys; ++volleyIndex)
+		{
+			Vec3 tileMins = openTilePositions[tileRange.GetRandomInt()];
+			Vec3 volleyStart = Vec3(tileMins.x + offsetRange.GetRandomFloat(), tileMins.y + offsetRange.GetRandomFloat(), 0.5f);
+			float volleyYaw = yawRange.GetRandomFloat();
+
+			for(int pelletIndex = 0; pelletIndex < pelletsPerVolley; ++pelletIndex)
+			{
+				RayQuery pelletRay;
+				pelletRay.m_startPosition = volleyStart;
+				pelletRay.m_distance = rayRange;
+
+				Vec3 left;
+				Vec3 up;
+				EulerAngles(volleyYaw + pelletConeRange.GetRandomFloat(), pelletConeRange.GetRandomFloat(), 0.f).GetAsVectors_IFwd_JLeft_KUp(pelletRay.m_fwdNormal, left, up);
+
+				pelletRays.push_back(pelletRay);
+			}
+		}
+
+		std::vector<RaycastResult> singleResults(pelletRays.size());
+		std::vector<RaycastResult> batchResults(pelletRays.size());
+		std::vector<RayQuery> volleyRays(pelletsPerVolley);
+		std::vector<RaycastResult> volleyResults;
+
+		startTime = GetCurrentTimeSeconds();
+
+		for(size_t rayIndex = 0; rayIndex < pelletRays.size(); ++rayIndex)
+		{
+			singleResults[rayIndex] = map->RaycastAll(pelletRays[rayIndex].m_startPosition, pelletRays[rayIndex].m_fwdNormal, pelletRays[rayIndex].m_distance);
+		}
+
+		double singleSeconds = GetCurrentTimeSeconds() - startTime;
+		startTime = GetCurrentTimeSeconds();
+
+		for(int volleyIndex = 0; volleyIndex < numVolleys; ++volleyIndex)
+		{
+			std::copy(pelletRays.begin() + volleyIndex * pelletsPerVolley, pelletRays.begin() + (volleyIndex + 1) * pelletsPerVolley, volleyRays.begin());
+
+			map->RaycastBatch(volleyRays, volleyResults);
+
+			std::copy(volleyResults.begin(), volleyResults.end(), batchResults.begin() + volleyIndex * pelletsPerVolley);
+		}
+
+		double batchSeconds = GetCurrentTimeSeconds() - startTime;
+
+		int numBatchMismatches = 0;
+
+		for(size_t rayIndex = 0; rayIndex < pelletRays.size(); ++rayIndex)
+		{
+			RaycastResult const& single = singleResults[rayIndex];
+			RaycastResult const& batched = batchResults[rayIndex];
+
+			bool sameHit = single.m_hitActor == batched.m_hitActor && single.m_rayResult.m_didImpact == batched.m_rayResult.m_didImpact;
+			bool sameDistance = fabsf(single.m_rayResult.m_impactDistance - batched.m_rayResult.m_impactDistance) < 0.001f;
+
+			numBatchMismatches += (sameHit && sameDistance) ? 0 : 1;
+		}
+
+		double numPellets = static_cast<double>(pelletRays.size());
+
+		PrintBenchmarkLine(Stringf("  %6d demons: %d-pellet volleys, RaycastAll %10.0f rays/sec, RaycastBatch %10.0f rays/sec, %d mismatches",
+			actorCount, pelletsPerVolley, numPellets / singleSeconds, numPellets / batchSeconds, numBatchMismatches));
+
+		for(ActorHandle const& handle : benchmarkActors)
+		{
+			Actor* actor = map->GetActorByHandle(handle);
+
+			if(actor)
+			{
+				map->DestroyActor(static_cast<int>(handle.GetIndex()));
+			}
+		}
+
+		map->RebuildActorGrid();
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Checks the CylinderBatch kernels against the engine's scalar RaycastVsCylinder3D on random cylinders and rays, with
+// several cylinders stacked on the same spot so ties are exercised too. Needs no map.
+bool Map::Event_VerifyRayKernels(EventArgs& args)
+{
+	UNUSED(args);
+
+	int const	numTrials = 20000;
+	int const	maxCylinders = 37;
+	float const	rayRange = 8.f;
+	FloatRange	positionRange = FloatRange(0.f, 6.f);
+	FloatRange	baseHeightRange = FloatRange(0.f, 0.5f);
+	FloatRange	radiusRange = FloatRange(0.1f, 0.6f);
+	FloatRange	heightRange = FloatRange(0.2f, 1.2f);
+	FloatRange	yawRange = FloatRange(0.f, 360.f);
+	FloatRange	pitchRange = FloatRange(-60.f, 60.f);
+
+	CylinderBatch batch;
+	std::vector<Cylinder3D> cylinders;
+
+	int numKernelMismatches = 0;
+	int numEngineMismatches = 0;
+	int numHits = 0;
+
+	for(int trial = 0; trial < numTrials; ++trial)
+	{
+		batch.Clear();
+		cylinders.clear();
+
+		int numCylinders = 1 + trial % maxCylinders;
+
+		for(int cylinderIndex = 0; cylinderIndex < numCylinders; ++cylinderIndex)
+		{
+			Vec3 bottomCenter = Vec3(positionRange.GetRandomFloat(), positionRange.GetRandomFloat(), baseHeightRange.GetRandomFloat());
+			float height = heightRange.GetRandomFloat();
+			float radius = radiusRange.GetRandomFloat();
+
+			if(cylinderIndex % 4 == 3)
+			{
+				bottomCenter = cylinders[0].m_startPosition;
+				height = cylinders[0].m_height;
+				radius = cylinders[0].m_radius;
+			}
+
+			batch.AddCylinder(bottomCenter, height, radius, cylinderIndex);
+			cylinders.push_back(Cylinder3D(bottomCenter, height, radius));
+		}
+
+		Vec3 start = Vec3(positionRange.GetRandomFloat(), positionRange.GetRandomFloat(), 1.5f * baseHeightRange.GetRandomFloat() + 0.25f);
+		Vec3 fwd;
+		Vec3 left;
+		Vec3 up;
+		EulerAngles(yawRange.GetRandomFloat(), pitchRange.GetRandomFloat(), 0.f).GetAsVectors_IFwd_JLeft_KUp(fwd, left, up);
+
+		RaycastResult3D kernelResult;
+		RaycastResult3D scalarResult;
+
+		int kernelIndex = batch.RaycastNearest(start, fwd, rayRange, kernelResult);
+		int scalarIndex = batch.RaycastNearestScalar(start, fwd, rayRange, scalarResult);
+
+		// the path RaycastVsActors used before: one engine call per cylinder, first strictly nearer hit wins
+		int engineIndex = -1;
+		RaycastResult3D engineResult;
+
+		for(int cylinderIndex = 0; cylinderIndex < numCylinders; ++cylinderIndex)
+		{
+			RaycastResult3D rayVsCylinder = RaycastVsCylinder3D(start, fwd, rayRange, cylinders[cylinderIndex]);
+
+			if(rayVsCylinder.m_didImpact && (engineIndex < 0 || rayVsCylinder.m_impactDistance < engineResult.m_impactDistance))
+			{
+				engineResult = rayVsCylinder;
+				engineIndex = cylinderIndex;
+			}
+		}
+
+		bool kernelsAgree = kernelIndex == scalarIndex && (kernelIndex < 0 || kernelResult.m_impactDistance == scalarResult.m_impactDistance);
+		bool engineAgrees = scalarIndex == engineIndex && (scalarIndex < 0 || fabsf(scalarResult.m_impactDistance - engineResult.m_impactDistance) < 0.001f);
+
+		numKernelMismatches += kernelsAgree ? 0 : 1;
+		numEngineMismatches += engineAgrees ? 0 : 1;
+		numHits += (scalarIndex >= 0) ? 1 : 0;
+	}
+
+	PrintBenchmarkLine(Stringf("VerifyRayKernels: %d random rays vs 1-%d cylinders, %s kernel, %d hits", numTrials, maxCylinders, CylinderBatch::GetKernelName(), numHits));
+	PrintBenchmarkLine(Stringf("  %s vs scalar kernel: %d mismatches", CylinderBatch::GetKernelName(), numKernelMismatches));
+	PrintBenchmarkLine(Stringf("  scalar kernel vs RaycastVsCylinder3D: %d mismatches", numEngineMismatches));
+
+	// throughput: the same rays against one batch of 64 cylinders through each path
+	int const numTimedRays = 20000;
+	int const numTimedCylinders = 64;
+
+	batch.Clear();
+	cylinders.clear();
+
+	for(int cylinderIndex = 0; cylinderIndex < numTimedCylinders; ++cylinderIndex)
+	{
+		Vec3 bottomCenter = Vec3(positionRange.GetRandomFloat(), positionRange.GetRandomFloat(), 0.f);
+
+		batch.AddCylinder(bottomCenter, 0.75f, 0.35f, cylinderIndex);
+		cylinders.push_back(Cylinder3D(bottomCenter, 0.75f, 0.35f));
+	}
+
+	std::vector<Vec3> rayStarts(numTimedRays);
+	std::vector<Vec3> rayDirections(numTimedRays);
+
+	for(int rayIndex = 0; rayIndex < numTimedRays; ++rayIndex)
+	{
+		Vec3 left;
+		Vec3 up;
+		rayStarts[rayIndex] = Vec3(positionRange.GetRandomFloat(), positionRange.GetRandomFloat(), 0.5f);
+		EulerAngles(yawRange.GetRandomFloat(), 0.5f * pitchRange.GetRandomFloat(), 0.f).GetAsVectors_IFwd_JLeft_KUp(rayDirections[rayIndex], left, up);
+	}
+
+	int numTimedHits = 0;
+	RaycastResult3D timedResult;
+
+	double startTime = GetCurrentTimeSeconds();
+
+	for(int rayIndex = 0; rayIndex < numTimedRays; ++rayIndex)
+	{
+		numTimedHits += (batch.RaycastNearest(rayStarts[rayIndex], rayDirections[rayIndex], rayRange, timedResult) >= 0) ? 1 : 0;
+	}
+
+	double kernelSeconds = GetCurrentTimeSeconds() - startTime;
+	startTime = GetCurrentTimeSeconds();
+
+	for(int rayIndex = 0; rayIndex < numTimedRays; ++rayIndex)
+	{
+		numTimedHits += (batch.RaycastNearestScalar(rayStarts[rayIndex], rayDirections[rayIndex], rayRange, timedResult) >= 0) ? 1 : 0;
+	}
+
+	double scalarSeconds = GetCurrentTimeSeconds() - startTime;
+	startTime = GetCurrentTimeSeconds();
+
+	for(int rayIndex = 0; rayIndex < numTimedRays; ++rayIndex)
+	{
+		for(Cylinder3D const& cylinder : cylinders)
+		{
+			numTimedHits += RaycastVsCylinder3D(rayStarts[rayIndex], rayDirections[rayIndex], rayRange, cylinder).m_didImpact ? 1 : 0;
+		}
+	}
+
+	double engineSeconds = GetCurrentTimeSeconds() - startTime;
+	double numCylinderTests = static_cast<double>(numTimedRays) * static_cast<double>(numTimedCylinders);
+
+	PrintBenchmarkLine(Stringf("  %d rays x %d cylinders (%d hits counted so the loops are kept):", numTimedRays, numTimedCylinders, numTimedHits));
+	PrintBenchmarkLine(Stringf("    %-20s %10.1f cylinder tests/us", CylinderBatch::GetKernelName(), numCylinderTests / (kernelSeconds * 1000000.0)));
+	PrintBenchmarkLine(Stringf("    %-20s %10.1f cylinder tests/us", "scalar kernel", numCylinderTests / (scalarSeconds * 1000000.0)));
+	PrintBenchmarkLine(Stringf("    %-20s %10.1f cylinder tests/us", "RaycastVsCylinder3D", numCylinderTests / (engineSeconds * 1000000.0)));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Per-actor integration as Actor::PhysicsUpdate did it before ActorPhysicsSystem, kept here as the benchmark baseline
+static void IntegrateActorTheOldWay(Actor& actor, float deltaSeconds)
+{
+	if(actor.m_state == ActorState::DYING || actor.m_state == ActorState::DEAD)
+	{
+		return;
+	}
+
+	float gravity = g_gameConfigBlackboard.GetValue("gravity", 0.0f);
+	float drag = actor.m_isGrounded ? actor.m_definition->m_drag : 0.f;
+
+	actor.AddForce(-actor.m_velocity * drag);
+
+	if(!actor.m_isGrounded && actor.m_definition->m_effectedByGravity)
+	{
+		actor.AddForce(Vec3::DOWN * gravity);
+	}
+
+	actor.m_position += actor.m_velocity * deltaSeconds;
+	actor.m_velocity += actor.m_acceleration * deltaSeconds;
+	actor.m_acceleration = Vec3::ZERO;
+
+	if(actor.m_definition->m_isLightSource)
+	{
+		actor.m_light.SetPosition(actor.m_position);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Map::Event_BenchmarkPhysics(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("BenchmarkPhysics: no map is loaded");
+		return false;
+	}
+
+	int const	actorCounts[] = { 1000, 10000 };
+	int const	numTicks = 50;
+	float const	deltaSeconds = 1.f / 240.f;
+	FloatRange	positionRange = FloatRange(1.f, static_cast<float>(map->m_bounds.x) - 1.f);
+	FloatRange	velocityRange = FloatRange(-3.f, 3.f);
+
+	PrintBenchmarkLine(Stringf("BenchmarkPhysics on %s (%d integration ticks per sample, half the demons airborne)", map->m_mapDef->m_name.c_str(), numTicks));
+
+	for(int actorCount : actorCounts)
+	{
+		ActorList benchmarkActors;
+		benchmarkActors.reserve(actorCount);
+
+		SpawnInfo spawnInfo;
+		spawnInfo.m_actorName = "Demon";
+
+		for(int spawnIndex = 0; spawnIndex < actorCount; ++spawnIndex)
+		{
+			spawnInfo.m_position = Vec3(positionRange.GetRandomFloat(), positionRange.GetRandomFloat(), 0.f);
+
+			Actor* actor = map->SpawnActor(spawnInfo);
+			actor->m_velocity = Vec3(velocityRange.GetRandomFloat(), velocityRange.GetRandomFloat(), velocityRange.GetRandomFloat());
+			actor->m_isGrounded = (spawnIndex % 2) == 0;
+
+			benchmarkActors.push_back(actor);
+		}
+
+		std::vector<Vec3> startPositions;
+		std::vector<Vec3> startVelocities;
+
+		for(Actor* actor : benchmarkActors)
+		{
+			startPositions.push_back(actor->m_position);
+			startVelocities.push_back(actor->m_velocity);
+		}
+
+		// before: one update per actor through its pointer, with a blackboard lookup each
+		double startTime = GetCurrentTimeSeconds();
+
+		for(int tick = 0; tick < numTicks; ++tick)
+		{
+			for(Actor* actor : benchmarkActors)
+			{
+				IntegrateActorTheOldWay(*actor, deltaSeconds);
+			}
+		}
+
+		double perActorSeconds = GetCurrentTimeSeconds() - startTime;
+
+		std::vector<Vec3> perActorPositions;
+
+		for(size_t actorIndex = 0; actorIndex < benchmarkActors.size(); ++actorIndex)
+		{
+			perActorPositions.push_back(benchmarkActors[actorIndex]->m_position);
+
+			benchmarkActors[actorIndex]->m_position = startPositions[actorIndex];
+			benchmarkActors[actorIndex]->m_velocity = startVelocities[actorIndex];
+			benchmarkActors[actorIndex]->m_acceleration = Vec3::ZERO;
+		}
+
+		// after: gather, one loop over contiguous arrays, scatter
+		ActorPhysicsSystem physicsSystem;
+		physicsSystem.Initialize();
+
+		double integrateSeconds = 0.0;
+		startTime = GetCurrentTimeSeconds();
+
+		for(int tick = 0; tick < numTicks; ++tick)
+		{
+			physicsSystem.Gather(benchmarkActors);
+
+			double integrateStartTime = GetCurrentTimeSeconds();
+			physicsSystem.Integrate(deltaSeconds);
+			integrateSeconds += GetCurrentTimeSeconds() - integrateStartTime;
+
+			physicsSystem.Scatter(benchmarkActors);
+		}
+
+		double systemSeconds = GetCurrentTimeSeconds() - startTime;
+
+		int numMismatches = 0;
+
+		for(size_t actorIndex = 0; actorIndex < benchmarkActors.size(); ++actorIndex)
+		{
+			numMismatches += (benchmarkActors[actorIndex]->m_position == perActorPositions[actorIndex]) ? 0 : 1;
+		}
+
+		double numIntegrations = static_cast<double>(actorCount) * static_cast<double>(numTicks);
+
+		PrintBenchmarkLine(Stringf("  %6d demons: per actor %9.0f, system %9.0f, integrate loop alone %9.0f actors/ms, %d mismatches",
+			actorCount, numIntegrations / (perActorSeconds * 1000.0), numIntegrations / (systemSeconds * 1000.0), numIntegrations / (integrateSeconds * 1000.0), numMismatches));
+
+		for(Actor* actor : benchmarkActors)
+		{
+			map->DestroyActor(static_cast<int>(actor->m_handle.GetIndex()));
+		}
+
+		map->RebuildActorGrid();
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Prints how many fixed physics ticks the last frame ran and what they cost, the peaks and dropped ticks since the last
+// report, then resets them
+bool Map::Event_ReportPhysicsStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("ReportPhysicsStats: no map is loaded");
+		return false;
+	}
+
+	PhysicsStepStats lastFrame = map->m_lastPhysicsStepStats;
+	PhysicsStepStats peak = map->m_peakPhysicsStepStats;
+	double averageMilliseconds = map->m_numPhysicsStatFrames > 0 ? map->m_totalPhysicsStepMilliseconds / static_cast<double>(map->m_numPhysicsStatFrames) : 0.0;
+
+	PrintBenchmarkLine(Stringf("ReportPhysicsStats: %.0f ticks per second, at most %d ticks per frame", 1.f / map->m_physicsStepSeconds, map->m_maxPhysicsTicksPerFrame));
+	PrintBenchmarkLine(Stringf("ReportPhysicsStats: last frame %d ticks, %.3f ms", lastFrame.m_numTicks, lastFrame.m_stepMilliseconds));
+	PrintBenchmarkLine(Stringf("ReportPhysicsStats: peak %d ticks, %.3f ms; %d ticks dropped; average %.3f ms per frame", peak.m_numTicks, peak.m_stepMilliseconds, peak.m_numDroppedTicks, averageMilliseconds));
+
+	map->m_peakPhysicsStepStats			= PhysicsStepStats();
+	map->m_totalPhysicsStepMilliseconds	= 0.0;
+	map->m_numPhysicsStatFrames			= 0;
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static int CountLiveActors(ActorList const& actors)
+{
+	int numActors = 0;
+
+	for(Actor const* actor : actors)
+	{
+		if(actor)
+		{
+			++numActors;
+		}
+	}
+
+	return numActors;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Times saving and restoring a snapshot of the map as it is, then with extra demons dropped in, and checks every restore
+// gives back the state hash it was saved with. Ends by restoring the snapshot taken before it started.
+bool Map::Event_BenchmarkSnapshots(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		PrintBenchmarkLine("BenchmarkSnapshots: no map is loaded");
+		return false;
+	}
+
+	int const extraDemonCounts[] = { 0, 500, 2000 };
+	int const numIterations = 100;
+
+	MapSnapshot originalSnapshot;
+	MapSnapshot snapshot;
+	map->SaveSnapshot(originalSnapshot);
+
+	PrintBenchmarkLine(Stringf("BenchmarkSnapshots on %s (%d iterations per sample)", map->m_mapDef->m_name.c_str(), numIterations));
+
+	for(int extraDemonCount : extraDemonCounts)
+	{
+		for(int spawnIndex = 0; spawnIndex < extraDemonCount; ++spawnIndex)
+		{
+			map->SpawnDemon();
+		}
+
+		unsigned int stateHash = map->GetStateHash();
+
+		// the first save sizes the buffer; later ones reuse it like a per-frame rewind buffer would
+		map->SaveSnapshot(snapshot);
+
+		double startTime = GetCurrentTimeSeconds();
+
+		for(int iteration = 0; iteration < numIterations; ++iteration)
+		{
+			map->SaveSnapshot(snapshot);
+		}
+
+		double saveMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0 / static_cast<double>(numIterations);
+		int numFailedRestores = 0;
+
+		startTime = GetCurrentTimeSeconds();
+
+		for(int iteration = 0; iteration < numIterations; ++iteration)
+		{
+			if(!map->RestoreSnapshot(snapshot))
+			{
+				++numFailedRestores;
+			}
+		}
+
+		double restoreMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0 / static_cast<double>(numIterations);
+
+		bool doesHashMatch = map->GetStateHash() == stateHash;
+
+		PrintBenchmarkLine(Stringf("  %5d actors: %7d bytes  save %.3f ms  restore %.3f ms  %d failed restores  %s", CountLiveActors(map->m_allActors), static_cast<int>(snapshot.GetNumBytes()), saveMilliseconds, restoreMilliseconds, numFailedRestores, doesHashMatch ? "state hash matches" : "STATE HASH MISMATCH"));
+	}
+
+	if(!map->RestoreSnapshot(originalSnapshot))
+	{
+		PrintBenchmarkLine("BenchmarkSnapshots: could not restore the map to where it started");
+	}
+
+	return false;
+}
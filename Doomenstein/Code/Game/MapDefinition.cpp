@@ -15,16 +15,21 @@ MapDefinition::MapDefinition(XmlElement const& mapDefElement)
 	
 	imagePath = ParseXmlAttribute(mapDefElement, "image", imagePath);
 	m_mapImage = Image(imagePath.c_str());
+	m_imagePath = imagePath;
 	
 	textureFilePath = ParseXmlAttribute(mapDefElement, "spriteSheetTexture", textureFilePath);
-	m_spriteSheetTexture = g_theRenderer->CreateOrGetTextureFromFile(textureFilePath.c_str());
-
 	shaderName = ParseXmlAttribute(mapDefElement, "shader", shaderName);
-	m_mapShader = g_theRenderer->CreateOrGetShader(shaderName.c_str(), InputLayoutType::VERTEX_PCUTBN);
+
+	if(g_theRenderer)
+	{
+		m_spriteSheetTexture = g_theRenderer->CreateOrGetTextureFromFile(textureFilePath.c_str());
+		m_mapShader = g_theRenderer->CreateOrGetShader(shaderName.c_str(), InputLayoutType::VERTEX_PCUTBN);
+	}
 	
 	m_spriteSheetCellCount = ParseXmlAttribute(mapDefElement, "spriteSheetCellCount", m_spriteSheetCellCount);
 
 	InitializeSpawnDefinition(mapDefElement);
+	InitializeActorPools(mapDefElement);
 
 }
 
@@ -57,7 +62,7 @@ void MapDefinition::InitializeMapDefinition()
 void MapDefinition::InitializeSpawnDefinition(XmlElement const& mapDefElement)
 {
 	// <SpawnInfos>, grand child of <Definitions>, child of <MapDefinitions>, kinda like a root (?)
-	XmlElement const* spawnRootElement = mapDefElement.FirstChildElement();
+	XmlElement const* spawnRootElement = mapDefElement.FirstChildElement("SpawnInfos");
 	GUARANTEE_OR_DIE(spawnRootElement, "Failed to access root element of Spawn Infos");
 
 	// <SpawnInfo>
@@ -76,6 +81,38 @@ void MapDefinition::InitializeSpawnDefinition(XmlElement const& mapDefElement)
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void MapDefinition::InitializeActorPools(XmlElement const& mapDefElement)
+{
+	// <ActorPools> is optional, maps without it simply allocate every actor on spawn
+	XmlElement const* poolRootElement = mapDefElement.FirstChildElement("ActorPools");
+
+	if(!poolRootElement)
+	{
+		return;
+	}
+
+	XmlElement const* actorPoolElement = poolRootElement->FirstChildElement();
+
+	while(actorPoolElement)
+	{
+		std::string elementName = actorPoolElement->Name();
+		GUARANTEE_OR_DIE(elementName == "ActorPool", "Element name has to be \"ActorPool\"");
+
+		ActorPoolInfo actorPoolInfo = ActorPoolInfo(*actorPoolElement);
+		m_actorPools.push_back(actorPoolInfo);
+
+		actorPoolElement = actorPoolElement->NextSiblingElement();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+ActorPoolInfo::ActorPoolInfo(XmlElement const& actorPoolElement)
+{
+	m_actorName = ParseXmlAttribute(actorPoolElement, "actor", m_actorName);
+	m_size = ParseXmlAttribute(actorPoolElement, "size", m_size);
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 SpawnInfo::SpawnInfo(XmlElement const& spawnInfoElement)
 {	
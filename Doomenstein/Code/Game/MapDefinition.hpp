@@ -24,12 +24,29 @@
  public:
 
 	 std::string m_actorName;
+	 int		 m_actorDefID = -1; // used instead of m_actorName when set, so runtime spawns skip the name lookup
 	 Vec3		m_position = Vec3(0.f, 0.f, 0.f);
 	 EulerAngles m_orientation = EulerAngles(0.f, 0.f, 0.f);
 	 Vec3		m_velocity = Vec3(0.f, 0.f, 0.f);
 
  };
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// One <ActorPool> of a map definition: how many actors of a definition Map pre-allocates and recycles
+class ActorPoolInfo
+{
+public:
+	ActorPoolInfo() = default;
+	explicit ActorPoolInfo(XmlElement const& actorPoolElement);
+
+	~ActorPoolInfo() = default;
+
+public:
+
+	std::string m_actorName;
+	int			m_size = 0;
+};
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 class MapDefinition
 {
@@ -43,13 +60,16 @@ public:
 
 	static void InitializeMapDefinition();
 	void InitializeSpawnDefinition(XmlElement const& mapDefElement);
+	void InitializeActorPools(XmlElement const& mapDefElement);
 public:
 
 	static std::vector<MapDefinition> s_definitions;
 	
 	std::vector<SpawnInfo> m_spawnDefinitions;
+	std::vector<ActorPoolInfo> m_actorPools;
 
 	std::string m_name				 = "Unknown";
+	std::string m_imagePath;
 	Texture*	m_spriteSheetTexture = nullptr;
 	Shader*		m_mapShader			 = nullptr;
 
@@ -0,0 +1,1038 @@
+#include "Game/MapSnapshot.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/WeaponDefinition.hpp"
+#include "Game/Actor.hpp"
+#include "Game/Weapon.hpp"
+#include "Game/Game.hpp"
+#include "Game/PlayerController.hpp"
+#include "Game/AIController.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Bumped whenever the layout written by Map::SaveSnapshot changes; older files are rejected rather than misread
+constexpr unsigned int MAP_SNAPSHOT_FILE_MAGIC	 = 0x314e534d; // "MSN1"
+constexpr unsigned int MAP_SNAPSHOT_FILE_VERSION = 1;
+
+// Which controller drives an actor, stored in place of the controller pointer
+constexpr unsigned char SNAPSHOT_POSSESSED_BY_NONE	 = 0;
+constexpr unsigned char SNAPSHOT_POSSESSED_BY_AI	 = 1;
+constexpr unsigned char SNAPSHOT_POSSESSED_BY_PLAYER = 2;
+
+extern Game* g_game;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<typename T>
+static void WriteSnapshotValue(std::vector<unsigned char>& bytes, T const& value)
+{
+	unsigned char const* valueBytes = reinterpret_cast<unsigned char const*>(&value);
+	bytes.insert(bytes.end(), valueBytes, valueBytes + sizeof(T));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<typename T>
+static void WriteSnapshotArray(std::vector<unsigned char>& bytes, std::vector<T> const& values)
+{
+	WriteSnapshotValue(bytes, static_cast<unsigned int>(values.size()));
+
+	unsigned char const* valueBytes = reinterpret_cast<unsigned char const*>(values.data());
+	bytes.insert(bytes.end(), valueBytes, valueBytes + values.size() * sizeof(T));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Reads past the end of the bytes fail and leave value untouched; callers check once at the end that nothing failed
+struct MapSnapshotReader
+{
+	std::vector<unsigned char> const&	m_bytes;
+	size_t								m_offset	= 0;
+	bool								m_isValid	= true;
+
+	explicit MapSnapshotReader(std::vector<unsigned char> const& bytes) : m_bytes(bytes) {}
+
+	template<typename T>
+	void Read(T& out_value)
+	{
+		if(!m_isValid || m_offset + sizeof(T) > m_bytes.size())
+		{
+			m_isValid = false;
+			return;
+		}
+
+		memcpy(&out_value, m_bytes.data() + m_offset, sizeof(T));
+		m_offset += sizeof(T);
+	}
+
+	// Steps over values without decoding them, so a snapshot can be checked for size before anything reads it for real
+	template<typename T>
+	void Skip(size_t numValues = 1)
+	{
+		if(!m_isValid || m_offset + numValues * sizeof(T) > m_bytes.size())
+		{
+			m_isValid = false;
+			return;
+		}
+
+		m_offset += numValues * sizeof(T);
+	}
+
+	template<typename T>
+	void SkipArray()
+	{
+		unsigned int numValues = 0;
+		Read(numValues);
+		Skip<T>(numValues);
+	}
+
+	template<typename T>
+	void ReadArray(std::vector<T>& out_values)
+	{
+		unsigned int numValues = 0;
+		Read(numValues);
+
+		if(!m_isValid || m_offset + numValues * sizeof(T) > m_bytes.size())
+		{
+			m_isValid = false;
+			return;
+		}
+
+		out_values.resize(numValues);
+
+		if(numValues > 0)
+		{
+			memcpy(out_values.data(), m_bytes.data() + m_offset, numValues * sizeof(T));
+		}
+
+		m_offset += numValues * sizeof(T);
+	}
+
+	void ReadString(std::string& out_text)
+	{
+		unsigned short length = 0;
+		Read(length);
+
+		if(!m_isValid || m_offset + length > m_bytes.size())
+		{
+			m_isValid = false;
+			return;
+		}
+
+		out_text.assign(reinterpret_cast<char const*>(m_bytes.data() + m_offset), length);
+		m_offset += length;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool MapSnapshot::LoadFromFile(std::string const& filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	MapSnapshotReader reader(buffer);
+
+	unsigned int magic	 = 0;
+	unsigned int version = 0;
+	reader.Read(magic);
+	reader.Read(version);
+
+	if(!reader.m_isValid || magic != MAP_SNAPSHOT_FILE_MAGIC || version != MAP_SNAPSHOT_FILE_VERSION)
+	{
+		return false;
+	}
+
+	std::string mapName;
+	double		gameSeconds = 0.0;
+	unsigned int numBytes	= 0;
+
+	reader.ReadString(mapName);
+	reader.Read(gameSeconds);
+	reader.Read(numBytes);
+
+	// a truncated or padded file would restore half a map, so the state has to fill the rest of the file exactly
+	if(!reader.m_isValid || reader.m_offset + numBytes != buffer.size())
+	{
+		return false;
+	}
+
+	m_mapName	  = mapName;
+	m_gameSeconds = gameSeconds;
+	m_bytes.assign(buffer.begin() + reader.m_offset, buffer.end());
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool MapSnapshot::SaveToFile(std::string const& filePath) const
+{
+	std::vector<unsigned char> buffer;
+	buffer.reserve(m_bytes.size() + m_mapName.size() + 32);
+
+	WriteSnapshotValue(buffer, MAP_SNAPSHOT_FILE_MAGIC);
+	WriteSnapshotValue(buffer, MAP_SNAPSHOT_FILE_VERSION);
+	WriteSnapshotValue(buffer, static_cast<unsigned short>(m_mapName.size()));
+	buffer.insert(buffer.end(), m_mapName.begin(), m_mapName.end());
+	WriteSnapshotValue(buffer, m_gameSeconds);
+	WriteSnapshotValue(buffer, static_cast<unsigned int>(m_bytes.size()));
+	buffer.insert(buffer.end(), m_bytes.begin(), m_bytes.end());
+
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+	return file.good();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Keeps the buffer's capacity for the next save
+void MapSnapshot::Clear()
+{
+	m_mapName.clear();
+	m_gameSeconds = 0.0;
+	m_bytes.clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool MapSnapshot::IsEmpty() const
+{
+	return m_bytes.empty();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+size_t MapSnapshot::GetNumBytes() const
+{
+	return m_bytes.size();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void WriteSnapshotTimer(std::vector<unsigned char>& bytes, Timer const& timer)
+{
+	WriteSnapshotValue(bytes, timer.m_period);
+	WriteSnapshotValue(bytes, timer.m_startTime);
+	WriteSnapshotValue(bytes, timer.IsStopped());
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The timer keeps its own clock; a running timer's start moves with the clock so the time it has left is unchanged
+static void ReadSnapshotTimer(MapSnapshotReader& reader, Timer& timer, double clockOffsetSeconds)
+{
+	bool isStopped = true;
+
+	reader.Read(timer.m_period);
+	reader.Read(timer.m_startTime);
+	reader.Read(isStopped);
+
+	if(isStopped)
+	{
+		timer.Stop();
+	}
+	else
+	{
+		timer.m_startTime += clockOffsetSeconds;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void SkipSnapshotTimer(MapSnapshotReader& reader)
+{
+	reader.Skip<decltype(Timer::m_period)>();
+	reader.Skip<decltype(Timer::m_startTime)>();
+	reader.Skip<bool>();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The actor's entry in the table: its definition and the definitions of its weapons
+static void WriteActorDefinitions(std::vector<unsigned char>& bytes, Actor const& actor)
+{
+	WriteSnapshotValue(bytes, actor.m_definition->m_id);
+	WriteSnapshotValue(bytes, static_cast<unsigned char>(actor.m_weaponInventory.size()));
+
+	for(Weapon const* weapon : actor.m_weaponInventory)
+	{
+		WriteSnapshotValue(bytes, weapon->m_weaponDefinition->m_id);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void WriteActorSnapshot(std::vector<unsigned char>& records, Actor const& actor, std::vector<PlayerController*> const& playerControllers)
+{
+	WriteSnapshotValue(records, actor.m_handle);
+	WriteSnapshotValue(records, actor.m_health);
+	WriteSnapshotValue(records, actor.m_position);
+	WriteSnapshotValue(records, actor.m_previousPosition);
+	WriteSnapshotValue(records, actor.m_orientation);
+	WriteSnapshotValue(records, actor.m_acceleration);
+	WriteSnapshotValue(records, actor.m_velocity);
+	WriteSnapshotValue(records, actor.m_isGrounded);
+	WriteSnapshotValue(records, actor.m_state);
+	WriteSnapshotValue(records, actor.m_defaultState);
+	WriteSnapshotValue(records, actor.m_color);
+	WriteSnapshotValue(records, actor.m_light);
+	WriteSnapshotTimer(records, actor.m_corpseTimer);
+	WriteSnapshotTimer(records, actor.m_lifetimeTimer);
+	WriteSnapshotTimer(records, actor.m_animationTimer);
+
+	unsigned char possessedBy = SNAPSHOT_POSSESSED_BY_NONE;
+	unsigned char playerIndex = 0;
+
+	if(actor.m_possessedController && actor.m_possessedController == actor.m_aiController)
+	{
+		possessedBy = SNAPSHOT_POSSESSED_BY_AI;
+	}
+	else if(actor.m_possessedController)
+	{
+		for(size_t controllerIndex = 0; controllerIndex < playerControllers.size(); ++controllerIndex)
+		{
+			if(playerControllers[controllerIndex] == actor.m_possessedController)
+			{
+				possessedBy = SNAPSHOT_POSSESSED_BY_PLAYER;
+				playerIndex = static_cast<unsigned char>(controllerIndex);
+				break;
+			}
+		}
+	}
+
+	WriteSnapshotValue(records, possessedBy);
+	WriteSnapshotValue(records, playerIndex);
+	WriteSnapshotValue(records, actor.m_aiController != nullptr);
+
+	if(actor.m_aiController)
+	{
+		WriteSnapshotValue(records, actor.m_aiController->m_targetActorHandle);
+		WriteSnapshotValue(records, actor.m_aiController->m_nextThinkFrame);
+		WriteSnapshotValue(records, actor.m_aiController->m_hasSteeringPlan);
+		WriteSnapshotValue(records, actor.m_aiController->m_planToAttack);
+		WriteSnapshotValue(records, actor.m_aiController->m_planYawDegrees);
+	}
+
+	signed char currentWeaponIndex = -1;
+
+	for(size_t weaponIndex = 0; weaponIndex < actor.m_weaponInventory.size(); ++weaponIndex)
+	{
+		Weapon const* weapon = actor.m_weaponInventory[weaponIndex];
+
+		if(weapon == actor.m_currentWeapon)
+		{
+			currentWeaponIndex = static_cast<signed char>(weaponIndex);
+		}
+
+		WriteSnapshotValue(records, static_cast<int>(weapon->m_state));
+		WriteSnapshotTimer(records, weapon->m_refireTimer);
+		WriteSnapshotTimer(records, weapon->m_animationTimer);
+	}
+
+	WriteSnapshotValue(records, currentWeaponIndex);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The actor already has the definition the table asks for. Render and audio state is reset the way Actor::Respawn resets
+// it, so the next frame picks the animation and sounds back up from the restored state.
+static void ReadActorSnapshot(MapSnapshotReader& table, MapSnapshotReader& records, Actor& actor, std::vector<PlayerController*> const& playerControllers, double clockOffsetSeconds)
+{
+	records.Read(actor.m_handle);
+	records.Read(actor.m_health);
+	records.Read(actor.m_position);
+	records.Read(actor.m_previousPosition);
+	records.Read(actor.m_orientation);
+	records.Read(actor.m_acceleration);
+	records.Read(actor.m_velocity);
+	records.Read(actor.m_isGrounded);
+	records.Read(actor.m_state);
+	records.Read(actor.m_defaultState);
+	records.Read(actor.m_color);
+	records.Read(actor.m_light);
+	ReadSnapshotTimer(records, actor.m_corpseTimer, clockOffsetSeconds);
+	ReadSnapshotTimer(records, actor.m_lifetimeTimer, clockOffsetSeconds);
+	ReadSnapshotTimer(records, actor.m_animationTimer, clockOffsetSeconds);
+
+	actor.m_renderPosition			= actor.m_position;
+	actor.m_actorAnimation			= nullptr;
+	actor.m_scaleAnimationBySpeed	= false;
+	actor.m_currentAudioID			= static_cast<SoundPlaybackID>(-1);
+
+	unsigned char possessedBy		= SNAPSHOT_POSSESSED_BY_NONE;
+	unsigned char playerIndex		= 0;
+	bool		  hasAIController	= false;
+
+	records.Read(possessedBy);
+	records.Read(playerIndex);
+	records.Read(hasAIController);
+
+	// bots get their controller after spawning, so a recycled marine may have one the snapshot does not, or the reverse
+	if(hasAIController && !actor.m_aiController)
+	{
+		actor.m_aiController = new AIController(actor.m_map);
+	}
+	else if(!hasAIController && actor.m_aiController)
+	{
+		delete actor.m_aiController;
+		actor.m_aiController = nullptr;
+	}
+
+	if(actor.m_aiController)
+	{
+		// set directly rather than through Possess, which would unpossess whatever the old handle resolves to now
+		actor.m_aiController->m_map			= actor.m_map;
+		actor.m_aiController->m_actorHandle = actor.m_handle;
+
+		records.Read(actor.m_aiController->m_targetActorHandle);
+		records.Read(actor.m_aiController->m_nextThinkFrame);
+		records.Read(actor.m_aiController->m_hasSteeringPlan);
+		records.Read(actor.m_aiController->m_planToAttack);
+		records.Read(actor.m_aiController->m_planYawDegrees);
+	}
+
+	actor.m_possessedController = nullptr;
+
+	if(possessedBy == SNAPSHOT_POSSESSED_BY_AI)
+	{
+		actor.m_possessedController = actor.m_aiController;
+	}
+	else if(possessedBy == SNAPSHOT_POSSESSED_BY_PLAYER && playerIndex < playerControllers.size())
+	{
+		actor.m_possessedController = playerControllers[playerIndex];
+	}
+
+	// inventories normally come straight from the definition, so this only allocates when one has grown or shrunk
+	unsigned char numWeapons = 0;
+	table.Read(numWeapons);
+
+	while(actor.m_weaponInventory.size() > numWeapons)
+	{
+		delete actor.m_weaponInventory.back();
+		actor.m_weaponInventory.pop_back();
+	}
+
+	for(unsigned char weaponIndex = 0; weaponIndex < numWeapons; ++weaponIndex)
+	{
+		int weaponDefID = 0;
+		table.Read(weaponDefID);
+
+		WeaponDefinition* weaponDef = &WeaponDefinition::s_weaponDefinitions[weaponDefID];
+
+		if(weaponIndex >= actor.m_weaponInventory.size())
+		{
+			actor.m_weaponInventory.push_back(new Weapon(weaponDef, &actor));
+		}
+
+		Weapon* weapon = actor.m_weaponInventory[weaponIndex];
+		weapon->m_weaponDefinition	= weaponDef;
+		weapon->m_owner				= &actor;
+		weapon->m_currentAudioID	= static_cast<SoundPlaybackID>(-1);
+
+		int weaponState = IDLE;
+		records.Read(weaponState);
+		weapon->m_state = static_cast<WeaponState>(weaponState);
+
+		ReadSnapshotTimer(records, weapon->m_refireTimer, clockOffsetSeconds);
+		ReadSnapshotTimer(records, weapon->m_animationTimer, clockOffsetSeconds);
+	}
+
+	signed char currentWeaponIndex = -1;
+	records.Read(currentWeaponIndex);
+
+	actor.m_currentWeapon = (currentWeaponIndex >= 0 && currentWeaponIndex < static_cast<int>(actor.m_weaponInventory.size())) ? actor.m_weaponInventory[currentWeaponIndex] : nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Walks one actor's record the way ReadActorSnapshot reads it, without touching an actor
+static void SkipActorSnapshot(MapSnapshotReader& records, unsigned char numWeapons)
+{
+	records.Skip<decltype(Actor::m_handle)>();
+	records.Skip<decltype(Actor::m_health)>();
+	records.Skip<decltype(Actor::m_position)>();
+	records.Skip<decltype(Actor::m_previousPosition)>();
+	records.Skip<decltype(Actor::m_orientation)>();
+	records.Skip<decltype(Actor::m_acceleration)>();
+	records.Skip<decltype(Actor::m_velocity)>();
+	records.Skip<decltype(Actor::m_isGrounded)>();
+	records.Skip<decltype(Actor::m_state)>();
+	records.Skip<decltype(Actor::m_defaultState)>();
+	records.Skip<decltype(Actor::m_color)>();
+	records.Skip<decltype(Actor::m_light)>();
+	SkipSnapshotTimer(records);
+	SkipSnapshotTimer(records);
+	SkipSnapshotTimer(records);
+
+	bool hasAIController = false;
+
+	records.Skip<unsigned char>(2); // possessed by, player index
+	records.Read(hasAIController);
+
+	if(hasAIController)
+	{
+		records.Skip<decltype(AIController::m_targetActorHandle)>();
+		records.Skip<decltype(AIController::m_nextThinkFrame)>();
+		records.Skip<decltype(AIController::m_hasSteeringPlan)>();
+		records.Skip<decltype(AIController::m_planToAttack)>();
+		records.Skip<decltype(AIController::m_planYawDegrees)>();
+	}
+
+	for(unsigned char weaponIndex = 0; weaponIndex < numWeapons; ++weaponIndex)
+	{
+		records.Skip<int>();
+		SkipSnapshotTimer(records);
+		SkipSnapshotTimer(records);
+	}
+
+	records.Skip<signed char>();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Walks everything Map::SaveSnapshot writes after the table, the way RestoreSnapshot reads it, and checks it ends exactly
+// at the end of the bytes. tableStart is where the per slot entries of the table begin.
+bool Map::IsSnapshotRecordSizeValid(std::vector<unsigned char> const& bytes, size_t tableStart, size_t recordsStart, unsigned int numSlots, unsigned int numSpawnPoints,
+									 unsigned int numPlayers, unsigned int numMapLights) const
+{
+	MapSnapshotReader table(bytes);
+	MapSnapshotReader records(bytes);
+	table.m_offset	 = tableStart;
+	records.m_offset = recordsStart;
+
+	unsigned int numActors = 0;
+
+	for(unsigned int slot = 0; slot < numSlots; ++slot)
+	{
+		int actorDefID = INVALID_ACTOR_DEFINITION_ID;
+		table.Read(actorDefID);
+
+		if(actorDefID == INVALID_ACTOR_DEFINITION_ID)
+		{
+			continue;
+		}
+
+		unsigned char numWeapons = 0;
+		table.Read(numWeapons);
+		table.Skip<int>(numWeapons);
+
+		SkipActorSnapshot(records, numWeapons);
+		++numActors;
+	}
+
+	// owners, spawn points, free slots and uid
+	records.Skip<ActorHandle>(numActors);
+	records.Skip<ActorHandle>(numSpawnPoints);
+	records.Skip<Vec3>(numSpawnPoints);
+	records.Skip<EulerAngles>(numSpawnPoints);
+	records.SkipArray<decltype(m_freeActorSlots)::value_type>();
+	records.Skip<decltype(m_currentUID)>();
+
+	for(unsigned int playerIndex = 0; playerIndex < numPlayers; ++playerIndex)
+	{
+		records.Skip<decltype(PlayerController::m_actorHandle)>();
+		records.Skip<decltype(PlayerController::m_position)>();
+		records.Skip<decltype(PlayerController::m_orientationDegrees)>();
+		records.Skip<decltype(PlayerController::m_kills)>();
+		records.Skip<decltype(PlayerController::m_deaths)>();
+	}
+
+	// day clock and lights
+	SkipSnapshotTimer(records);
+	SkipSnapshotTimer(records);
+	records.Skip<decltype(m_numDaysPassed)>();
+	records.Skip<decltype(m_hours)>();
+	records.Skip<decltype(m_sunIntensity)>();
+	records.Skip<decltype(m_ambientIntensity)>();
+	records.Skip<decltype(m_sunDirectionYaw)>();
+	records.Skip<decltype(m_sunDirectionPitch)>();
+	records.Skip<decltype(m_sunDirection)>();
+	records.Skip<decltype(m_directionalLight)>();
+	records.Skip<Light>(numMapLights);
+
+	// capture zones
+	records.Skip<decltype(m_isGreenCaptured)>();
+	records.Skip<decltype(m_isRedCaptured)>();
+	records.Skip<decltype(m_isBlueCaptured)>();
+	records.Skip<decltype(m_isYellowCaptured)>();
+	records.Skip<decltype(m_isCourtyardCaptured)>();
+	records.Skip<decltype(m_canCaptureObjective)>();
+	records.Skip<decltype(m_numPlayersOnGreen)>();
+	records.Skip<decltype(m_numPlayersOnBlue)>();
+	records.Skip<decltype(m_numPlayersOnRed)>();
+	records.Skip<decltype(m_numPlayersOnYellow)>();
+	records.Skip<decltype(m_numPlayersOnCourtyard)>();
+	records.Skip<decltype(m_greenCapturePercent)>();
+	records.Skip<decltype(m_blueCapturePercent)>();
+	records.Skip<decltype(m_redCapturePercent)>();
+	records.Skip<decltype(m_yellowCapturePercent)>();
+	records.Skip<decltype(m_courtyardCapturePercent)>();
+	records.Skip<decltype(m_numZonesCaptured)>();
+
+	// fixed step and AI round robin
+	records.Skip<decltype(m_physicsAccumulatorSeconds)>();
+	records.Skip<int>();
+	records.Skip<unsigned int>();
+
+	return table.m_isValid && records.m_isValid && records.m_offset == bytes.size();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The bytes start with a table of counts and definition ids, so RestoreSnapshot can check the whole snapshot fits this
+// map before it changes anything, followed by the state itself. Owners are written after every actor so they can be
+// resolved by handle once all the slots are filled again.
+void Map::SaveSnapshot(MapSnapshot& out_snapshot) const
+{
+	std::vector<unsigned char>& bytes = out_snapshot.m_bytes;
+	bytes.clear();
+
+	out_snapshot.m_mapName	   = m_mapDef->m_name;
+	out_snapshot.m_gameSeconds = m_game->m_gameClock->GetTotalSeconds();
+
+	std::vector<PlayerController*> const& playerControllers = m_game->m_playerControllers;
+
+	WriteSnapshotValue(bytes, static_cast<unsigned int>(m_allActors.size()));
+	WriteSnapshotValue(bytes, static_cast<unsigned int>(m_allSpawnPoints.size()));
+	WriteSnapshotValue(bytes, static_cast<unsigned int>(playerControllers.size()));
+	WriteSnapshotValue(bytes, static_cast<unsigned int>(m_mapLights.size()));
+
+	for(Actor const* actor : m_allActors)
+	{
+		if(actor)
+		{
+			WriteActorDefinitions(bytes, *actor);
+		}
+		else
+		{
+			WriteSnapshotValue(bytes, INVALID_ACTOR_DEFINITION_ID);
+		}
+	}
+
+	for(Actor const* spawnPoint : m_allSpawnPoints)
+	{
+		WriteSnapshotValue(bytes, spawnPoint->m_definition->m_id);
+	}
+
+	// actors
+	for(Actor const* actor : m_allActors)
+	{
+		if(actor)
+		{
+			WriteActorSnapshot(bytes, *actor, playerControllers);
+		}
+	}
+
+	for(Actor const* actor : m_allActors)
+	{
+		if(actor)
+		{
+			WriteSnapshotValue(bytes, actor->m_owner ? actor->m_owner->m_handle : ActorHandle::INVALID);
+		}
+	}
+
+	for(Actor const* spawnPoint : m_allSpawnPoints)
+	{
+		WriteSnapshotValue(bytes, spawnPoint->m_handle);
+		WriteSnapshotValue(bytes, spawnPoint->m_position);
+		WriteSnapshotValue(bytes, spawnPoint->m_orientation);
+	}
+
+	WriteSnapshotArray(bytes, m_freeActorSlots);
+	WriteSnapshotValue(bytes, m_currentUID);
+
+	for(PlayerController const* playerController : playerControllers)
+	{
+		WriteSnapshotValue(bytes, playerController->m_actorHandle);
+		WriteSnapshotValue(bytes, playerController->m_position);
+		WriteSnapshotValue(bytes, playerController->m_orientationDegrees);
+		WriteSnapshotValue(bytes, playerController->m_kills);
+		WriteSnapshotValue(bytes, playerController->m_deaths);
+	}
+
+	// day clock and lights
+	WriteSnapshotTimer(bytes, m_sunTimer);
+	WriteSnapshotTimer(bytes, m_sunYawTimer);
+	WriteSnapshotValue(bytes, m_numDaysPassed);
+	WriteSnapshotValue(bytes, m_hours);
+	WriteSnapshotValue(bytes, m_sunIntensity);
+	WriteSnapshotValue(bytes, m_ambientIntensity);
+	WriteSnapshotValue(bytes, m_sunDirectionYaw);
+	WriteSnapshotValue(bytes, m_sunDirectionPitch);
+	WriteSnapshotValue(bytes, m_sunDirection);
+	WriteSnapshotValue(bytes, m_directionalLight);
+
+	for(Light const& light : m_mapLights)
+	{
+		WriteSnapshotValue(bytes, light);
+	}
+
+	// capture zones
+	WriteSnapshotValue(bytes, m_isGreenCaptured);
+	WriteSnapshotValue(bytes, m_isRedCaptured);
+	WriteSnapshotValue(bytes, m_isBlueCaptured);
+	WriteSnapshotValue(bytes, m_isYellowCaptured);
+	WriteSnapshotValue(bytes, m_isCourtyardCaptured);
+	WriteSnapshotValue(bytes, m_canCaptureObjective);
+	WriteSnapshotValue(bytes, m_numPlayersOnGreen);
+	WriteSnapshotValue(bytes, m_numPlayersOnBlue);
+	WriteSnapshotValue(bytes, m_numPlayersOnRed);
+	WriteSnapshotValue(bytes, m_numPlayersOnYellow);
+	WriteSnapshotValue(bytes, m_numPlayersOnCourtyard);
+	WriteSnapshotValue(bytes, m_greenCapturePercent);
+	WriteSnapshotValue(bytes, m_blueCapturePercent);
+	WriteSnapshotValue(bytes, m_redCapturePercent);
+	WriteSnapshotValue(bytes, m_yellowCapturePercent);
+	WriteSnapshotValue(bytes, m_courtyardCapturePercent);
+	WriteSnapshotValue(bytes, m_numZonesCaptured);
+
+	// fixed step and AI round robin, so the frames after a restore tick and think exactly as they did after the save
+	WriteSnapshotValue(bytes, m_physicsAccumulatorSeconds);
+	WriteSnapshotValue(bytes, m_aiScheduler.GetFrameIndex());
+	WriteSnapshotValue(bytes, static_cast<unsigned int>(m_aiScheduler.GetNextActorSlot()));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Returns false without touching the map if the snapshot is for another map, another number of players, names
+// definitions this game does not have, or its state is not exactly the size the table says. Every live actor goes back to its definition's pool and the slots are refilled
+// from the pools, so a restore only allocates when the snapshot holds more actors of a definition than the map does now.
+bool Map::RestoreSnapshot(MapSnapshot const& snapshot)
+{
+	if(snapshot.IsEmpty() || snapshot.m_mapName != m_mapDef->m_name)
+	{
+		return false;
+	}
+
+	std::vector<PlayerController*> const& playerControllers = m_game->m_playerControllers;
+
+	int numActorDefs  = static_cast<int>(ActorDefinition::s_actorDefinitions.size());
+	int numWeaponDefs = static_cast<int>(WeaponDefinition::s_weaponDefinitions.size());
+
+	MapSnapshotReader table(snapshot.m_bytes);
+
+	unsigned int numSlots		= 0;
+	unsigned int numSpawnPoints = 0;
+	unsigned int numPlayers		= 0;
+	unsigned int numMapLights	= 0;
+
+	table.Read(numSlots);
+	table.Read(numSpawnPoints);
+	table.Read(numPlayers);
+	table.Read(numMapLights);
+
+	if(!table.m_isValid || numSlots > ActorHandle::MAX_ACTOR_INDEX || numPlayers != playerControllers.size() || numMapLights != m_mapLights.size())
+	{
+		return false;
+	}
+
+	size_t tableStart = table.m_offset;
+
+	for(unsigned int slot = 0; slot < numSlots && table.m_isValid; ++slot)
+	{
+		int actorDefID = INVALID_ACTOR_DEFINITION_ID;
+		table.Read(actorDefID);
+
+		if(actorDefID == INVALID_ACTOR_DEFINITION_ID)
+		{
+			continue;
+		}
+
+		if(actorDefID < 0 || actorDefID >= numActorDefs || ActorDefinition::s_actorDefinitions[actorDefID].IsSpawnPoint())
+		{
+			return false;
+		}
+
+		unsigned char numWeapons = 0;
+		table.Read(numWeapons);
+
+		for(unsigned char weaponIndex = 0; weaponIndex < numWeapons; ++weaponIndex)
+		{
+			int weaponDefID = -1;
+			table.Read(weaponDefID);
+
+			if(weaponDefID < 0 || weaponDefID >= numWeaponDefs)
+			{
+				return false;
+			}
+		}
+	}
+
+	for(unsigned int spawnPointIndex = 0; spawnPointIndex < numSpawnPoints; ++spawnPointIndex)
+	{
+		int actorDefID = INVALID_ACTOR_DEFINITION_ID;
+		table.Read(actorDefID);
+
+		if(actorDefID < 0 || actorDefID >= numActorDefs || !ActorDefinition::s_actorDefinitions[actorDefID].IsSpawnPoint())
+		{
+			return false;
+		}
+	}
+
+	// every read below then stays in bounds, so a corrupt snapshot can never leave the map half restored
+	if(!table.m_isValid || !IsSnapshotRecordSizeValid(snapshot.m_bytes, tableStart, table.m_offset, numSlots, numSpawnPoints, numPlayers, numMapLights))
+	{
+		return false;
+	}
+
+	MapSnapshotReader records(snapshot.m_bytes);
+	records.m_offset = table.m_offset;
+	table.m_offset	 = tableStart;
+
+	double clockOffsetSeconds = m_game->m_gameClock->GetTotalSeconds() - snapshot.m_gameSeconds;
+
+	// actors
+	for(Actor* actor : m_allActors)
+	{
+		if(actor)
+		{
+			m_actorPools[actor->m_definition->m_id].m_freeActors.push_back(actor);
+		}
+	}
+
+	m_allActors.assign(numSlots, nullptr);
+
+	for(unsigned int slot = 0; slot < numSlots; ++slot)
+	{
+		int actorDefID = INVALID_ACTOR_DEFINITION_ID;
+		table.Read(actorDefID);
+
+		if(actorDefID == INVALID_ACTOR_DEFINITION_ID)
+		{
+			continue;
+		}
+
+		ActorList& freeActors = m_actorPools[actorDefID].m_freeActors;
+		Actor* actor = nullptr;
+
+		if(!freeActors.empty())
+		{
+			actor = freeActors.back();
+			freeActors.pop_back();
+		}
+		else
+		{
+			actor = new Actor(this, &ActorDefinition::s_actorDefinitions[actorDefID]);
+		}
+
+		ReadActorSnapshot(table, records, *actor, playerControllers, clockOffsetSeconds);
+		m_allActors[slot] = actor;
+	}
+
+	// definitions without a pool in the map def only ever had actors parked here by the loop above
+	for(ActorPool& actorPool : m_actorPools)
+	{
+		if(!actorPool.m_isEnabled)
+		{
+			for(Actor* unusedActor : actorPool.m_freeActors)
+			{
+				delete unusedActor;
+			}
+
+			actorPool.m_freeActors.clear();
+		}
+	}
+
+	for(Actor* actor : m_allActors)
+	{
+		if(actor)
+		{
+			ActorHandle ownerHandle = ActorHandle::INVALID;
+			records.Read(ownerHandle);
+
+			actor->m_owner = GetActorByHandle(ownerHandle);
+		}
+	}
+
+	// spawn points, which every sunrise adds more of
+	while(m_allSpawnPoints.size() > numSpawnPoints)
+	{
+		delete m_allSpawnPoints.back();
+		m_allSpawnPoints.pop_back();
+	}
+
+	for(unsigned int spawnPointIndex = 0; spawnPointIndex < numSpawnPoints; ++spawnPointIndex)
+	{
+		int			actorDefID = INVALID_ACTOR_DEFINITION_ID;
+		ActorHandle handle	   = ActorHandle::INVALID;
+		Vec3		position;
+		EulerAngles orientation;
+
+		table.Read(actorDefID);
+		records.Read(handle);
+		records.Read(position);
+		records.Read(orientation);
+
+		ActorDefinition* actorDef = &ActorDefinition::s_actorDefinitions[actorDefID];
+
+		if(spawnPointIndex >= m_allSpawnPoints.size())
+		{
+			m_allSpawnPoints.push_back(new Actor(this, actorDef, position, orientation, handle));
+			continue;
+		}
+
+		Actor* spawnPoint = m_allSpawnPoints[spawnPointIndex];
+		spawnPoint->m_definition	= actorDef;
+		spawnPoint->m_handle		= handle;
+		spawnPoint->m_position		= position;
+		spawnPoint->m_orientation	= orientation;
+	}
+
+	records.ReadArray(m_freeActorSlots);
+	records.Read(m_currentUID);
+
+	for(PlayerController* playerController : playerControllers)
+	{
+		records.Read(playerController->m_actorHandle);
+		records.Read(playerController->m_position);
+		records.Read(playerController->m_orientationDegrees);
+		records.Read(playerController->m_kills);
+		records.Read(playerController->m_deaths);
+	}
+
+	// day clock and lights
+	ReadSnapshotTimer(records, m_sunTimer, clockOffsetSeconds);
+	ReadSnapshotTimer(records, m_sunYawTimer, clockOffsetSeconds);
+	records.Read(m_numDaysPassed);
+	records.Read(m_hours);
+	records.Read(m_sunIntensity);
+	records.Read(m_ambientIntensity);
+	records.Read(m_sunDirectionYaw);
+	records.Read(m_sunDirectionPitch);
+	records.Read(m_sunDirection);
+	records.Read(m_directionalLight);
+
+	for(Light& light : m_mapLights)
+	{
+		records.Read(light);
+	}
+
+	// capture zones
+	records.Read(m_isGreenCaptured);
+	records.Read(m_isRedCaptured);
+	records.Read(m_isBlueCaptured);
+	records.Read(m_isYellowCaptured);
+	records.Read(m_isCourtyardCaptured);
+	records.Read(m_canCaptureObjective);
+	records.Read(m_numPlayersOnGreen);
+	records.Read(m_numPlayersOnBlue);
+	records.Read(m_numPlayersOnRed);
+	records.Read(m_numPlayersOnYellow);
+	records.Read(m_numPlayersOnCourtyard);
+	records.Read(m_greenCapturePercent);
+	records.Read(m_blueCapturePercent);
+	records.Read(m_redCapturePercent);
+	records.Read(m_yellowCapturePercent);
+	records.Read(m_courtyardCapturePercent);
+	records.Read(m_numZonesCaptured);
+
+	int			 aiFrameIndex	  = 0;
+	unsigned int aiNextActorSlot  = 0;
+
+	records.Read(m_physicsAccumulatorSeconds);
+	records.Read(aiFrameIndex);
+	records.Read(aiNextActorSlot);
+	m_aiScheduler.SetSchedule(aiFrameIndex, aiNextActorSlot);
+
+	// nothing queued before the restore may land on the restored actors, and the broadphase has to see where they are now
+	m_commandBuffer.Clear();
+	m_allLights.clear();
+	RebuildActorGrid();
+	m_actorColliders.Refresh(m_allActors);
+
+	return records.m_isValid && table.m_isValid;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// SaveSnapshot [file=<path>]: keeps the current map state for LoadSnapshot, and also writes it to the file if given
+bool Map::Event_SaveSnapshot(EventArgs& args)
+{
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, "SaveSnapshot: no map is loaded");
+		return false;
+	}
+
+	double startTime = GetCurrentTimeSeconds();
+	map->SaveSnapshot(map->m_savedSnapshot);
+	double milliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+	std::string filePath = args.GetValue("file", "");
+
+	if(!filePath.empty() && !map->m_savedSnapshot.SaveToFile(filePath))
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, Stringf("SaveSnapshot: could not write %s", filePath.c_str()));
+		return false;
+	}
+
+	g_devConsole->AddLine(DevConsole::INFO_MAJOR, Stringf("SaveSnapshot: %d bytes in %.3f ms%s%s", static_cast<int>(map->m_savedSnapshot.GetNumBytes()), milliseconds, filePath.empty() ? "" : ", written to ", filePath.c_str()));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// LoadSnapshot [file=<path>]: puts the map back to the last SaveSnapshot, or to the one in the file if given
+bool Map::Event_LoadSnapshot(EventArgs& args)
+{
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, "LoadSnapshot: no map is loaded");
+		return false;
+	}
+
+	std::string filePath = args.GetValue("file", "");
+
+	if(!filePath.empty() && !map->m_savedSnapshot.LoadFromFile(filePath))
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, Stringf("LoadSnapshot: could not read %s", filePath.c_str()));
+		return false;
+	}
+
+	if(map->m_savedSnapshot.IsEmpty())
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, "LoadSnapshot: nothing saved yet, use SaveSnapshot first");
+		return false;
+	}
+
+	double startTime = GetCurrentTimeSeconds();
+	bool didRestore = map->RestoreSnapshot(map->m_savedSnapshot);
+	double milliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+	if(!didRestore)
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, Stringf("LoadSnapshot: snapshot of %s does not fit the current map", map->m_savedSnapshot.m_mapName.c_str()));
+		return false;
+	}
+
+	g_devConsole->AddLine(DevConsole::INFO_MAJOR, Stringf("LoadSnapshot: restored %d bytes in %.3f ms", static_cast<int>(map->m_savedSnapshot.GetNumBytes()), milliseconds));
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// RestartLevel: puts the map back to the state it was created in
+bool Map::Event_RestartLevel(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_game->m_currentMap;
+
+	if(!map)
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, "RestartLevel: no map is loaded");
+		return false;
+	}
+
+	if(!map->RestoreSnapshot(map->m_levelStartSnapshot))
+	{
+		g_devConsole->AddLine(DevConsole::ERROR, "RestartLevel: the players have changed since the level started");
+	}
+
+	return false;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// A Map's whole simulation state packed into one flat block of bytes: every actor slot with its timers, weapons and AI,
+// the spawn points, the free slot list and uid counter the handles depend on, which actor each player controls, the
+// capture zones, the day/hour clock and the lights. Map::SaveSnapshot fills it and Map::RestoreSnapshot puts it back in
+// place, reusing the map's actor objects and pools instead of re-reading the map's image or definitions.
+// Timers are stored against m_gameSeconds and shifted by however far the game clock has moved by the time the snapshot
+// is restored, so every timer keeps the time it had left. Restoring at the same clock total gives back the same bits.
+// Saving again into the same snapshot reuses its buffer, so snapshots taken every frame do not touch the heap.
+class MapSnapshot
+{
+public:
+
+	bool				LoadFromFile(std::string const& filePath);
+	bool				SaveToFile(std::string const& filePath) const;
+
+	void				Clear();
+	bool				IsEmpty() const;
+	size_t				GetNumBytes() const;
+
+public:
+
+	std::string					m_mapName;
+	double						m_gameSeconds = 0.0;	// game clock total when the snapshot was taken
+	std::vector<unsigned char>	m_bytes;
+};
@@ -11,6 +11,9 @@
 
 extern Game* g_game;
 
+constexpr int	NUM_WEAPON_HOTKEYS	= 6;
+constexpr float	TURN_SENSITIVITY	= 0.125f;
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 PlayerController::PlayerController(int controllerID)
 	: Controller(nullptr)
@@ -28,6 +31,11 @@ PlayerController::~PlayerController()
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void PlayerController::Update()
 {
+	if(!m_isInputInjected)
+	{
+		m_input = SampleInput();
+	}
+
 	if(g_game->GetGameState() == GameState::PLAYING)
 	{
 		UpdateKeyboardInput();
@@ -38,12 +46,12 @@ void PlayerController::Update()
 
 	if(m_map->m_game->GetNumPlayerControllers() == 1)
 	{
-		if(g_inputSystem->WasKeyJustPressed('F'))
+		if(m_input.IsButtonDown(PLAYER_INPUT_TOGGLE_CONTROL_MODE))
 		{
 			ToggleControlMode();
 		}
 
-		if(g_inputSystem->WasKeyJustPressed('N'))
+		if(m_input.IsButtonDown(PLAYER_INPUT_POSSESS_NEXT))
 		{
 			m_map->DebugPossessNext();
 		}
@@ -126,6 +134,14 @@ void PlayerController::ToggleControlMode()
 
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// From now on Update uses the input it is given instead of reading the devices
+void PlayerController::SetInput(PlayerInput const& input)
+{
+	m_input = input;
+	m_isInputInjected = true;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void PlayerController::RenderHUDInfoAndDeathOverlay()
 {
@@ -237,6 +253,146 @@ Vec3 PlayerController::GetForwardNormal() const
 	return orientationMatrix.GetIBasis3D();
 }
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Movement, aim and weapons are only read while the match is being played; the debug keys are read in every state
+PlayerInput PlayerController::SampleInput() const
+{
+	PlayerInput input;
+
+	if(g_game->GetGameState() == GameState::PLAYING && m_controlMode == ControlMode::ACTOR_CONTROL)
+	{
+		input = (m_controllerID == -1) ? SampleKeyboardInput() : SampleXboxInput();
+	}
+
+	if(g_inputSystem->WasKeyJustPressed('F'))
+	{
+		input.m_buttons |= PLAYER_INPUT_TOGGLE_CONTROL_MODE;
+	}
+
+	if(g_inputSystem->WasKeyJustPressed('N'))
+	{
+		input.m_buttons |= PLAYER_INPUT_POSSESS_NEXT;
+	}
+
+	return input;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+PlayerInput PlayerController::SampleKeyboardInput() const
+{
+	PlayerInput input;
+	input.m_buttons = PLAYER_INPUT_CONNECTED;
+
+	input.m_lookDegrees.x = -(g_inputSystem->GetCursorClientDelta().x * TURN_SENSITIVITY);
+	input.m_lookDegrees.y = g_inputSystem->GetCursorClientDelta().y * TURN_SENSITIVITY;
+
+	if(g_inputSystem->IsKeyDown('W'))
+	{
+		input.m_buttons |= PLAYER_INPUT_MOVE_FORWARD;
+	}
+
+	if(g_inputSystem->IsKeyDown('S'))
+	{
+		input.m_buttons |= PLAYER_INPUT_MOVE_BACK;
+	}
+
+	if(g_inputSystem->IsKeyDown('A'))
+	{
+		input.m_buttons |= PLAYER_INPUT_MOVE_LEFT;
+	}
+
+	if(g_inputSystem->IsKeyDown('D'))
+	{
+		input.m_buttons |= PLAYER_INPUT_MOVE_RIGHT;
+	}
+
+	if(g_inputSystem->IsKeyDown(KEYCODE_LSHIFT))
+	{
+		input.m_buttons |= PLAYER_INPUT_SPRINT;
+	}
+
+	if(g_inputSystem->WasKeyJustPressed(' '))
+	{
+		input.m_buttons |= PLAYER_INPUT_JUMP;
+	}
+
+	if(g_inputSystem->IsKeyDown(KEYCODE_LEFT_MOUSE))
+	{
+		input.m_buttons |= PLAYER_INPUT_ATTACK;
+	}
+
+	for(int weaponIndex = 0; weaponIndex < NUM_WEAPON_HOTKEYS; ++weaponIndex)
+	{
+		if(g_inputSystem->WasKeyJustPressed(static_cast<unsigned char>('1' + weaponIndex)))
+		{
+			input.m_equipWeaponMask |= static_cast<unsigned char>(1 << weaponIndex);
+		}
+	}
+
+	if(g_inputSystem->WasKeyJustPressed(KEYCODE_LEFT_ARROW) || g_inputSystem->GetWheelDelta() > 0.f)
+	{
+		input.m_buttons |= PLAYER_INPUT_PREV_WEAPON;
+	}
+
+	if(g_inputSystem->WasKeyJustPressed(KEYCODE_RIGHT_ARROW) || g_inputSystem->GetWheelDelta() < 0.f)
+	{
+		input.m_buttons |= PLAYER_INPUT_NEXT_WEAPON;
+	}
+
+	return input;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+PlayerInput PlayerController::SampleXboxInput() const
+{
+	PlayerInput input;
+
+	XboxController const& xboxController = g_inputSystem->GetController(m_controllerID);
+
+	if(!xboxController.IsConntected())
+	{
+		return input;
+	}
+
+	input.m_buttons = PLAYER_INPUT_CONNECTED;
+
+	input.m_lookDegrees.x = -(xboxController.GetRightStick().GetPosition().x * TURN_SENSITIVITY);
+	input.m_lookDegrees.y = -(xboxController.GetRightStick().GetPosition().y * TURN_SENSITIVITY);
+	input.m_moveAxes	  = xboxController.GetLeftStick().GetPosition();
+
+	if(xboxController.IsButtonDown(XBOX_BUTTON_A) || xboxController.IsButtonDown(XBOX_BUTTON_LTHUMB))
+	{
+		input.m_buttons |= PLAYER_INPUT_SPRINT;
+	}
+
+	if(xboxController.GetRightTrigger() > 0.2f)
+	{
+		input.m_buttons |= PLAYER_INPUT_ATTACK;
+	}
+
+	if(g_inputSystem->WasKeyJustPressed(xboxController.WasButtonJustPressed(XBOX_BUTTON_X)))
+	{
+		input.m_equipWeaponMask |= 1 << 0;
+	}
+
+	if(g_inputSystem->WasKeyJustPressed(xboxController.WasButtonJustPressed(XBOX_BUTTON_Y)))
+	{
+		input.m_equipWeaponMask |= 1 << 1;
+	}
+
+	if(xboxController.WasButtonJustPressed(XBOX_BUTTON_DPAD_LEFT))
+	{
+		input.m_buttons |= PLAYER_INPUT_PREV_WEAPON;
+	}
+
+	if(xboxController.WasButtonJustPressed(XBOX_BUTTON_DPAD_RIGHT))
+	{
+		input.m_buttons |= PLAYER_INPUT_NEXT_WEAPON;
+	}
+
+	return input;
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void PlayerController::UpdateKeyboardInput()
 {
@@ -249,7 +405,7 @@ void PlayerController::UpdateKeyboardInput()
 
 	if(controlledActor && m_controlMode == ControlMode::ACTOR_CONTROL && static_cast<int>(controlledActor->m_state) < static_cast<int>(ActorState::DYING))
 	{
-		m_position = controlledActor->m_position + Vec3::UP * controlledActor->m_definition->m_eyeHeight;
+		m_position = controlledActor->m_renderPosition + Vec3::UP * controlledActor->m_definition->m_eyeHeight;
 		m_orientationDegrees = controlledActor->m_orientation;
 	}
 
@@ -264,10 +420,8 @@ void PlayerController::UpdateKeyboardInput()
 		moveSpeed = g_gameConfigBlackboard.GetValue("playerMoveSpeed", 1.0f);
 	}
 
-	float turnSensitivity = 0.125f;
-
-	m_orientationDegrees.m_yawDegrees += -(g_inputSystem->GetCursorClientDelta().x * turnSensitivity);
-	m_orientationDegrees.m_pitchDegrees += g_inputSystem->GetCursorClientDelta().y * turnSensitivity;
+	m_orientationDegrees.m_yawDegrees += m_input.m_lookDegrees.x;
+	m_orientationDegrees.m_pitchDegrees += m_input.m_lookDegrees.y;
 	m_orientationDegrees.m_pitchDegrees = GetClamped(m_orientationDegrees.m_pitchDegrees, -85.f, 85.f);
 
 	Vec3 fwdVector;
@@ -279,7 +433,7 @@ void PlayerController::UpdateKeyboardInput()
 	bool wasKeyPressed = false;
 	bool didJump = false;
 
-	if(g_inputSystem->IsKeyDown(KEYCODE_LSHIFT))
+	if(m_input.IsButtonDown(PLAYER_INPUT_SPRINT))
 	{
 		if(controlledActor)
 		{
@@ -299,31 +453,31 @@ void PlayerController::UpdateKeyboardInput()
 
 		Vec3 moveDirection = Vec3::ZERO;
 
-		if(g_inputSystem->IsKeyDown('W') && controlledActor->m_isGrounded)
+		if(m_input.IsButtonDown(PLAYER_INPUT_MOVE_FORWARD) && controlledActor->m_isGrounded)
 		{
 			moveDirection += fwdXY;
 			wasKeyPressed = true;
 		}
 
-		if(g_inputSystem->IsKeyDown('S') && controlledActor->m_isGrounded)
+		if(m_input.IsButtonDown(PLAYER_INPUT_MOVE_BACK) && controlledActor->m_isGrounded)
 		{
 			moveDirection -= fwdXY;
 			wasKeyPressed = true;
 		}
 
-		if(g_inputSystem->IsKeyDown('A') && controlledActor->m_isGrounded)
+		if(m_input.IsButtonDown(PLAYER_INPUT_MOVE_LEFT) && controlledActor->m_isGrounded)
 		{
 			moveDirection += leftVector;
 			wasKeyPressed = true;
 		}
 
-		if(g_inputSystem->IsKeyDown('D') && controlledActor->m_isGrounded)
+		if(m_input.IsButtonDown(PLAYER_INPUT_MOVE_RIGHT) && controlledActor->m_isGrounded)
 		{
 			moveDirection -= leftVector;
 			wasKeyPressed = true;
 		}
 
-		if(g_inputSystem->WasKeyJustPressed(' ') && !m_map->m_didLevelJustStart && controlledActor->m_isGrounded)
+		if(m_input.IsButtonDown(PLAYER_INPUT_JUMP) && !m_map->m_didLevelJustStart && controlledActor->m_isGrounded)
 		{
 			controlledActor->AddImpulse(Vec3::UP * controlledActor->m_definition->m_jumpHeight);
 		}
@@ -332,46 +486,25 @@ void PlayerController::UpdateKeyboardInput()
 			controlledActor->MoveInDirection(moveDirection.GetNormalized() * moveSpeed, didJump);
 		}
 
-		if(g_inputSystem->IsKeyDown(KEYCODE_LEFT_MOUSE))
+		if(m_input.IsButtonDown(PLAYER_INPUT_ATTACK))
 		{
 			controlledActor->Attack();
 		}
 
-		if(g_inputSystem->WasKeyJustPressed('1'))
-		{
-			controlledActor->EquipWeapon(0);
-		}
-		if(g_inputSystem->WasKeyJustPressed('2'))
-		{
-			controlledActor->EquipWeapon(1);
-		}
-
-		if(g_inputSystem->WasKeyJustPressed('3'))
-		{
-			controlledActor->EquipWeapon(2);
-		}
-
-		if(g_inputSystem->WasKeyJustPressed('4'))
-		{
-			controlledActor->EquipWeapon(3);
-		}
-
-		if(g_inputSystem->WasKeyJustPressed('5'))
-		{
-			controlledActor->EquipWeapon(4);
-		}
-
-		if(g_inputSystem->WasKeyJustPressed('6'))
+		for(int weaponIndex = 0; weaponIndex < NUM_WEAPON_HOTKEYS; ++weaponIndex)
 		{
-			controlledActor->EquipWeapon(5);
+			if(m_input.m_equipWeaponMask & (1 << weaponIndex))
+			{
+				controlledActor->EquipWeapon(weaponIndex);
+			}
 		}
 
-		if(g_inputSystem->WasKeyJustPressed(KEYCODE_LEFT_ARROW) || g_inputSystem->GetWheelDelta() > 0.f)
+		if(m_input.IsButtonDown(PLAYER_INPUT_PREV_WEAPON))
 		{
 			controlledActor->CyclePrevWeapon();
 		}
 
-		if(g_inputSystem->WasKeyJustPressed(KEYCODE_RIGHT_ARROW) || g_inputSystem->GetWheelDelta() < 0.f)
+		if(m_input.IsButtonDown(PLAYER_INPUT_NEXT_WEAPON))
 		{
 			controlledActor->CycleNextWeapon();
 		}
@@ -386,22 +519,16 @@ void PlayerController::UpdateXboxInput()
 		return;
 	}
 
-	XboxController const& xboxController = g_inputSystem->GetController(m_controllerID);
-
-	if(!xboxController.IsConntected())
+	if(!m_input.IsButtonDown(PLAYER_INPUT_CONNECTED))
 	{
 		return;
 	}
 
-	AnalogJoystick const& rightStick = xboxController.GetRightStick();
-	AnalogJoystick const& leftStick = xboxController.GetLeftStick();
-	float				  rightTrigger = xboxController.GetRightTrigger();
-
 	Actor* controlledActor = m_map->GetActorByHandle(m_actorHandle);
 
 	if(controlledActor && m_controlMode == ControlMode::ACTOR_CONTROL && static_cast<int>(controlledActor->m_state) < static_cast<int>(ActorState::DYING))
 	{
-		m_position = controlledActor->m_position;
+		m_position = controlledActor->m_renderPosition;
 		m_position.z = controlledActor->m_definition->m_eyeHeight;
 		m_orientationDegrees = controlledActor->m_orientation;
 	}
@@ -417,11 +544,8 @@ void PlayerController::UpdateXboxInput()
 		moveSpeed = g_gameConfigBlackboard.GetValue("playerMoveSpeed", 1.0f);
 	}
 
-
-	float turnSensitivity = 0.125f;
-
-	m_orientationDegrees.m_yawDegrees -= (rightStick.GetPosition().x * turnSensitivity);
-	m_orientationDegrees.m_pitchDegrees -= rightStick.GetPosition().y * turnSensitivity;
+	m_orientationDegrees.m_yawDegrees += m_input.m_lookDegrees.x;
+	m_orientationDegrees.m_pitchDegrees += m_input.m_lookDegrees.y;
 	m_orientationDegrees.m_pitchDegrees = GetClamped(m_orientationDegrees.m_pitchDegrees, -85.f, 85.f);
 
 	Vec3 fwdVector;
@@ -430,7 +554,7 @@ void PlayerController::UpdateXboxInput()
 
 	m_orientationDegrees.GetAsVectors_IFwd_JLeft_KUp(fwdVector, leftVector, upVector);
 
-	if(xboxController.IsButtonDown(XBOX_BUTTON_A) || xboxController.IsButtonDown(XBOX_BUTTON_LTHUMB))
+	if(m_input.IsButtonDown(PLAYER_INPUT_SPRINT))
 	{
 		if(controlledActor)
 		{
@@ -448,33 +572,32 @@ void PlayerController::UpdateXboxInput()
 
 		Vec3 fwdXY = Vec3(fwdVector.x, fwdVector.y, 0.f).GetNormalized();
 
-		if(leftStick.GetPosition().GetLengthSquared() > 0.1f * 0.1f)
+		if(m_input.m_moveAxes.GetLengthSquared() > 0.1f * 0.1f)
 		{
-			Vec3 moveDirection = fwdXY * leftStick.GetPosition().y - leftVector * leftStick.GetPosition().x;
+			Vec3 moveDirection = fwdXY * m_input.m_moveAxes.y - leftVector * m_input.m_moveAxes.x;
 			moveDirection.Normalize();
 			controlledActor->MoveInDirection(moveDirection * moveSpeed);
 		}
 
-		if(rightTrigger > 0.2f)
+		if(m_input.IsButtonDown(PLAYER_INPUT_ATTACK))
 		{
 			controlledActor->Attack();
 		}
 
-		if(g_inputSystem->WasKeyJustPressed(xboxController.WasButtonJustPressed(XBOX_BUTTON_X)))
-		{
-			controlledActor->EquipWeapon(0);
-		}
-		if(g_inputSystem->WasKeyJustPressed(xboxController.WasButtonJustPressed(XBOX_BUTTON_Y)))
+		for(int weaponIndex = 0; weaponIndex < NUM_WEAPON_HOTKEYS; ++weaponIndex)
 		{
-			controlledActor->EquipWeapon(1);
+			if(m_input.m_equipWeaponMask & (1 << weaponIndex))
+			{
+				controlledActor->EquipWeapon(weaponIndex);
+			}
 		}
 
-		if(xboxController.WasButtonJustPressed(XBOX_BUTTON_DPAD_LEFT))
+		if(m_input.IsButtonDown(PLAYER_INPUT_PREV_WEAPON))
 		{
 			controlledActor->CyclePrevWeapon();
 		}
 
-		if(xboxController.WasButtonJustPressed(XBOX_BUTTON_DPAD_RIGHT))
+		if(m_input.IsButtonDown(PLAYER_INPUT_NEXT_WEAPON))
 		{
 			controlledActor->CycleNextWeapon();
 		}
@@ -482,9 +605,10 @@ void PlayerController::UpdateXboxInput()
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Only moves the camera, on the system clock, so it reads the devices directly and replays leave it out
 void PlayerController::HandleFreeFlyInput()
 {
-	if(m_controlMode != ControlMode::FREEFLY)
+	if(m_controlMode != ControlMode::FREEFLY || m_isInputInjected)
 	{
 		return;
 	}
@@ -506,12 +630,10 @@ void PlayerController::HandleFreeFlyInput()
 		moveSpeed = g_gameConfigBlackboard.GetValue("playerMoveSpeed", 1.0f);
 	}
 
-	float turnSensitivity = 0.125f;
-
-	m_orientationDegrees.m_yawDegrees += -(g_inputSystem->GetCursorClientDelta().x * turnSensitivity);
-	m_orientationDegrees.m_pitchDegrees += g_inputSystem->GetCursorClientDelta().y * turnSensitivity;
-	m_orientationDegrees.m_yawDegrees -= (rightStick.GetPosition().x * turnSensitivity);
-	m_orientationDegrees.m_pitchDegrees -= rightStick.GetPosition().y * turnSensitivity;
+	m_orientationDegrees.m_yawDegrees += -(g_inputSystem->GetCursorClientDelta().x * TURN_SENSITIVITY);
+	m_orientationDegrees.m_pitchDegrees += g_inputSystem->GetCursorClientDelta().y * TURN_SENSITIVITY;
+	m_orientationDegrees.m_yawDegrees -= (rightStick.GetPosition().x * TURN_SENSITIVITY);
+	m_orientationDegrees.m_pitchDegrees -= rightStick.GetPosition().y * TURN_SENSITIVITY;
 
 	m_orientationDegrees.m_pitchDegrees = GetClamped(m_orientationDegrees.m_pitchDegrees, -85.f, 85.f);
 
@@ -577,3 +699,9 @@ void PlayerController::HandleFreeFlyInput()
 	}
 
 }
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool PlayerInput::IsButtonDown(unsigned short button) const
+{
+	return (m_buttons & button) != 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Renderer/Camera.hpp"
+#include "Engine/Math/Vec2.hpp"
 #include "Game/Controller.hpp"
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 struct ActorHandle;
@@ -17,6 +18,36 @@ enum class ControlMode
 
 	COUNT
 };
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+enum PlayerInputButton : unsigned short
+{
+	PLAYER_INPUT_CONNECTED				= 1 << 0,	// always set for keyboard and mouse
+	PLAYER_INPUT_MOVE_FORWARD			= 1 << 1,
+	PLAYER_INPUT_MOVE_BACK				= 1 << 2,
+	PLAYER_INPUT_MOVE_LEFT				= 1 << 3,
+	PLAYER_INPUT_MOVE_RIGHT				= 1 << 4,
+	PLAYER_INPUT_SPRINT					= 1 << 5,
+	PLAYER_INPUT_JUMP					= 1 << 6,
+	PLAYER_INPUT_ATTACK					= 1 << 7,
+	PLAYER_INPUT_PREV_WEAPON			= 1 << 8,
+	PLAYER_INPUT_NEXT_WEAPON			= 1 << 9,
+	PLAYER_INPUT_TOGGLE_CONTROL_MODE	= 1 << 10,
+	PLAYER_INPUT_POSSESS_NEXT			= 1 << 11,
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// What one player's keyboard and mouse or Xbox controller asked for in one frame, reduced to what the simulation
+// uses. PlayerController samples it from the input system each frame unless a replay hands it one instead.
+struct PlayerInput
+{
+	unsigned short	m_buttons			= 0;
+	unsigned char	m_equipWeaponMask	= 0;	// bit n: equip weapon n, applied lowest first
+	Vec2			m_lookDegrees;				// yaw and pitch change, turn sensitivity already applied
+	Vec2			m_moveAxes;					// Xbox left stick; keyboard movement uses the buttons
+
+	bool IsButtonDown(unsigned short button) const;
+};
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 class PlayerController: public Controller
 {
@@ -30,6 +61,7 @@ public:
 	void UpdateWorldCamera();
 	void UpdateScreenCamera();
 	void ToggleControlMode();
+	void SetInput(PlayerInput const& input);
 
 	void RenderHUDInfoAndDeathOverlay();
 
@@ -37,6 +69,10 @@ public:
 
 private:
 
+	PlayerInput SampleInput() const;
+	PlayerInput SampleKeyboardInput() const;
+	PlayerInput SampleXboxInput() const;
+
 	void UpdateKeyboardInput();
 	void UpdateXboxInput();
 	void HandleFreeFlyInput();
@@ -54,4 +90,7 @@ public:
 
 	ControlMode m_controlMode = ControlMode::ACTOR_CONTROL;
 
+	PlayerInput m_input;
+	bool		m_isInputInjected = false;	// replays set m_input through SetInput and the devices are never read
+
 };
\ No newline at end of file
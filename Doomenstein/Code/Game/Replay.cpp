@@ -0,0 +1,479 @@
+#include "Game/Replay.hpp"
+#include "Game/Game.hpp"
+#include "Game/Map.hpp"
+#include "Game/SimulationClock.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Clock.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Bumped whenever the file layout changes; older files are rejected rather than misread
+constexpr unsigned int REPLAY_FILE_MAGIC	= 0x314c5052; // "RPL1"
+constexpr unsigned int REPLAY_FILE_VERSION	= 1;
+
+// Which of a PlayerInput's axes follow its buttons in the file; most ticks have neither
+constexpr unsigned char REPLAY_INPUT_HAS_LOOK = 1 << 0;
+constexpr unsigned char REPLAY_INPUT_HAS_MOVE = 1 << 1;
+
+// GameConfig values the simulation reads when a map is created. NamedStrings cannot list its keys, so new
+// simulation settings have to be added here to be recorded. defaultMap is stored as the replay's map name instead.
+static char const* const s_replayConfigKeys[] =
+{
+	"gravity",
+	"aiThinkIntervalFrames",
+	"aiThinkBudgetMicroseconds",
+	"cacheTileVisibility",
+	"playerMoveSpeed",
+	"playerSprintSpeed",
+	"physicsTicksPerSecond",
+	"maxPhysicsTicksPerFrame",
+	"sunPitchTimer",
+	"sunYawTimer",
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<typename T>
+static void WriteReplayValue(std::vector<unsigned char>& buffer, T const& value)
+{
+	unsigned char const* bytes = reinterpret_cast<unsigned char const*>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void WriteReplayString(std::vector<unsigned char>& buffer, std::string const& text)
+{
+	WriteReplayValue(buffer, static_cast<unsigned short>(text.size()));
+	buffer.insert(buffer.end(), text.begin(), text.end());
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Reads past the end of the buffer fail and leave value untouched; callers check once at the end that nothing failed
+struct ReplayReader
+{
+	std::vector<unsigned char> const&	m_buffer;
+	size_t								m_offset	= 0;
+	bool								m_isValid	= true;
+
+	explicit ReplayReader(std::vector<unsigned char> const& buffer) : m_buffer(buffer) {}
+
+	template<typename T>
+	void Read(T& out_value)
+	{
+		if(!m_isValid || m_offset + sizeof(T) > m_buffer.size())
+		{
+			m_isValid = false;
+			return;
+		}
+
+		memcpy(&out_value, m_buffer.data() + m_offset, sizeof(T));
+		m_offset += sizeof(T);
+	}
+
+	void ReadString(std::string& out_text)
+	{
+		unsigned short length = 0;
+		Read(length);
+
+		if(!m_isValid || m_offset + length > m_buffer.size())
+		{
+			m_isValid = false;
+			return;
+		}
+
+		out_text.assign(reinterpret_cast<char const*>(m_buffer.data() + m_offset), length);
+		m_offset += length;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Replay::LoadFromFile(std::string const& filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	ReplayReader reader(buffer);
+
+	unsigned int magic	 = 0;
+	unsigned int version = 0;
+	reader.Read(magic);
+	reader.Read(version);
+
+	if(!reader.m_isValid || magic != REPLAY_FILE_MAGIC || version != REPLAY_FILE_VERSION)
+	{
+		return false;
+	}
+
+	Replay replay;
+	unsigned short numConfigValues	= 0;
+	unsigned char  numPlayers		= 0;
+	unsigned int   numTicks			= 0;
+	unsigned int   numCheckpoints	= 0;
+
+	reader.Read(replay.m_seed);
+	reader.Read(replay.m_startSeconds);
+	reader.Read(replay.m_checkpointIntervalTicks);
+	reader.ReadString(replay.m_mapName);
+
+	reader.Read(numConfigValues);
+
+	for(unsigned short valueIndex = 0; valueIndex < numConfigValues && reader.m_isValid; ++valueIndex)
+	{
+		ReplayConfigValue configValue;
+		reader.ReadString(configValue.m_key);
+		reader.ReadString(configValue.m_value);
+		replay.m_configValues.push_back(configValue);
+	}
+
+	reader.Read(numPlayers);
+
+	for(unsigned char playerIndex = 0; playerIndex < numPlayers && reader.m_isValid; ++playerIndex)
+	{
+		signed char controllerID = -1;
+		reader.Read(controllerID);
+		replay.m_controllerIDs.push_back(controllerID);
+	}
+
+	reader.Read(numTicks);
+
+	for(unsigned int tickIndex = 0; tickIndex < numTicks && reader.m_isValid; ++tickIndex)
+	{
+		ReplayTick tick;
+		unsigned char isPaused = 0;
+		reader.Read(tick.m_gameSeconds);
+		reader.Read(isPaused);
+		tick.m_isPaused = (isPaused != 0);
+		replay.m_ticks.push_back(tick);
+
+		for(unsigned char playerIndex = 0; playerIndex < numPlayers && reader.m_isValid; ++playerIndex)
+		{
+			PlayerInput input;
+			unsigned char axes = 0;
+			reader.Read(input.m_buttons);
+			reader.Read(input.m_equipWeaponMask);
+			reader.Read(axes);
+
+			if(axes & REPLAY_INPUT_HAS_LOOK)
+			{
+				reader.Read(input.m_lookDegrees.x);
+				reader.Read(input.m_lookDegrees.y);
+			}
+
+			if(axes & REPLAY_INPUT_HAS_MOVE)
+			{
+				reader.Read(input.m_moveAxes.x);
+				reader.Read(input.m_moveAxes.y);
+			}
+
+			replay.m_inputs.push_back(input);
+		}
+	}
+
+	reader.Read(numCheckpoints);
+
+	for(unsigned int checkpointIndex = 0; checkpointIndex < numCheckpoints && reader.m_isValid; ++checkpointIndex)
+	{
+		unsigned int stateHash = 0;
+		reader.Read(stateHash);
+		replay.m_checkpointHashes.push_back(stateHash);
+	}
+
+	if(!reader.m_isValid || replay.m_checkpointIntervalTicks <= 0)
+	{
+		return false;
+	}
+
+	*this = replay;
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Little endian and unpadded: buttons and weapon hotkeys always, look and move axes only when they are not zero
+bool Replay::SaveToFile(std::string const& filePath) const
+{
+	std::vector<unsigned char> buffer;
+	buffer.reserve(64 + m_ticks.size() * (sizeof(ReplayTick) + m_controllerIDs.size() * 4));
+
+	WriteReplayValue(buffer, REPLAY_FILE_MAGIC);
+	WriteReplayValue(buffer, REPLAY_FILE_VERSION);
+	WriteReplayValue(buffer, m_seed);
+	WriteReplayValue(buffer, m_startSeconds);
+	WriteReplayValue(buffer, m_checkpointIntervalTicks);
+	WriteReplayString(buffer, m_mapName);
+
+	WriteReplayValue(buffer, static_cast<unsigned short>(m_configValues.size()));
+
+	for(ReplayConfigValue const& configValue : m_configValues)
+	{
+		WriteReplayString(buffer, configValue.m_key);
+		WriteReplayString(buffer, configValue.m_value);
+	}
+
+	WriteReplayValue(buffer, static_cast<unsigned char>(m_controllerIDs.size()));
+
+	for(int controllerID : m_controllerIDs)
+	{
+		WriteReplayValue(buffer, static_cast<signed char>(controllerID));
+	}
+
+	WriteReplayValue(buffer, static_cast<unsigned int>(m_ticks.size()));
+
+	for(int tickIndex = 0; tickIndex < GetNumTicks(); ++tickIndex)
+	{
+		WriteReplayValue(buffer, m_ticks[tickIndex].m_gameSeconds);
+		WriteReplayValue(buffer, static_cast<unsigned char>(m_ticks[tickIndex].m_isPaused ? 1 : 0));
+
+		for(int playerIndex = 0; playerIndex < GetNumPlayers(); ++playerIndex)
+		{
+			PlayerInput const& input = GetInput(tickIndex, playerIndex);
+
+			unsigned char axes = 0;
+
+			if(input.m_lookDegrees.x != 0.f || input.m_lookDegrees.y != 0.f)
+			{
+				axes |= REPLAY_INPUT_HAS_LOOK;
+			}
+
+			if(input.m_moveAxes.x != 0.f || input.m_moveAxes.y != 0.f)
+			{
+				axes |= REPLAY_INPUT_HAS_MOVE;
+			}
+
+			WriteReplayValue(buffer, input.m_buttons);
+			WriteReplayValue(buffer, input.m_equipWeaponMask);
+			WriteReplayValue(buffer, axes);
+
+			if(axes & REPLAY_INPUT_HAS_LOOK)
+			{
+				WriteReplayValue(buffer, input.m_lookDegrees.x);
+				WriteReplayValue(buffer, input.m_lookDegrees.y);
+			}
+
+			if(axes & REPLAY_INPUT_HAS_MOVE)
+			{
+				WriteReplayValue(buffer, input.m_moveAxes.x);
+				WriteReplayValue(buffer, input.m_moveAxes.y);
+			}
+		}
+	}
+
+	WriteReplayValue(buffer, static_cast<unsigned int>(m_checkpointHashes.size()));
+
+	for(unsigned int stateHash : m_checkpointHashes)
+	{
+		WriteReplayValue(buffer, stateHash);
+	}
+
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+	return static_cast<bool>(file);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int Replay::GetNumTicks() const
+{
+	return static_cast<int>(m_ticks.size());
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int Replay::GetNumPlayers() const
+{
+	return static_cast<int>(m_controllerIDs.size());
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+PlayerInput const& Replay::GetInput(int tickIndex, int playerIndex) const
+{
+	return m_inputs[(static_cast<size_t>(tickIndex) * m_controllerIDs.size()) + static_cast<size_t>(playerIndex)];
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+ReplayRecorder::ReplayRecorder(std::string const& filePath)
+	: m_filePath(filePath)
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ReplayRecorder::Start(Game const& game, unsigned int seed)
+{
+	m_replay = Replay();
+	m_replay.m_seed						= seed;
+	m_replay.m_mapName					= g_gameConfigBlackboard.GetValue("defaultMap", "MPMap");
+	m_replay.m_startSeconds				= game.m_gameClock->GetTotalSeconds();
+	m_replay.m_checkpointIntervalTicks	= g_gameConfigBlackboard.GetValue("replayCheckpointTicks", 60);
+	m_replay.m_checkpointIntervalTicks	= (m_replay.m_checkpointIntervalTicks > 0) ? m_replay.m_checkpointIntervalTicks : 60;
+
+	for(char const* key : s_replayConfigKeys)
+	{
+		ReplayConfigValue configValue;
+		configValue.m_key	= key;
+		configValue.m_value = g_gameConfigBlackboard.GetValue(key, "");
+		m_replay.m_configValues.push_back(configValue);
+	}
+
+	for(PlayerController const* playerController : game.m_playerControllers)
+	{
+		m_replay.m_controllerIDs.push_back(playerController->m_controllerID);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void ReplayRecorder::RecordTick(Game const& game)
+{
+	ReplayTick tick;
+	tick.m_gameSeconds = game.m_gameClock->GetTotalSeconds();
+	tick.m_isPaused	   = game.m_gameClock->IsPaused();
+	m_replay.m_ticks.push_back(tick);
+
+	for(PlayerController const* playerController : game.m_playerControllers)
+	{
+		m_replay.m_inputs.push_back(playerController->m_input);
+	}
+
+	if(m_replay.GetNumTicks() % m_replay.m_checkpointIntervalTicks == 0)
+	{
+		m_replay.m_checkpointHashes.push_back(game.m_currentMap->GetStateHash());
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool ReplayRecorder::Stop()
+{
+	return m_replay.SaveToFile(m_filePath);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ReplayRecorder::GetNumTicks() const
+{
+	return m_replay.GetNumTicks();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string const& ReplayRecorder::GetFilePath() const
+{
+	return m_filePath;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool ReplayPlayer::Load(std::string const& filePath)
+{
+	return m_replay.LoadFromFile(filePath);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Puts the recorded config back before the map is created; the config stays that way after playback
+void ReplayPlayer::Start(Game& game)
+{
+	for(ReplayConfigValue const& configValue : m_replay.m_configValues)
+	{
+		g_gameConfigBlackboard.SetValue(configValue.m_key, configValue.m_value);
+	}
+
+	g_gameConfigBlackboard.SetValue("defaultMap", m_replay.m_mapName);
+
+	m_numTicksPlayed			= 0;
+	m_numCheckpointsChecked		= 0;
+	m_numCheckpointMismatches	= 0;
+	m_firstMismatchTick			= -1;
+
+	game.RestartHeadlessReplay(m_replay.m_controllerIDs, m_replay.m_startSeconds, m_replay.m_seed);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Runs one recorded tick. Returns false once every tick has been played or the match was thrown away.
+bool ReplayPlayer::StepTick(Game& game)
+{
+	if(m_numTicksPlayed >= m_replay.GetNumTicks() || !game.m_currentMap || static_cast<int>(game.GetGameState()) < static_cast<int>(GameState::PLAYING))
+	{
+		return false;
+	}
+
+	ReplayTick const& tick = m_replay.m_ticks[m_numTicksPlayed];
+	SimulationClock* clock = game.m_simulationClock;
+
+	// stepped unpaused so single steps taken while the recording was paused still advance the clock
+	if(clock->IsPaused())
+	{
+		clock->Unpause();
+	}
+
+	clock->Step(tick.m_gameSeconds - clock->GetTotalSeconds());
+
+	if(tick.m_isPaused)
+	{
+		clock->Pause();
+	}
+
+	for(int playerIndex = 0; playerIndex < m_replay.GetNumPlayers(); ++playerIndex)
+	{
+		game.m_playerControllers[playerIndex]->SetInput(m_replay.GetInput(m_numTicksPlayed, playerIndex));
+	}
+
+	game.UpdateHeadless();
+
+	m_numTicksPlayed += 1;
+
+	if(m_numTicksPlayed % m_replay.m_checkpointIntervalTicks == 0)
+	{
+		size_t checkpointIndex = static_cast<size_t>(m_numTicksPlayed / m_replay.m_checkpointIntervalTicks) - 1;
+
+		if(checkpointIndex < m_replay.m_checkpointHashes.size() && game.m_currentMap)
+		{
+			m_numCheckpointsChecked += 1;
+
+			if(game.m_currentMap->GetStateHash() != m_replay.m_checkpointHashes[checkpointIndex])
+			{
+				m_numCheckpointMismatches += 1;
+				m_firstMismatchTick = (m_firstMismatchTick < 0) ? m_numTicksPlayed : m_firstMismatchTick;
+			}
+		}
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+Replay const& ReplayPlayer::GetReplay() const
+{
+	return m_replay;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ReplayPlayer::GetNumTicksPlayed() const
+{
+	return m_numTicksPlayed;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ReplayPlayer::GetNumCheckpointsChecked() const
+{
+	return m_numCheckpointsChecked;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ReplayPlayer::GetNumCheckpointMismatches() const
+{
+	return m_numCheckpointMismatches;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int ReplayPlayer::GetFirstMismatchTick() const
+{
+	return m_firstMismatchTick;
+}
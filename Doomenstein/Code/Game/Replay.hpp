@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Game/PlayerController.hpp"
+
+#include <string>
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+class Game;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+struct ReplayConfigValue
+{
+	std::string m_key;
+	std::string m_value;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// One Game::Update the map was updated in. The game clock's total is stored instead of its delta so playback lands on
+// exactly the same totals, and with them the same timer results, as the recorded session.
+struct ReplayTick
+{
+	double	m_gameSeconds	= 0.0;
+	bool	m_isPaused		= false;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Everything needed to play a match again from its first frame: the rand seed the map was built with, the map, the
+// config values the simulation reads, who joined, and each player's input for every tick. m_inputs holds one
+// PlayerInput per player per tick, players in m_controllerIDs order. m_checkpointHashes[n] is Map::GetStateHash after
+// tick (n + 1) * m_checkpointIntervalTicks, so playback can tell where it stopped matching the recording.
+class Replay
+{
+public:
+
+	bool				LoadFromFile(std::string const& filePath);
+	bool				SaveToFile(std::string const& filePath) const;
+
+	int					GetNumTicks() const;
+	int					GetNumPlayers() const;
+	PlayerInput const&	GetInput(int tickIndex, int playerIndex) const;
+
+public:
+
+	unsigned int					m_seed						= 0;
+	std::string						m_mapName;
+	double							m_startSeconds				= 0.0;	// game clock total when the map was created
+	int								m_checkpointIntervalTicks	= 60;
+	std::vector<ReplayConfigValue>	m_configValues;
+	std::vector<int>				m_controllerIDs;
+	std::vector<ReplayTick>			m_ticks;
+	std::vector<PlayerInput>		m_inputs;
+	std::vector<unsigned int>		m_checkpointHashes;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Builds a Replay while a match is played and writes it out when the match ends. Game starts it right after seeding
+// rand and right before creating the map, then records one tick after every map update.
+class ReplayRecorder
+{
+public:
+
+	explicit ReplayRecorder(std::string const& filePath);
+
+	void				Start(Game const& game, unsigned int seed);
+	void				RecordTick(Game const& game);
+	bool				Stop();
+
+	int					GetNumTicks() const;
+	std::string const&	GetFilePath() const;
+
+private:
+
+	std::string			m_filePath;
+	Replay				m_replay;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Plays a Replay back on a headless Game as fast as StepTick is called: same config, seed, players and clock, with the
+// recorded inputs handed to the player controllers. At every checkpoint the map's state hash is compared with the
+// recorded one, so a replay is both a repeatable benchmark and a check that the simulation is still deterministic.
+class ReplayPlayer
+{
+public:
+
+	bool				Load(std::string const& filePath);
+	void				Start(Game& game);
+	bool				StepTick(Game& game);
+
+	Replay const&		GetReplay() const;
+	int					GetNumTicksPlayed() const;
+	int					GetNumCheckpointsChecked() const;
+	int					GetNumCheckpointMismatches() const;
+	int					GetFirstMismatchTick() const;
+
+private:
+
+	Replay				m_replay;
+	int					m_numTicksPlayed			= 0;
+	int					m_numCheckpointsChecked		= 0;
+	int					m_numCheckpointMismatches	= 0;
+	int					m_firstMismatchTick			= -1;
+};
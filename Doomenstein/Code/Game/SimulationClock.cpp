@@ -0,0 +1,13 @@
+#include "Game/SimulationClock.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+SimulationClock::SimulationClock()
+	: Clock(Clock::GetSystemClock())
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void SimulationClock::Step(double deltaSeconds)
+{
+	Advance(deltaSeconds);
+}
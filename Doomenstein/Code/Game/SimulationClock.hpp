@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Engine/Core/Clock.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Game clock for headless runs. The system clock is never ticked there, so this clock only moves when Step is called,
+// by exactly the time it is given. Pause and time scale still apply, as they do for the clock it replaces.
+class SimulationClock : public Clock
+{
+public:
+
+	SimulationClock();
+
+	void Step(double deltaSeconds);
+};
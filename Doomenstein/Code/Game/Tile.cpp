@@ -3,43 +3,62 @@
 #include "Engine/Math/AABB3.hpp"
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-Tile::Tile(AABB3 tileBounds, std::string tileType)
-    : m_tileBounds(tileBounds)
+Tile::Tile(int tileDefIndex)
+    : m_tileDefIndex(static_cast<unsigned short>(tileDefIndex))
 {
-    for(int tileDefIndex = 0; tileDefIndex < static_cast<int>(TileDefinition::s_definitions.size()); ++tileDefIndex)
+    TileDefinition const& tileDef = TileDefinition::s_definitions[tileDefIndex];
+
+    m_flags = static_cast<TileFlags>((tileDef.m_height << TILE_FLAG_HEIGHT_SHIFT) & TILE_FLAG_HEIGHT_MASK);
+
+    if(tileDef.m_isSolid)
+    {
+        m_flags |= TILE_FLAG_SOLID;
+    }
+
+    if(tileDef.m_isGoal)
     {
-        if(TileDefinition::s_definitions[tileDefIndex].m_name == tileType)
-        {
-            m_tileDefIndex = tileDefIndex;
-            break;
-        }
+        m_flags |= TILE_FLAG_GOAL;
     }
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-Tile::~Tile()
-{}
+TileDefinition const& Tile::GetTileDefinition() const
+{
+    return TileDefinition::s_definitions[m_tileDefIndex];
+}
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-TileDefinition Tile::GetTileDefinition() const
+AABB3 Tile::GetTileBounds(IntVec2 const& tileCoord) const
 {
-    return TileDefinition::s_definitions[m_tileDefIndex];
+    float tileHeight = static_cast<float>((m_flags & TILE_FLAG_HEIGHT_MASK) >> TILE_FLAG_HEIGHT_SHIFT);
+
+    AABB3 tileBounds;
+    tileBounds.m_mins = Vec3(static_cast<float>(tileCoord.x), static_cast<float>(tileCoord.y), 0.f);
+    tileBounds.m_maxs = tileBounds.m_mins + Vec3(1.f, 1.f, tileHeight);
+
+    return tileBounds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+TileFlags Tile::GetFlags() const
+{
+    return m_flags;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-AABB3 Tile::GetTileBounds() const
+bool Tile::HasDefinition() const
 {
-    return m_tileBounds;
+    return m_tileDefIndex != INVALID_DEFINITION_INDEX;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool Tile::IsTileSolid() const
 {
-    return TileDefinition::s_definitions[m_tileDefIndex].m_isSolid;
+    return (m_flags & TILE_FLAG_SOLID) != 0;
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool Tile::IsTileGoal() const
 {
-    return TileDefinition::s_definitions[m_tileDefIndex].m_isGoal;
+    return (m_flags & TILE_FLAG_GOAL) != 0;
 }
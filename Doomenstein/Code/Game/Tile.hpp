@@ -1,30 +1,51 @@
 #pragma once
 
 #include "Engine/Math/AABB3.hpp"
-#include <string>
+#include "Engine/Math/IntVec2.hpp"
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 class TileDefinition;
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Packed per-tile flags kept by Map for collision and raycasts: the low bits hold the tile's properties and the high
+// nibble holds its height in whole tiles.
+typedef unsigned char TileFlags;
+
+constexpr TileFlags TILE_FLAG_SOLID			= 1 << 0;
+constexpr TileFlags TILE_FLAG_GOAL			= 1 << 1;
+constexpr int		TILE_FLAG_HEIGHT_SHIFT	= 4;
+constexpr TileFlags TILE_FLAG_HEIGHT_MASK	= 0xf0;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Compact 4-byte map cell: the tile definition index plus the same packed flags Map keeps for collision.
+// Bounds are derived from the tile's coordinates and its definition height instead of being stored.
 class Tile
 {
 
 public:
 
 	Tile() = default;
-	~Tile();
+	~Tile() = default;
 
-	explicit Tile(AABB3 tileBounds, std::string tileType);
+	explicit Tile(int tileDefIndex);
 
-	TileDefinition GetTileDefinition() const;
-	AABB3 GetTileBounds() const;
-	bool IsTileSolid() const;
-	bool IsTileGoal() const;
+	TileDefinition const&	GetTileDefinition() const;
+	AABB3					GetTileBounds(IntVec2 const& tileCoord) const;
+	TileFlags				GetFlags() const;
+	bool					HasDefinition() const;
+	bool					IsTileSolid() const;
+	bool					IsTileGoal() const;
+
+public:
+
+	static constexpr unsigned short INVALID_DEFINITION_INDEX = 0xffff;
 
 private:
 
-	AABB3   m_tileBounds;
-	int		m_tileDefIndex;
+	unsigned short	m_tileDefIndex	= INVALID_DEFINITION_INDEX;
+	TileFlags		m_flags			= 0;
+	unsigned char	m_unused		= 0;
+
+};
 
-};
\ No newline at end of file
+static_assert(sizeof(Tile) == 4, "Tile is expected to stay a 4-byte record");
@@ -45,7 +45,7 @@ void TileDefinition::InitializeTileDefinition()
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-std::string TileDefinition::GetName() const
+std::string const& TileDefinition::GetName() const
 {
 	return m_name;
 }
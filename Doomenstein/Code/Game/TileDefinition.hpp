@@ -24,7 +24,7 @@ public:
 
 	static void InitializeTileDefinition();
 
-	std::string GetName() const;
+	std::string const& GetName() const;
 
 public:
 	static std::vector<TileDefinition> s_definitions;
@@ -0,0 +1,358 @@
+#include "Game/TileVisibility.hpp"
+
+#include <float.h>
+#include <fstream>
+#include <math.h>
+#include <stdlib.h>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Bumped whenever the sampling or the file layout changes so stale caches get rebuilt
+constexpr unsigned int PVS_FILE_MAGIC	= 0x31535650; // "PVS1"
+constexpr unsigned int PVS_FILE_VERSION = 2;
+
+// Sample segments between two tiles, as (offset in tile A, offset in tile B): center to center, the four parallel
+// corner to corner lines along the tiles' edges, and the two crossing diagonals. Corners are pulled slightly inward.
+// A clear sample proves the pair visible; pairs with every sample blocked fall back to the sweep flood fill.
+constexpr float TILE_SAMPLE_INSET = 0.05f;
+constexpr float TILE_SAMPLE_NEAR  = TILE_SAMPLE_INSET;
+constexpr float TILE_SAMPLE_FAR   = 1.f - TILE_SAMPLE_INSET;
+constexpr int	NUM_SAMPLE_SEGMENTS = 7;
+
+static Vec2 const s_sampleSegmentOffsets[NUM_SAMPLE_SEGMENTS][2] =
+{
+	{ Vec2(0.5f, 0.5f),							Vec2(0.5f, 0.5f) },
+	{ Vec2(TILE_SAMPLE_NEAR, TILE_SAMPLE_NEAR), Vec2(TILE_SAMPLE_NEAR, TILE_SAMPLE_NEAR) },
+	{ Vec2(TILE_SAMPLE_FAR, TILE_SAMPLE_NEAR),	Vec2(TILE_SAMPLE_FAR, TILE_SAMPLE_NEAR) },
+	{ Vec2(TILE_SAMPLE_NEAR, TILE_SAMPLE_FAR),	Vec2(TILE_SAMPLE_NEAR, TILE_SAMPLE_FAR) },
+	{ Vec2(TILE_SAMPLE_FAR, TILE_SAMPLE_FAR),	Vec2(TILE_SAMPLE_FAR, TILE_SAMPLE_FAR) },
+	{ Vec2(TILE_SAMPLE_NEAR, TILE_SAMPLE_NEAR), Vec2(TILE_SAMPLE_FAR, TILE_SAMPLE_FAR) },
+	{ Vec2(TILE_SAMPLE_FAR, TILE_SAMPLE_NEAR),	Vec2(TILE_SAMPLE_NEAR, TILE_SAMPLE_FAR) },
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void TileVisibility::Build(std::vector<TileFlags> const& tileFlags, IntVec2 const& dimensions)
+{
+	m_dimensions  = dimensions;
+	m_numTiles	  = dimensions.x * dimensions.y;
+	m_wordsPerRow = (m_numTiles + 63) / 64;
+	m_layoutHash  = ComputeLayoutHash(tileFlags, dimensions);
+
+	m_isSolid.assign(m_numTiles, 0);
+
+	for(int tileIndex = 0; tileIndex < m_numTiles; ++tileIndex)
+	{
+		m_isSolid[tileIndex] = (tileFlags[tileIndex] & TILE_FLAG_SOLID) ? 1 : 0;
+	}
+
+	m_bits.assign(static_cast<size_t>(m_numTiles) * static_cast<size_t>(m_wordsPerRow), 0);
+
+	// scratch for the sweep flood fill, stamped per pair so it never needs clearing
+	std::vector<int> visitStamps(m_numTiles, 0);
+	std::vector<int> openTiles;
+	openTiles.reserve(m_numTiles);
+	int visitStamp = 0;
+
+	// visibility is symmetric, so only the upper triangle is traced; solid tiles never hold an actor and stay empty
+	for(int tileIndexA = 0; tileIndexA < m_numTiles; ++tileIndexA)
+	{
+		if(m_isSolid[tileIndexA])
+		{
+			continue;
+		}
+
+		Vec2 tileMinsA = Vec2(static_cast<float>(tileIndexA % m_dimensions.x), static_cast<float>(tileIndexA / m_dimensions.x));
+
+		SetVisible(tileIndexA, tileIndexA);
+
+		for(int tileIndexB = tileIndexA + 1; tileIndexB < m_numTiles; ++tileIndexB)
+		{
+			if(m_isSolid[tileIndexB])
+			{
+				continue;
+			}
+
+			Vec2 tileMinsB = Vec2(static_cast<float>(tileIndexB % m_dimensions.x), static_cast<float>(tileIndexB / m_dimensions.x));
+			bool isVisible = false;
+
+			for(int segmentIndex = 0; segmentIndex < NUM_SAMPLE_SEGMENTS && !isVisible; ++segmentIndex)
+			{
+				isVisible = IsSegmentClear(tileMinsA + s_sampleSegmentOffsets[segmentIndex][0], tileMinsB + s_sampleSegmentOffsets[segmentIndex][1]);
+			}
+
+			if(!isVisible)
+			{
+				++visitStamp;
+				isVisible = IsTileOpenToTileInSweep(tileIndexA, tileIndexB, visitStamps, visitStamp, openTiles);
+			}
+
+			if(isVisible)
+			{
+				SetVisible(tileIndexA, tileIndexB);
+				SetVisible(tileIndexB, tileIndexA);
+			}
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Returns false when the file is missing, unreadable or was baked from a different tile layout
+bool TileVisibility::LoadFromFile(std::string const& filePath, std::vector<TileFlags> const& tileFlags, IntVec2 const& dimensions)
+{
+	std::ifstream file(filePath, std::ios::binary);
+
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	unsigned int header[5] = {};
+	file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+	unsigned int layoutHash = ComputeLayoutHash(tileFlags, dimensions);
+
+	if(!file || header[0] != PVS_FILE_MAGIC || header[1] != PVS_FILE_VERSION || header[2] != static_cast<unsigned int>(dimensions.x) ||
+	   header[3] != static_cast<unsigned int>(dimensions.y) || header[4] != layoutHash)
+	{
+		return false;
+	}
+
+	int numTiles = dimensions.x * dimensions.y;
+	int wordsPerRow = (numTiles + 63) / 64;
+
+	std::vector<unsigned long long> bits(static_cast<size_t>(numTiles) * static_cast<size_t>(wordsPerRow), 0);
+	file.read(reinterpret_cast<char*>(bits.data()), static_cast<std::streamsize>(bits.size() * sizeof(unsigned long long)));
+
+	if(!file)
+	{
+		return false;
+	}
+
+	m_dimensions  = dimensions;
+	m_numTiles	  = numTiles;
+	m_wordsPerRow = wordsPerRow;
+	m_layoutHash  = layoutHash;
+	m_bits.swap(bits);
+
+	m_isSolid.assign(m_numTiles, 0);
+
+	for(int tileIndex = 0; tileIndex < m_numTiles; ++tileIndex)
+	{
+		m_isSolid[tileIndex] = (tileFlags[tileIndex] & TILE_FLAG_SOLID) ? 1 : 0;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool TileVisibility::SaveToFile(std::string const& filePath) const
+{
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	unsigned int header[5] = { PVS_FILE_MAGIC, PVS_FILE_VERSION, static_cast<unsigned int>(m_dimensions.x), static_cast<unsigned int>(m_dimensions.y), m_layoutHash };
+
+	file.write(reinterpret_cast<char const*>(header), sizeof(header));
+	file.write(reinterpret_cast<char const*>(m_bits.data()), static_cast<std::streamsize>(m_bits.size() * sizeof(unsigned long long)));
+
+	return static_cast<bool>(file);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool TileVisibility::IsBuilt() const
+{
+	return !m_bits.empty();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool TileVisibility::IsTileVisibleFromTile(int fromTileIndex, int toTileIndex) const
+{
+	unsigned long long word = m_bits[(static_cast<size_t>(fromTileIndex) * static_cast<size_t>(m_wordsPerRow)) + (toTileIndex >> 6)];
+
+	return (word >> (toTileIndex & 63)) & 1ull;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Positions off the map are never rejected, the caller's raycast decides those
+bool TileVisibility::IsPositionVisibleFromPosition(Vec2 const& fromPosition, Vec2 const& toPosition) const
+{
+	int fromX = static_cast<int>(floorf(fromPosition.x));
+	int fromY = static_cast<int>(floorf(fromPosition.y));
+	int toX	  = static_cast<int>(floorf(toPosition.x));
+	int toY	  = static_cast<int>(floorf(toPosition.y));
+
+	if(fromX < 0 || fromY < 0 || fromX >= m_dimensions.x || fromY >= m_dimensions.y || toX < 0 || toY < 0 || toX >= m_dimensions.x || toY >= m_dimensions.y)
+	{
+		return true;
+	}
+
+	return IsTileVisibleFromTile((fromY * m_dimensions.x) + fromX, (toY * m_dimensions.x) + toX);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// FNV-1a over the map size and each tile's solid bit
+unsigned int TileVisibility::ComputeLayoutHash(std::vector<TileFlags> const& tileFlags, IntVec2 const& dimensions)
+{
+	unsigned int hash = 2166136261u;
+
+	hash = (hash ^ static_cast<unsigned int>(dimensions.x)) * 16777619u;
+	hash = (hash ^ static_cast<unsigned int>(dimensions.y)) * 16777619u;
+
+	for(TileFlags flags : tileFlags)
+	{
+		hash = (hash ^ static_cast<unsigned int>(flags & TILE_FLAG_SOLID)) * 16777619u;
+	}
+
+	return hash;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Amanatides-Woo walk over the tiles the segment passes through, same stepping as Map::RaycastVsWalls
+bool TileVisibility::IsSegmentClear(Vec2 const& start, Vec2 const& end) const
+{
+	Vec2 delta = end - start;
+
+	int tileX = static_cast<int>(floorf(start.x));
+	int tileY = static_cast<int>(floorf(start.y));
+	int endTileX = static_cast<int>(floorf(end.x));
+	int endTileY = static_cast<int>(floorf(end.y));
+
+	int xStepDirection = (delta.x < 0.f) ? -1 : 1;
+	int yStepDirection = (delta.y < 0.f) ? -1 : 1;
+
+	// t runs 0..1 along the segment
+	float tPerX = (delta.x != 0.f) ? fabsf(1.f / delta.x) : FLT_MAX;
+	float tPerY = (delta.y != 0.f) ? fabsf(1.f / delta.y) : FLT_MAX;
+
+	float tAtNextX = (delta.x != 0.f) ? fabsf((static_cast<float>(tileX + (xStepDirection + 1) / 2) - start.x) / delta.x) : FLT_MAX;
+	float tAtNextY = (delta.y != 0.f) ? fabsf((static_cast<float>(tileY + (yStepDirection + 1) / 2) - start.y) / delta.y) : FLT_MAX;
+
+	// the walk crosses exactly one tile edge per step, which also bounds it against float drift at the far end
+	int numSteps = abs(endTileX - tileX) + abs(endTileY - tileY);
+
+	for(int step = 0; step < numSteps; ++step)
+	{
+		if(tAtNextX < tAtNextY)
+		{
+			tileX += xStepDirection;
+			tAtNextX += tPerX;
+		}
+		else
+		{
+			tileY += yStepDirection;
+			tAtNextY += tPerY;
+		}
+
+		if(IsTileSolid(tileX, tileY))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Conservative test for whether any segment from a point in tile A to a point in tile B can miss every solid tile.
+// All such segments stay inside the sweep of a unit square from A to B, and a clear one passes through a chain of
+// open tiles inside that sweep, each edge or corner adjacent to the next. So the pair is only reported occluded when
+// no such chain exists, which proves every segment between the two tiles hits a wall.
+bool TileVisibility::IsTileOpenToTileInSweep(int tileIndexA, int tileIndexB, std::vector<int>& visitStamps, int visitStamp, std::vector<int>& openTiles) const
+{
+	IntVec2 tileA = IntVec2(tileIndexA % m_dimensions.x, tileIndexA / m_dimensions.x);
+	IntVec2 tileB = IntVec2(tileIndexB % m_dimensions.x, tileIndexB / m_dimensions.x);
+
+	openTiles.clear();
+	openTiles.push_back(tileIndexA);
+	visitStamps[tileIndexA] = visitStamp;
+
+	while(!openTiles.empty())
+	{
+		int tileIndex = openTiles.back();
+		openTiles.pop_back();
+
+		if(tileIndex == tileIndexB)
+		{
+			return true;
+		}
+
+		int tileX = tileIndex % m_dimensions.x;
+		int tileY = tileIndex / m_dimensions.x;
+
+		for(int neighborY = tileY - 1; neighborY <= tileY + 1; ++neighborY)
+		{
+			for(int neighborX = tileX - 1; neighborX <= tileX + 1; ++neighborX)
+			{
+				if(IsTileSolid(neighborX, neighborY))
+				{
+					continue;
+				}
+
+				int neighborIndex = (neighborY * m_dimensions.x) + neighborX;
+
+				if(visitStamps[neighborIndex] == visitStamp || !IsTileInSweep(IntVec2(neighborX, neighborY), tileA, tileB))
+				{
+					continue;
+				}
+
+				visitStamps[neighborIndex] = visitStamp;
+				openTiles.push_back(neighborIndex);
+			}
+		}
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The sweep of the unit square from tile A's mins to tile B's mins overlaps the inside of a tile exactly when the
+// segment between those mins passes through the open 2x2 box centered on the tile's mins
+bool TileVisibility::IsTileInSweep(IntVec2 const& tile, IntVec2 const& tileA, IntVec2 const& tileB)
+{
+	float tEnter = -FLT_MAX;
+	float tExit	 = FLT_MAX;
+
+	int delta[2]	= { tileB.x - tileA.x, tileB.y - tileA.y };
+	int offset[2]	= { tile.x - tileA.x, tile.y - tileA.y };
+
+	for(int axis = 0; axis < 2; ++axis)
+	{
+		if(delta[axis] == 0)
+		{
+			if(offset[axis] != 0)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		float tAtLow  = static_cast<float>(offset[axis] - 1) / static_cast<float>(delta[axis]);
+		float tAtHigh = static_cast<float>(offset[axis] + 1) / static_cast<float>(delta[axis]);
+
+		tEnter = fmaxf(tEnter, fminf(tAtLow, tAtHigh));
+		tExit  = fminf(tExit, fmaxf(tAtLow, tAtHigh));
+	}
+
+	return (tEnter < tExit) && (tEnter < 1.f) && (tExit > 0.f);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool TileVisibility::IsTileSolid(int tileX, int tileY) const
+{
+	if(tileX < 0 || tileY < 0 || tileX >= m_dimensions.x || tileY >= m_dimensions.y)
+	{
+		return true;
+	}
+
+	return m_isSolid[(tileY * m_dimensions.x) + tileX] != 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void TileVisibility::SetVisible(int tileIndexA, int tileIndexB)
+{
+	m_bits[(static_cast<size_t>(tileIndexA) * static_cast<size_t>(m_wordsPerRow)) + (tileIndexB >> 6)] |= (1ull << (tileIndexB & 63));
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include "Game/Tile.hpp"
+
+#include <string>
+#include <vector>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Potentially visible set for a static tile map: one bit per (tile, tile) pair saying whether anything in one tile
+// can see anything in the other past the solid tiles. The bake is conservative: a pair is only marked occluded when
+// every segment between the two tiles provably hits a wall, so callers can reject sight checks on a clear bit and still
+// confirm visible pairs with a real raycast.
+class TileVisibility
+{
+public:
+
+	TileVisibility() = default;
+	~TileVisibility() = default;
+
+	void			Build(std::vector<TileFlags> const& tileFlags, IntVec2 const& dimensions);
+	bool			LoadFromFile(std::string const& filePath, std::vector<TileFlags> const& tileFlags, IntVec2 const& dimensions);
+	bool			SaveToFile(std::string const& filePath) const;
+
+	bool			IsBuilt() const;
+	bool			IsTileVisibleFromTile(int fromTileIndex, int toTileIndex) const;
+	bool			IsPositionVisibleFromPosition(Vec2 const& fromPosition, Vec2 const& toPosition) const;
+
+	static unsigned int ComputeLayoutHash(std::vector<TileFlags> const& tileFlags, IntVec2 const& dimensions);
+
+private:
+
+	bool			IsSegmentClear(Vec2 const& start, Vec2 const& end) const;
+	bool			IsTileOpenToTileInSweep(int tileIndexA, int tileIndexB, std::vector<int>& visitStamps, int visitStamp, std::vector<int>& openTiles) const;
+	static bool		IsTileInSweep(IntVec2 const& tile, IntVec2 const& tileA, IntVec2 const& tileB);
+	bool			IsTileSolid(int tileX, int tileY) const;
+	void			SetVisible(int tileIndexA, int tileIndexB);
+
+private:
+
+	IntVec2						m_dimensions;
+	int							m_numTiles		= 0;
+	int							m_wordsPerRow	= 0;
+	unsigned int				m_layoutHash	= 0;
+	std::vector<unsigned char>	m_isSolid;
+	std::vector<unsigned long long> m_bits;
+};
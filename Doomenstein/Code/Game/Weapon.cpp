@@ -41,14 +41,11 @@ void Weapon::Fire()
 	{
 		m_refireTimer.Start();
 
-		if(m_weaponDefinition->m_name == "Pistol")
+		if(m_weaponDefinition->m_kind == WeaponKind::RAYCAST)
 		{
-			for(int count = 0; count < m_weaponDefinition->m_rayCount; ++count)
-			{
-				m_owner->SetActorState(ActorState::ATTACKING);
-				SetWeaponState(WeaponState::ATTACK);
-				FirePistol();
-			}
+			m_owner->SetActorState(ActorState::ATTACKING);
+			SetWeaponState(WeaponState::ATTACK);
+			FireRays();
 
 			SoundID newAudioID = GetSoundIDForCurrentState();
 
@@ -62,7 +59,7 @@ void Weapon::Fire()
 			}
 		}
 
-		if(m_weaponDefinition->m_name == "PlasmaRifle")
+		if(m_weaponDefinition->m_kind == WeaponKind::PROJECTILE)
 		{
 			for(int count = 0; count < m_weaponDefinition->m_projectileCount; ++count)
 			{
@@ -83,7 +80,7 @@ void Weapon::Fire()
 			}
 		}
 
-		if(m_weaponDefinition->m_name == "DemonMelee" || m_weaponDefinition->m_name == "HeavyDemonMelee")
+		if(m_weaponDefinition->m_kind == WeaponKind::MELEE)
 		{
 			for(int count = 0; count < m_weaponDefinition->m_meleeCount; ++count)
 			{
@@ -109,14 +106,11 @@ void Weapon::Fire()
 
 	if(m_refireTimer.HasPeriodElapsed())
 	{
-		if(m_weaponDefinition->m_name == "Pistol")
+		if(m_weaponDefinition->m_kind == WeaponKind::RAYCAST)
 		{
-			for(int count = 0; count < m_weaponDefinition->m_rayCount; ++count)
-			{
-				m_owner->SetActorState(ActorState::ATTACKING);
-				SetWeaponState(WeaponState::ATTACK);
-				FirePistol();
-			}
+			m_owner->SetActorState(ActorState::ATTACKING);
+			SetWeaponState(WeaponState::ATTACK);
+			FireRays();
 
 			SoundID newAudioID = GetSoundIDForCurrentState();
 
@@ -130,7 +124,7 @@ void Weapon::Fire()
 			}
 		}
 
-		if(m_weaponDefinition->m_name == "PlasmaRifle")
+		if(m_weaponDefinition->m_kind == WeaponKind::PROJECTILE)
 		{
 			for(int count = 0; count < m_weaponDefinition->m_projectileCount; ++count)
 			{
@@ -151,7 +145,7 @@ void Weapon::Fire()
 			}
 		}
 
-		if(m_weaponDefinition->m_name == "DemonMelee" || m_weaponDefinition->m_name == "HeavyDemonMelee")
+		if(m_weaponDefinition->m_kind == WeaponKind::MELEE)
 		{
 			for(int count = 0; count < m_weaponDefinition->m_meleeCount; ++count)
 			{
@@ -180,35 +174,47 @@ void Weapon::Fire()
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void Weapon::FirePistol()
+void Weapon::FireRays()
 {
-
 	Vec3 start = (m_owner->GetEyePosition() - m_owner->GetUpVector() * 0.03f) + m_owner->GetForwardVector() * m_owner->m_definition->m_physicsRadius * 1.01f;
 
-	RaycastResult shotResult = m_owner->m_map->RaycastAll(start, GetRandomDirectionInCone(m_weaponDefinition->m_rayCone), m_weaponDefinition->m_rayRange, m_owner);
+	// rayCount is a float in the definitions; the old one-pellet-per-iteration loop fired ceil(rayCount) pellets
+	int numRays = static_cast<int>(ceilf(m_weaponDefinition->m_rayCount));
+
+	m_rayQueries.resize(numRays);
+
+	for(int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		m_rayQueries[rayIndex].m_startPosition = start;
+		m_rayQueries[rayIndex].m_fwdNormal	   = GetRandomDirectionInCone(m_weaponDefinition->m_rayCone);
+		m_rayQueries[rayIndex].m_distance	   = m_weaponDefinition->m_rayRange;
+	}
+
+	// every pellet is traced against the world as it was when the trigger was pulled, then the hits are queued in order
+	m_owner->m_map->RaycastBatch(m_rayQueries, m_rayResults, m_owner);
+
+	for(RaycastResult& shotResult : m_rayResults)
+	{
+		ApplyRayResult(shotResult);
+	}
+}
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void Weapon::ApplyRayResult(RaycastResult& shotResult)
+{
 	if(shotResult.m_hitActor)
 	{
 		shotResult.m_rayResult.m_rayForwardNormal = Vec3(shotResult.m_rayResult.m_rayForwardNormal.x, shotResult.m_rayResult.m_rayForwardNormal.y, 0.f).GetNormalized();
 
-		shotResult.m_hitActor->AddImpulse(shotResult.m_rayResult.m_rayForwardNormal * m_weaponDefinition->m_rayImpulse);
-		shotResult.m_hitActor->TakeDamage(m_weaponDefinition->m_rayDamage.GetRandomFloat(), m_owner);
-
-		SpawnInfo bloodSpawnInfo;
-		bloodSpawnInfo.m_actorName = "BloodSplatter";
-		bloodSpawnInfo.m_position = shotResult.m_rayResult.m_impactPos;
+		ActorCommandBuffer& commandBuffer = m_owner->m_map->m_commandBuffer;
 
-		Actor* bloodActor = m_owner->m_map->SpawnActor(bloodSpawnInfo);
-		bloodActor->SetActorState(ActorState::DYING);
+		commandBuffer.QueueImpulse(m_owner, shotResult.m_hitActor, shotResult.m_rayResult.m_rayForwardNormal * m_weaponDefinition->m_rayImpulse);
+		commandBuffer.QueueDamage(m_owner, shotResult.m_hitActor, m_weaponDefinition->m_rayDamage.GetRandomFloat(), m_owner);
+		commandBuffer.QueueSpawn(m_owner, m_weaponDefinition->m_rayHitActorID, shotResult.m_rayResult.m_impactPos, EulerAngles(), Vec3::ZERO, ActorState::DYING);
 	}
 	else
 	{
-		SpawnInfo bulletHitSpawnInfo;
-		bulletHitSpawnInfo.m_actorName = "BulletHit";
-		bulletHitSpawnInfo.m_position = shotResult.m_rayResult.m_impactPos;
-
-		Actor* bloodActor = m_owner->m_map->SpawnActor(bulletHitSpawnInfo);
-		bloodActor->SetActorState(ActorState::DYING);
+		m_owner->m_map->m_commandBuffer.QueueSpawn(m_owner, m_weaponDefinition->m_rayMissActorID, shotResult.m_rayResult.m_impactPos, EulerAngles(), Vec3::ZERO, ActorState::DYING);
 	}
 }
 
@@ -218,15 +224,11 @@ void Weapon::FirePlasma()
 
 	float bottomOffSet = 0.09f;
 	float forwardOffSet = m_owner->m_definition->m_physicsRadius * 1.5f;
-	SpawnInfo spawnInfo;
-	spawnInfo.m_actorName = "PlasmaProjectile";
-	spawnInfo.m_orientation = m_owner->m_orientation;
-	spawnInfo.m_position = (m_owner->GetEyePosition() - m_owner->GetUpVector() * bottomOffSet) + m_owner->GetForwardVector() * forwardOffSet;
-	spawnInfo.m_velocity = GetRandomDirectionInCone(m_weaponDefinition->m_projectileCone) * m_weaponDefinition->m_projectileSpeed;
-
-	Actor* projectile = m_owner->m_map->SpawnActor(spawnInfo);
-	projectile->m_owner = m_owner;
-	projectile->SetActorState(ActorState::WALKING);
+
+	Vec3 position = (m_owner->GetEyePosition() - m_owner->GetUpVector() * bottomOffSet) + m_owner->GetForwardVector() * forwardOffSet;
+	Vec3 velocity = GetRandomDirectionInCone(m_weaponDefinition->m_projectileCone) * m_weaponDefinition->m_projectileSpeed;
+
+	m_owner->m_map->m_commandBuffer.QueueSpawn(m_owner, m_weaponDefinition->m_projectileActorID, position, m_owner->m_orientation, velocity, ActorState::WALKING, m_owner);
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -236,7 +238,7 @@ void Weapon::Melee()
 	{
 		for(Actor* actor : m_owner->m_map->m_allActors)
 		{
-			if(actor && actor->m_definition->m_faction != m_owner->m_definition->m_faction && actor->m_definition->m_faction != Faction::NEUTRAL && actor->m_definition->m_name != "PlasmaProjectile")
+			if(actor && actor->m_definition->m_faction != m_owner->m_definition->m_faction && actor->m_definition->m_faction != Faction::NEUTRAL && !actor->m_definition->IsProjectile())
 			{
 				Cylinder3D actorCylinder = Cylinder3D(actor->m_position, actor->m_definition->m_physicsHeight, actor->m_definition->m_physicsRadius);
 
@@ -254,8 +256,8 @@ void Weapon::Melee()
 					float impulseMag = m_weaponDefinition->m_meleeImpulse;
 					Vec3 impulse = m_owner->GetForwardVector().GetXY().GetNormalized() * impulseMag;
 
-					actor->TakeDamage(meleeDamage, m_owner);
-					actor->AddImpulse(impulse);
+					m_owner->m_map->m_commandBuffer.QueueDamage(m_owner, actor, meleeDamage, m_owner);
+					m_owner->m_map->m_commandBuffer.QueueImpulse(m_owner, actor, impulse);
 				}
 			}	
 		}
@@ -265,7 +267,7 @@ void Weapon::Melee()
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Weapon::Render(Camera const& camera)
 {
-	if(m_weaponDefinition->m_name == "DemonMelee" || m_weaponDefinition->m_name == "HeavyDemonMelee")
+	if(m_weaponDefinition->m_kind == WeaponKind::MELEE)
 	{
 		return;
 	}
@@ -383,7 +385,7 @@ Vec3 Weapon::GetRandomDirectionInCone(float offset)
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Weapon::SetAnimationTimerByState()
 {
-	if(m_weaponDefinition->m_name == "DemonMelee" || m_weaponDefinition->m_name == "HeavyDemonMelee")
+	if(m_weaponDefinition->m_kind == WeaponKind::MELEE || m_weaponDefinition->m_weaponAnimationsBasedOnNames.empty())
 	{
 		return;
 	}
@@ -399,7 +401,7 @@ void Weapon::SetAnimationTimerByState()
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void Weapon::SetWeaponState(WeaponState newState)
 {
-	if(m_weaponDefinition->m_name == "DemonMelee" || m_weaponDefinition->m_name == "HeavyDemonMelee")
+	if(m_weaponDefinition->m_kind == WeaponKind::MELEE)
 	{
 		return;
 	}
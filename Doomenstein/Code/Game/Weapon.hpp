@@ -7,6 +7,8 @@ class WeaponDefinition;
 class SpriteAnimDefinition;
 
 struct Vec3;
+struct RayQuery;
+struct RaycastResult;
 typedef size_t SoundID;
 typedef size_t SoundPlaybackID;
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -27,7 +29,8 @@ public:
 
 	void Fire();
 
-	void FirePistol();
+	void FireRays();
+	void ApplyRayResult(RaycastResult& shotResult);
 	void FirePlasma();
 	void Melee();
 
@@ -54,4 +57,7 @@ public:
 
 	SoundPlaybackID	  m_currentAudioID = static_cast<SoundPlaybackID>(-1);
 
+	std::vector<RayQuery>	   m_rayQueries;
+	std::vector<RaycastResult> m_rayResults;
+
 };
\ No newline at end of file
@@ -23,6 +23,8 @@ WeaponDefinition::WeaponDefinition(XmlElement const& weaponDefElement)
 	m_rayRange   = ParseXmlAttribute(weaponDefElement, "rayRange",   m_rayRange);
 	m_rayImpulse = ParseXmlAttribute(weaponDefElement, "rayImpulse", m_rayImpulse);
 	m_rayDamage  = ParseXmlAttribute(weaponDefElement, "rayDamage",  m_rayDamage);
+	m_rayHitActorName  = ParseXmlAttribute(weaponDefElement, "rayHitActor",  m_rayHitActorName);
+	m_rayMissActorName = ParseXmlAttribute(weaponDefElement, "rayMissActor", m_rayMissActorName);
 	
 	m_projectileCount     = ParseXmlAttribute(weaponDefElement, "projectileCount", m_projectileCount);
 	m_projectileCone      =	ParseXmlAttribute(weaponDefElement, "projectileCone",  m_projectileCone);
@@ -35,6 +37,19 @@ WeaponDefinition::WeaponDefinition(XmlElement const& weaponDefElement)
 	m_meleeImpulse = ParseXmlAttribute(weaponDefElement, "meleeImpulse", m_meleeImpulse);
 	m_meleeDamage  = ParseXmlAttribute(weaponDefElement, "meleeDamage",  m_meleeDamage);
 
+	if(m_rayCount > 0.f)
+	{
+		m_kind = WeaponKind::RAYCAST;
+	}
+	else if(m_projectileCount > 0)
+	{
+		m_kind = WeaponKind::PROJECTILE;
+	}
+	else if(m_meleeCount > 0)
+	{
+		m_kind = WeaponKind::MELEE;
+	}
+
 	XmlElement const* childElement = weaponDefElement.FirstChildElement();
 	
 	while(childElement)
@@ -76,6 +91,7 @@ void WeaponDefinition::InitializeWeaponDefinition()
 		GUARANTEE_OR_DIE(elementName == "WeaponDefinition", "Child Element should be WeaponDefinition");
 
 		WeaponDefinition newWeaponDefintition = WeaponDefinition(*weaponDefElement);
+		newWeaponDefintition.m_id = static_cast<int>(s_weaponDefinitions.size());
 		s_weaponDefinitions.push_back(newWeaponDefintition);
 
 		weaponDefElement = weaponDefElement->NextSiblingElement();
@@ -83,9 +99,33 @@ void WeaponDefinition::InitializeWeaponDefinition()
 
 
 }
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Weapons load before the non-projectile actors, so the actors they spawn are looked up once everything is loaded
+void WeaponDefinition::ResolveActorDefinitionIDs()
+{
+	for(WeaponDefinition& weaponDef : s_weaponDefinitions)
+	{
+		weaponDef.m_rayHitActorID	  = ActorDefinition::GetActorDefinitionIDByName(weaponDef.m_rayHitActorName);
+		weaponDef.m_rayMissActorID	  = ActorDefinition::GetActorDefinitionIDByName(weaponDef.m_rayMissActorName);
+		weaponDef.m_projectileActorID = ActorDefinition::GetActorDefinitionIDByName(weaponDef.m_projectileActorName);
+
+		if(weaponDef.m_kind == WeaponKind::PROJECTILE)
+		{
+			GUARANTEE_OR_DIE(weaponDef.m_projectileActorID != INVALID_ACTOR_DEFINITION_ID, Stringf("Weapon %s has an unknown projectileActor: %s", weaponDef.m_name.c_str(), weaponDef.m_projectileActorName.c_str()));
+		}
+	}
+}
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void WeaponDefinition::InitializeHUD(XmlElement const& hudElement)
 {
+	// the HUD is only ever drawn, so headless runs skip its textures and animations
+	if(!g_theRenderer)
+	{
+		return;
+	}
+
 	std::string hudTextureName;
 	hudTextureName = ParseXmlAttribute(hudElement, "baseTexture", hudTextureName);
 	m_hudTexture = g_theRenderer->CreateOrGetTextureFromFile(hudTextureName.c_str());
@@ -153,7 +193,7 @@ void WeaponDefinition::InitializeSounds(XmlElement const& audioDefElement)
 		soundName = ParseXmlAttribute(*soundElement, "sound", soundName);
 		soundFilePath = ParseXmlAttribute(*soundElement, "name", soundName);
 
-		SoundID soundID = g_theAudioSystem->CreateOrGetSound(soundFilePath, FMOD_3D);
+		SoundID soundID = g_theAudioSystem ? g_theAudioSystem->CreateOrGetSound(soundFilePath, FMOD_3D) : MISSING_SOUND_ID;
 
 		SoundGroup soundGroup;
 		soundGroup.m_name = soundName;
@@ -16,6 +16,19 @@ class SpriteAnimDefinition;
 
 struct SoundGroup;
 typedef size_t SoundID;
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// How a weapon attacks, resolved at load from which of the ray, projectile or melee counts its definition sets
+enum class WeaponKind
+{
+	NONE,
+
+	RAYCAST,
+	PROJECTILE,
+	MELEE,
+
+	COUNT
+};
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------------
 class WeaponDefinition
 {
@@ -25,6 +38,7 @@ public:
 	explicit WeaponDefinition(XmlElement const& weaponDefElement);
 
 	static void InitializeWeaponDefinition();
+	static void ResolveActorDefinitionIDs();
 	void InitializeHUD(XmlElement const& hudElement);
 	void InitializeSounds(XmlElement const& soundElement);
 
@@ -38,6 +52,8 @@ public:
 	static std::vector<WeaponDefinition> s_weaponDefinitions;
 
 	std::string m_name;
+	int			m_id   = -1;
+	WeaponKind	m_kind = WeaponKind::NONE;
 	
 	float	   m_refireTime = 0.f;
 	float	   m_rayCount	= 0.f;
@@ -45,11 +61,16 @@ public:
 	float	   m_rayImpulse = 0.f;
 	float	   m_rayRange	= 0.f;
 	FloatRange m_rayDamage	= FloatRange::ZERO;
+	std::string m_rayHitActorName  = "BloodSplatter";
+	std::string m_rayMissActorName = "BulletHit";
+	int			m_rayHitActorID	   = -1;
+	int			m_rayMissActorID   = -1;
 
 	int			m_projectileCount = 0;
 	float		m_projectileCone  = 0.f;
 	float		m_projectileSpeed = 0.f;
 	std::string m_projectileActorName;
+	int			m_projectileActorID = -1;
 
 	int		   m_meleeCount	  = 0;
 	float	   m_meleeRange	  = 0.f;